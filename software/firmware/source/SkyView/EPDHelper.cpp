@@ -50,6 +50,13 @@ static unsigned long EPD_anti_ghosting_timer = 0;
 
 volatile int EPD_task_command = EPD_UPDATE_NONE;
 
+epd_stats_t EPD_stats = { 0, 0, 0, 0, 0 };
+
+static epd_window_t EPD_windows[EPD_MAX_WINDOWS];
+static int  EPD_windows_count   = 0;
+static bool EPD_windows_valid   = false;
+static int  EPD_partial_updates = 0;
+
 byte EPD_setup(bool splash_screen)
 {
   byte rval = DISPLAY_NONE;
@@ -176,9 +183,12 @@ void EPD_loop()
         display->fillScreen(GxEPD_WHITE);
         SoC->EPD_update(EPD_UPDATE_SLOW);
 
+        EPD_radar_invalidate();
         EPD_display_frontpage = true;
       }
     } else {
+      unsigned long prev_marker = EPDTimeMarker;
+
       switch (EPD_view_mode)
       {
       case VIEW_MODE_RADAR:
@@ -190,6 +200,14 @@ void EPD_loop()
       default:
         break;
       }
+
+      /* frames that were not drawn while the panel has been busy */
+      if (EPDTimeMarker != prev_marker) {
+        unsigned long periods = (EPDTimeMarker - prev_marker) / EPD_REFRESH_INTERVAL;
+        if (periods > 1) {
+          EPD_stats.dropped += periods - 1;
+        }
+      }
     }
   }
 }
@@ -313,24 +331,194 @@ void EPD_Message(const char *msg1, const char *msg2)
   }
 }
 
+/*
+ * A view that keeps a retained scene calls EPD_Damage_Begin() prior to
+ * drawing and then reports every screen area that differs from previous frame.
+ * Any other view leaves the damage list invalid and gets a full frame update.
+ */
+void EPD_Damage_Begin()
+{
+  EPD_windows_count = 0;
+  EPD_windows_valid = true;
+}
+
+static bool EPD_Window_Touches(epd_window_t *a, epd_window_t *b)
+{
+  return (a->x <= b->x + b->w + EPD_WINDOW_MERGE_GAP &&
+          b->x <= a->x + a->w + EPD_WINDOW_MERGE_GAP &&
+          a->y <= b->y + b->h + EPD_WINDOW_MERGE_GAP &&
+          b->y <= a->y + a->h + EPD_WINDOW_MERGE_GAP);
+}
+
+static void EPD_Window_Merge(epd_window_t *dst, epd_window_t *src)
+{
+  int16_t x2 = maxof2(dst->x + dst->w, src->x + src->w);
+  int16_t y2 = maxof2(dst->y + dst->h, src->y + src->h);
+
+  dst->x = dst->x < src->x ? dst->x : src->x;
+  dst->y = dst->y < src->y ? dst->y : src->y;
+  dst->w = x2 - dst->x;
+  dst->h = y2 - dst->y;
+}
+
+static int32_t EPD_Window_Merge_Cost(epd_window_t *a, epd_window_t *b)
+{
+  epd_window_t u = *a;
+
+  EPD_Window_Merge(&u, b);
+
+  return (int32_t) u.w * u.h - (int32_t) a->w * a->h - (int32_t) b->w * b->h;
+}
+
+void EPD_Damage(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  epd_window_t win;
+
+  if (!EPD_windows_valid) {
+    return;
+  }
+
+  /* clip to the screen */
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > display->width())  { w = display->width()  - x; }
+  if (y + h > display->height()) { h = display->height() - y; }
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  win.x = x; win.y = y; win.w = w; win.h = h;
+
+  /* absorb every window which touches the new one */
+  for (int i = 0; i < EPD_windows_count; ) {
+    if (EPD_Window_Touches(&EPD_windows[i], &win)) {
+      EPD_Window_Merge(&win, &EPD_windows[i]);
+      EPD_windows[i] = EPD_windows[--EPD_windows_count];
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+
+  if (EPD_windows_count < EPD_MAX_WINDOWS) {
+    EPD_windows[EPD_windows_count++] = win;
+  } else {
+    /* no free slot - grow the window that costs the least extra area */
+    int best = 0;
+    int32_t best_cost = EPD_Window_Merge_Cost(&EPD_windows[0], &win);
+
+    for (int i = 1; i < EPD_windows_count; i++) {
+      int32_t cost = EPD_Window_Merge_Cost(&EPD_windows[i], &win);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = i;
+      }
+    }
+    EPD_Window_Merge(&EPD_windows[best], &win);
+  }
+}
+
+static bool EPD_Glyph_Equal(const epd_glyph_t *a, const epd_glyph_t *b)
+{
+  return (a->type == b->type && a->key == b->key &&
+          a->x    == b->x    && a->y   == b->y   &&
+          a->w    == b->w    && a->h   == b->h);
+}
+
+static bool EPD_Glyph_Found(const epd_glyph_t *glyph,
+                            const epd_glyph_t *scene, int count)
+{
+  for (int i = 0; i < count; i++) {
+    if (EPD_Glyph_Equal(glyph, &scene[i])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/* damage every glyph which has appeared, moved, changed or gone */
+void EPD_Damage_Scene(const epd_glyph_t *prev, int prev_count,
+                      const epd_glyph_t *curr, int curr_count)
+{
+  for (int i = 0; i < prev_count; i++) {
+    if (!EPD_Glyph_Found(&prev[i], curr, curr_count)) {
+      EPD_Damage(prev[i].x, prev[i].y, prev[i].w, prev[i].h);
+    }
+  }
+
+  for (int i = 0; i < curr_count; i++) {
+    if (!EPD_Glyph_Found(&curr[i], prev, prev_count)) {
+      EPD_Damage(curr[i].x, curr[i].y, curr[i].w, curr[i].h);
+    }
+  }
+}
+
+static void EPD_Update_Fast()
+{
+  /* a full refresh every now and then clears ghosting of partial updates */
+  bool full_refresh = !EPD_windows_valid ||
+                      EPD_partial_updates >= EPD_FULL_REFRESH_CYCLES;
+  bool full_frame   = full_refresh;
+
+  if (!full_frame) {
+    int32_t area = 0;
+
+    for (int i = 0; i < EPD_windows_count; i++) {
+      area += (int32_t) EPD_windows[i].w * EPD_windows[i].h;
+    }
+
+    full_frame = (area * 100 >  (int32_t) display->width() *
+                  display->height() * EPD_WINDOW_MAX_AREA);
+  }
+
+  if (full_frame) {
+    /* windows cover too much area - one partial update of the whole frame */
+    display->display(!full_refresh);
+    yield();
+    display->powerOff();
+    EPD_partial_updates = full_refresh ? 0 : EPD_partial_updates + 1;
+    EPD_stats.frames++;
+  } else if (EPD_windows_count > 0) {
+    for (int i = 0; i < EPD_windows_count; i++) {
+      display->displayWindow(EPD_windows[i].x, EPD_windows[i].y,
+                             EPD_windows[i].w, EPD_windows[i].h);
+      yield();
+    }
+    display->powerOff();
+    EPD_partial_updates++;
+    EPD_stats.windows += EPD_windows_count;
+    EPD_stats.frames++;
+  }
+
+  EPD_windows_valid = false;
+}
+
 void EPD_Update_Sync(int cmd)
 {
+  unsigned long start_ms = millis();
+
   switch (cmd)
   {
   case EPD_UPDATE_SLOW:
     display->display(false);
-    EPD_task_command = EPD_UPDATE_NONE;
+    EPD_windows_valid = false;
+    EPD_stats.frames++;
     break;
   case EPD_UPDATE_FAST:
-    display->display(true);
-    yield();
-    display->powerOff();
-    EPD_task_command = EPD_UPDATE_NONE;
+    EPD_Update_Fast();
     break;
   case EPD_UPDATE_NONE:
   default:
-    break;
+    return;
   }
+
+  EPD_stats.refresh_ms = millis() - start_ms;
+  if (EPD_stats.refresh_ms > EPD_stats.refresh_max_ms) {
+    EPD_stats.refresh_max_ms = EPD_stats.refresh_ms;
+  }
+
+  EPD_task_command = EPD_UPDATE_NONE;
 }
 
 void EPD_Task( void * pvParameters )
@@ -340,6 +528,14 @@ void EPD_Task( void * pvParameters )
     if (hw_info.display == DISPLAY_EPD_2_7) {
       EPD_Update_Sync(EPD_task_command);
     }
+
+#if defined(ESP32)
+    /* sleep until SoC->EPD_update() hands a new frame over */
+    if (EPD_task_command == EPD_UPDATE_NONE) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+#else
     yield();
+#endif /* ESP32 */
   }
 }
@@ -33,7 +33,8 @@
 #define NAVBOX3_TITLE           "SCALE"
 #define NAVBOX4_TITLE           "BAT"
 
-#define isTimeToDisplay()       (millis() - EPDTimeMarker > 2000)
+#define EPD_REFRESH_INTERVAL    2000    /* ms */
+#define isTimeToDisplay()       (millis() - EPDTimeMarker > EPD_REFRESH_INTERVAL)
 #define maxof2(a,b)             (a > b ? a : b)
 
 #define EPD_RADAR_V_THRESHOLD   50      /* metres */
@@ -41,6 +42,11 @@
 #define TEXT_VIEW_LINE_LENGTH   13      /* characters */
 #define TEXT_VIEW_LINE_SPACING  15      /* pixels */
 
+#define EPD_MAX_WINDOWS         4
+#define EPD_WINDOW_MERGE_GAP    8       /* pixels */
+#define EPD_WINDOW_MAX_AREA     50      /* % of screen, full frame update above */
+#define EPD_FULL_REFRESH_CYCLES 30      /* window updates between full frames */
+
 typedef struct navbox_struct
 {
   char      title[8];
@@ -52,6 +58,40 @@ typedef struct navbox_struct
   uint32_t  timestamp;
 } navbox_t;
 
+typedef struct epd_window_struct
+{
+  int16_t   x;
+  int16_t   y;
+  int16_t   w;
+  int16_t   h;
+} epd_window_t;
+
+enum
+{
+	EPD_GLYPH_TARGET,
+	EPD_GLYPH_LABEL
+};
+
+typedef struct epd_stats_struct
+{
+  uint32_t  frames;         /* pushed onto the panel */
+  uint32_t  windows;        /* partial window updates */
+  uint32_t  dropped;        /* coalesced while the panel was busy */
+  uint32_t  refresh_ms;     /* duration of most recent update */
+  uint32_t  refresh_max_ms;
+} epd_stats_t;
+
+/* an element of retained scene, identified by its type, key and placement */
+typedef struct epd_glyph_struct
+{
+  uint8_t   type;
+  int32_t   key;
+  int16_t   x;
+  int16_t   y;
+  int16_t   w;
+  int16_t   h;
+} epd_glyph_t;
+
 enum
 {
 	EPD_UPDATE_NONE,
@@ -70,11 +110,16 @@ void EPD_Message(const char *, const char *);
 void EPD_Update_Sync(int);
 void EPD_Task(void *);
 
+void EPD_Damage_Begin();
+void EPD_Damage(int16_t, int16_t, int16_t, int16_t);
+void EPD_Damage_Scene(const epd_glyph_t *, int, const epd_glyph_t *, int);
+
 void EPD_radar_setup();
 void EPD_radar_loop();
 void EPD_radar_zoom();
 void EPD_radar_unzoom();
 void EPD_radar_Draw_Message(const char *, const char *);
+void EPD_radar_invalidate();
 void EPD_text_setup();
 void EPD_text_loop();
 void EPD_text_next();
@@ -85,6 +130,7 @@ extern GxEPD2_BW<GxEPD2_270, GxEPD2_270::HEIGHT> *display;
 extern unsigned long EPDTimeMarker;
 extern bool EPD_display_frontpage;
 extern volatile int EPD_task_command;
+extern epd_stats_t EPD_stats;
 
 static uint8_t sleep_icon_128x128[] PROGMEM = {
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
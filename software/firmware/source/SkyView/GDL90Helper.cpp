@@ -32,14 +32,17 @@ extern "C" {
 #include <gdl90.h>
 }
 
-#define GDL90_RINGBUF_SIZE  sizeof(gdl_message_escaped_t)
-
 static unsigned long GDL90_Data_TimeMarker = 0;
 static unsigned long GDL90_HeartBeat_TimeMarker = 0;
 static unsigned long GDL90_OwnShip_TimeMarker = 0;
-static unsigned char gdl90_ringbuf[GDL90_RINGBUF_SIZE];
-static unsigned int gdl90buf_head = 0;
-static unsigned char prev_c = 0;
+
+/*
+ * Frames are unescaped straight into 'message' as the input arrives.
+ * gdl90_len counts bytes stored so far including the opening flag,
+ * zero means that we are out of sync and wait for the next flag.
+ */
+static size_t gdl90_len = 0;
+static bool gdl90_escape = false;
 
 gdl_message_t message;
 
@@ -67,143 +70,163 @@ const uint8_t gdl90_to_aircraft_type[] PROGMEM = {
 	AIRCRAFT_TYPE_RESERVED
 };
 
-static void GDL90_Parse_Character(char c)
+static void GDL90_Traffic()
 {
-    unsigned int gdl90buf_tail;
-    size_t msg_size;
-
-    if (c == GDL90_CONTROL_ESCAPE) {
-      prev_c = c;
-      return;
-    } else if (prev_c == GDL90_CONTROL_ESCAPE) {
-      prev_c = c;
-      c ^= GDL90_ESCAPE_BYTE;
-    } else {
-      prev_c = c;
-    }
+  if (decode_gdl90_traffic_report(&message, &gdl_traffic)) {
 
-    gdl90_ringbuf[gdl90buf_head % GDL90_RINGBUF_SIZE] = c;
-    gdl90buf_head++;
+//  print_gdl90_traffic_report(&gdl_traffic);
 
-    msg_size = 1 /* flag */ + 1 /* id */ + GDL90_MSG_LEN_HEARTBEAT + 2 /* FC */ + 1 /* flag */;
-    gdl90buf_tail = gdl90buf_head - msg_size;
-    if (c == GDL90_FLAG_BYTE && 
-        gdl90_ringbuf[ gdl90buf_tail    % GDL90_RINGBUF_SIZE] == GDL90_FLAG_BYTE &&
-        gdl90_ringbuf[(gdl90buf_tail+1) % GDL90_RINGBUF_SIZE] == MSG_ID_HEARTBEAT) {
+    fo = EmptyFO;
 
-      unsigned char *buf = (unsigned char *) &message;
-      for (uint8_t i=0; i < msg_size; i++) {
-          buf[i] = gdl90_ringbuf[(gdl90buf_tail + i) % GDL90_RINGBUF_SIZE];
-      }
+    fo.ID          = gdl_traffic.address;
+    fo.IDType      = gdl_traffic.addressType == ADS_B_WITH_ICAO_ADDRESS ?
+                                      ADDR_TYPE_ICAO : ADDR_TYPE_ANONYMOUS;
 
-      if (decode_gdl90_heartbeat(&message, &heartbeat)) {
+    fo.latitude    = gdl_traffic.latitude;
+    fo.longitude   = gdl_traffic.longitude;
+    fo.altitude    = gdl_traffic.altitude  / _GPS_FEET_PER_METER;
 
-//      print_gdl90_heartbeat(&heartbeat);
+    fo.AlarmLevel  = gdl_traffic.trafficAlertStatus == TRAFFIC_ALERT ?
+                                        ALARM_LEVEL_LOW : ALARM_LEVEL_NONE;
+    fo.Track       = gdl_traffic.trackOrHeading;           // degrees
+    fo.ClimbRate   = gdl_traffic.verticalVelocity/ (_GPS_FEET_PER_METER * 60.0);
+    fo.TurnRate    = 0;
+    fo.GroundSpeed = gdl_traffic.horizontalVelocity * _GPS_MPS_PER_KNOT;
+    fo.AcftType    = GDL90_TO_AT(gdl_traffic.emitterCategory);
 
-        GDL90_HeartBeat_TimeMarker = millis();
-      }
-    }
+    memcpy(fo.callsign, gdl_traffic.callsign, sizeof(fo.callsign));
 
-    msg_size = 1 /* flag */ + 1 /* id */ + GDL90_MSG_LEN_OWNSHIP_GEOMETRIC + 2 /* FC */ + 1 /* flag */;
-    gdl90buf_tail = gdl90buf_head - msg_size;
-    if (c == GDL90_FLAG_BYTE && 
-        gdl90_ringbuf[ gdl90buf_tail    % GDL90_RINGBUF_SIZE] == GDL90_FLAG_BYTE &&
-        gdl90_ringbuf[(gdl90buf_tail+1) % GDL90_RINGBUF_SIZE] == MSG_ID_OWNSHIP_GEOMETRIC) {
+    fo.timestamp   = now();
 
-      unsigned char *buf = (unsigned char *) &message;
-      for (uint8_t i=0; i < msg_size; i++) {
-          buf[i] = gdl90_ringbuf[(gdl90buf_tail + i) % GDL90_RINGBUF_SIZE];
-      }
+    Traffic_Update(&fo);
+    Traffic_Add();
+  }
+}
 
-      decode_gdl90_ownship_geo_altitude(&message, &geo_altitude);
-//    print_gdl90_ownship_geo_altitude(&geo_altitude);
-    }
+static void GDL90_OwnShip()
+{
+  if (decode_gdl90_traffic_report(&message, &ownship)) {
 
-    msg_size = 1 /* flag */ + 1 /* id */ + GDL90_MSG_LEN_TRAFFIC_REPORT + 2 /* FC */ + 1 /* flag */;
-    gdl90buf_tail = gdl90buf_head - msg_size;
-    if (c == GDL90_FLAG_BYTE && 
-        gdl90_ringbuf[ gdl90buf_tail    % GDL90_RINGBUF_SIZE] == GDL90_FLAG_BYTE &&
-        gdl90_ringbuf[(gdl90buf_tail+1) % GDL90_RINGBUF_SIZE] == MSG_ID_TRAFFIC_REPORT) {
+//  print_gdl90_traffic_report(&ownship);
 
-      unsigned char *buf = (unsigned char *) &message;
-      for (uint8_t i=0; i < msg_size; i++) {
-          buf[i] = gdl90_ringbuf[(gdl90buf_tail + i) % GDL90_RINGBUF_SIZE];
-      }
+    ThisAircraft.ID          = ownship.address;
+    ThisAircraft.IDType      = ownship.addressType == ADS_B_WITH_ICAO_ADDRESS ?
+                                      ADDR_TYPE_ICAO : ADDR_TYPE_ANONYMOUS;
 
-      if (decode_gdl90_traffic_report(&message, &gdl_traffic)) {
+    ThisAircraft.latitude    = ownship.latitude;
+    ThisAircraft.longitude   = ownship.longitude;
 
-//      print_gdl90_traffic_report(&gdl_traffic);
+    if (ownship.altitude != 101375 /* 0xFFF */ ) {
+      ThisAircraft.altitude  = ownship.altitude / _GPS_FEET_PER_METER;
+    } else if (geo_altitude.ownshipGeoAltitude != 0) {
+      ThisAircraft.altitude  = geo_altitude.ownshipGeoAltitude / _GPS_FEET_PER_METER;
+    }
 
-        fo = EmptyFO;
+    ThisAircraft.AlarmLevel  = ownship.trafficAlertStatus == TRAFFIC_ALERT ?
+                                        ALARM_LEVEL_LOW : ALARM_LEVEL_NONE;
+    ThisAircraft.Track       = ownship.trackOrHeading;           // degrees
+    ThisAircraft.ClimbRate   = ownship.verticalVelocity/ (_GPS_FEET_PER_METER * 60.0);
+    ThisAircraft.TurnRate    = 0;
+    ThisAircraft.GroundSpeed = ownship.horizontalVelocity * _GPS_MPS_PER_KNOT;
+    ThisAircraft.AcftType    = GDL90_TO_AT(ownship.emitterCategory);
 
-        fo.ID          = gdl_traffic.address;
-        fo.IDType      = gdl_traffic.addressType == ADS_B_WITH_ICAO_ADDRESS ?
-                                          ADDR_TYPE_ICAO : ADDR_TYPE_ANONYMOUS;
+    memcpy(ThisAircraft.callsign, ownship.callsign, sizeof(ThisAircraft.callsign));
 
-        fo.latitude    = gdl_traffic.latitude;
-        fo.longitude   = gdl_traffic.longitude;
-        fo.altitude    = gdl_traffic.altitude  / _GPS_FEET_PER_METER;
+    ThisAircraft.timestamp   = now();
 
-        fo.AlarmLevel  = gdl_traffic.trafficAlertStatus == TRAFFIC_ALERT ?
-                                            ALARM_LEVEL_LOW : ALARM_LEVEL_NONE;
-        fo.Track       = gdl_traffic.trackOrHeading;           // degrees
-        fo.ClimbRate   = gdl_traffic.verticalVelocity/ (_GPS_FEET_PER_METER * 60.0);
-        fo.TurnRate    = 0;
-        fo.GroundSpeed = gdl_traffic.horizontalVelocity * _GPS_MPS_PER_KNOT;
-        fo.AcftType    = GDL90_TO_AT(gdl_traffic.emitterCategory);
+    GDL90_OwnShip_TimeMarker = millis();
+  }
+}
 
-        memcpy(fo.callsign, gdl_traffic.callsign, sizeof(fo.callsign));
+/* 'size' counts message ID, payload and FCS of the frame held in 'message' */
+static void GDL90_Dispatch(size_t size)
+{
+  size_t payload = size - 1 /* id */ - 2 /* FCS */;
 
-        fo.timestamp   = now();
+  switch (message.messageId)
+  {
+  case MSG_ID_HEARTBEAT:
+    if (payload == GDL90_MSG_LEN_HEARTBEAT &&
+        decode_gdl90_heartbeat(&message, &heartbeat)) {
 
-        Traffic_Update(&fo);
-        Traffic_Add();
-      }
-    }
+//    print_gdl90_heartbeat(&heartbeat);
 
-    msg_size = 1 /* flag */ + 1 /* id */ + GDL90_MSG_LEN_OWNSHIP_REPORT + 2 /* FC */ + 1 /* flag */;
-    gdl90buf_tail = gdl90buf_head - msg_size;
-    if (c == GDL90_FLAG_BYTE && 
-        gdl90_ringbuf[ gdl90buf_tail    % GDL90_RINGBUF_SIZE] == GDL90_FLAG_BYTE &&
-        gdl90_ringbuf[(gdl90buf_tail+1) % GDL90_RINGBUF_SIZE] == MSG_ID_OWNSHIP_REPORT) {
+      GDL90_HeartBeat_TimeMarker = millis();
+    }
+    break;
+  case MSG_ID_OWNSHIP_GEOMETRIC:
+    if (payload == GDL90_MSG_LEN_OWNSHIP_GEOMETRIC) {
+      decode_gdl90_ownship_geo_altitude(&message, &geo_altitude);
+//    print_gdl90_ownship_geo_altitude(&geo_altitude);
+    }
+    break;
+  case MSG_ID_TRAFFIC_REPORT:
+    if (payload == GDL90_MSG_LEN_TRAFFIC_REPORT) {
+      GDL90_Traffic();
+    }
+    break;
+  case MSG_ID_OWNSHIP_REPORT:
+    if (payload == GDL90_MSG_LEN_OWNSHIP_REPORT) {
+      GDL90_OwnShip();
+    }
+    break;
+  default:
+    break;
+  }
+}
 
-      unsigned char *buf = (unsigned char *) &message;
-      for (uint8_t i=0; i < msg_size; i++) {
-          buf[i] = gdl90_ringbuf[(gdl90buf_tail + i) % GDL90_RINGBUF_SIZE];
+void GDL90_Parse_Buffer(const uint8_t *buf, size_t size)
+{
+  uint8_t *msg = (uint8_t *) &message;
+  const uint8_t *end = buf + size;
+
+  while (buf < end) {
+    const uint8_t *flag = (const uint8_t *) memchr(buf, GDL90_FLAG_BYTE, end - buf);
+    const uint8_t *stop = flag ? flag : end;
+
+    /* copy runs of plain bytes in one go, unescape the rest */
+    while (buf < stop && gdl90_len > 0) {
+      if (gdl90_escape) {
+        gdl90_escape = false;
+        if (gdl90_len >= sizeof(message)) {
+          gdl90_len = 0;
+          break;
+        }
+        msg[gdl90_len++] = *buf++ ^ GDL90_ESCAPE_BYTE;
+        continue;
       }
 
-      if (decode_gdl90_traffic_report(&message, &ownship)) {
-
-//      print_gdl90_traffic_report(&ownship);
-
-        ThisAircraft.ID          = ownship.address;
-        ThisAircraft.IDType      = ownship.addressType == ADS_B_WITH_ICAO_ADDRESS ?
-                                          ADDR_TYPE_ICAO : ADDR_TYPE_ANONYMOUS;
-
-        ThisAircraft.latitude    = ownship.latitude;
-        ThisAircraft.longitude   = ownship.longitude;
-
-        if (ownship.altitude != 101375 /* 0xFFF */ ) {
-          ThisAircraft.altitude  = ownship.altitude / _GPS_FEET_PER_METER;
-        } else if (geo_altitude.ownshipGeoAltitude != 0) {
-          ThisAircraft.altitude  = geo_altitude.ownshipGeoAltitude / _GPS_FEET_PER_METER;
-        }
+      const uint8_t *esc = (const uint8_t *) memchr(buf, GDL90_CONTROL_ESCAPE, stop - buf);
+      size_t run = (esc ? esc : stop) - buf;
 
-        ThisAircraft.AlarmLevel  = ownship.trafficAlertStatus == TRAFFIC_ALERT ?
-                                            ALARM_LEVEL_LOW : ALARM_LEVEL_NONE;
-        ThisAircraft.Track       = ownship.trackOrHeading;           // degrees
-        ThisAircraft.ClimbRate   = ownship.verticalVelocity/ (_GPS_FEET_PER_METER * 60.0);
-        ThisAircraft.TurnRate    = 0;
-        ThisAircraft.GroundSpeed = ownship.horizontalVelocity * _GPS_MPS_PER_KNOT;
-        ThisAircraft.AcftType    = GDL90_TO_AT(ownship.emitterCategory);
+      if (gdl90_len + run > sizeof(message)) {
+        gdl90_len = 0;
+        break;
+      }
+      memcpy(msg + gdl90_len, buf, run);
+      gdl90_len += run;
+      buf += run;
 
-        memcpy(ThisAircraft.callsign, ownship.callsign, sizeof(ThisAircraft.callsign));
+      if (esc) {
+        gdl90_escape = true;
+        buf++;
+      }
+    }
 
-        ThisAircraft.timestamp   = now();
+    if (flag == NULL) {
+      break;
+    }
 
-        GDL90_OwnShip_TimeMarker = millis();
-      }
+    if (gdl90_len > 1 /* flag */ + 1 /* id */ + 2 /* FCS */) {
+      GDL90_Dispatch(gdl90_len - 1);
     }
+
+    /* closing flag of a frame opens the next one */
+    message.flag0 = GDL90_FLAG_BYTE;
+    gdl90_len     = 1;
+    gdl90_escape  = false;
+    buf           = flag + 1;
+  }
 }
 
 void GDL90_setup()
@@ -264,14 +287,17 @@ void GDL90_setup()
 void GDL90_loop()
 {
   size_t size;
+  uint8_t buf[GDL90_CHUNK_SIZE];
 
   switch (settings->connection)
   {
   case CON_SERIAL:
     while (SerialInput.available() > 0) {
-      char c = SerialInput.read();
-//      Serial.print(c);
-      GDL90_Parse_Character(c);
+      size = 0;
+      while (size < sizeof(buf) && SerialInput.available() > 0) {
+        buf[size++] = SerialInput.read();
+      }
+      GDL90_Parse_Buffer(buf, size);
       GDL90_Data_TimeMarker = millis();
     }
     /* read data from microUSB port */
@@ -280,9 +306,11 @@ void GDL90_loop()
 #endif
     {
       while (Serial.available() > 0) {
-        char c = Serial.read();
-//        Serial.print(c);
-        GDL90_Parse_Character(c);
+        size = 0;
+        while (size < sizeof(buf) && Serial.available() > 0) {
+          buf[size++] = Serial.read();
+        }
+        GDL90_Parse_Buffer(buf, size);
         GDL90_Data_TimeMarker = millis();
       }
     }
@@ -290,10 +318,7 @@ void GDL90_loop()
   case CON_WIFI_UDP:
     size = SoC->WiFi_Receive_UDP((uint8_t *) UDPpacketBuffer, sizeof(UDPpacketBuffer));
     if (size > 0) {
-      for (size_t i=0; i < size; i++) {
-//        Serial.print(UDPpacketBuffer[i]);
-        GDL90_Parse_Character(UDPpacketBuffer[i]);
-      }
+      GDL90_Parse_Buffer((uint8_t *) UDPpacketBuffer, size);
       GDL90_Data_TimeMarker = millis();
     }
     break;
@@ -301,9 +326,11 @@ void GDL90_loop()
   case CON_BLUETOOTH_LE:
     if (SoC->Bluetooth) {
       while (SoC->Bluetooth->available() > 0) {
-        char c = SoC->Bluetooth->read();
-//        Serial.print(c);
-        GDL90_Parse_Character(c);
+        size = 0;
+        while (size < sizeof(buf) && SoC->Bluetooth->available() > 0) {
+          buf[size++] = SoC->Bluetooth->read();
+        }
+        GDL90_Parse_Buffer(buf, size);
         GDL90_Data_TimeMarker = millis();
       }
     }
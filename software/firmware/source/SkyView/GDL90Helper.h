@@ -23,8 +23,11 @@
 
 #define GDL90_EXP_TIME  4500 /* 4.5 seconds */
 
+#define GDL90_CHUNK_SIZE  128 /* bytes pulled from a stream input at once */
+
 void GDL90_setup(void);
 void GDL90_loop(void);
+void GDL90_Parse_Buffer(const uint8_t *, size_t);
 bool GDL90_isConnected(void);
 bool GDL90_hasHeartBeat(void);
 bool GDL90_hasOwnShip(void);
@@ -29,36 +29,159 @@
 
 TinyGPSPlus nmea;
 
-TinyGPSCustom T_AlarmLevel      (nmea, "PFLAA", 1);
-TinyGPSCustom T_RelativeNorth   (nmea, "PFLAA", 2);
-TinyGPSCustom T_RelativeEast    (nmea, "PFLAA", 3);
-TinyGPSCustom T_RelativeVertical(nmea, "PFLAA", 4);
-TinyGPSCustom T_IDType          (nmea, "PFLAA", 5);
-TinyGPSCustom T_ID              (nmea, "PFLAA", 6);
-TinyGPSCustom T_Track           (nmea, "PFLAA", 7);
-TinyGPSCustom T_TurnRate        (nmea, "PFLAA", 8);
-TinyGPSCustom T_GroundSpeed     (nmea, "PFLAA", 9);
-TinyGPSCustom T_ClimbRate       (nmea, "PFLAA", 10);
-TinyGPSCustom T_AcftType        (nmea, "PFLAA", 11);
-
-TinyGPSCustom S_RX              (nmea, "PFLAU", 1);
-TinyGPSCustom S_TX              (nmea, "PFLAU", 2);
-TinyGPSCustom S_GPS             (nmea, "PFLAU", 3);
-TinyGPSCustom S_Power           (nmea, "PFLAU", 4);
-TinyGPSCustom S_AlarmLevel      (nmea, "PFLAU", 5);
-TinyGPSCustom S_RelativeBearing (nmea, "PFLAU", 6);
-TinyGPSCustom S_AlarmType       (nmea, "PFLAU", 7);
-TinyGPSCustom S_RelativeVertical(nmea, "PFLAU", 8);
-TinyGPSCustom S_RelativeDistance(nmea, "PFLAU", 9);
-TinyGPSCustom S_ID              (nmea, "PFLAU", 10);
-
 status_t NMEA_Status;
 
 static unsigned long NMEA_TimeMarker = 0;
+static unsigned long NMEA_Status_TimeMarker = 0;
+
+/*
+ * Input is assembled into complete sentences first. The checksum is
+ * verified on the whole sentence, PFLAA and PFLAU are then decoded in
+ * a single pass over their fields. Everything else goes to TinyGPS++
+ * which keeps track of the ownship GNSS data.
+ */
+static char   NMEA_line[NMEA_BUFFER_SIZE];
+static size_t NMEA_line_len = 0;
+static bool   NMEA_line_overflow = false;
+
+static inline int NMEA_Hex_Digit(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
 
-static void NMEA_Parse_Character(char c)
+/* returns end of the payload ('*') or NULL when the checksum is wrong */
+static const char *NMEA_Verify(const char *str, size_t len)
 {
-    bool isValidSentence = nmea.encode(c);
+  uint8_t sum = 0;
+  const char *p = str + 1;
+  const char *end = str + len;
+
+  while (p < end && *p != '*') {
+    sum ^= (uint8_t) *p++;
+  }
+
+  if (end - p < 3) {
+    return NULL;
+  }
+
+  int hi = NMEA_Hex_Digit(p[1]);
+  int lo = NMEA_Hex_Digit(p[2]);
+
+  return (hi >= 0 && lo >= 0 && ((hi << 4) | lo) == sum) ? p : NULL;
+}
+
+/* decimal field, fraction is dropped; moves past the trailing comma */
+static const char *NMEA_Field_Dec(const char *p, int32_t *val)
+{
+  bool neg = false;
+  int32_t v = 0;
+
+  if (*p == '-') {
+    neg = true;
+    p++;
+  }
+  while (*p >= '0' && *p <= '9') {
+    v = v * 10 + (*p++ - '0');
+  }
+  while (*p != ',' && *p != '*') {
+    p++;
+  }
+  if (*p == ',') {
+    p++;
+  }
+
+  *val = neg ? -v : v;
+  return p;
+}
+
+static const char *NMEA_Field_Hex(const char *p, uint32_t *val)
+{
+  uint32_t v = 0;
+  int d;
+
+  while ((d = NMEA_Hex_Digit(*p)) >= 0) {
+    v = (v << 4) | d;
+    p++;
+  }
+  while (*p != ',' && *p != '*') {
+    p++;
+  }
+  if (*p == ',') {
+    p++;
+  }
+
+  *val = v;
+  return p;
+}
+
+/* $PFLAA,AlarmLevel,RelativeNorth,RelativeEast,RelativeVertical,IDType,ID,Track,TurnRate,GroundSpeed,ClimbRate,AcftType */
+static void NMEA_Parse_PFLAA(const char *p)
+{
+  int32_t  val;
+  uint32_t id;
+
+  fo = EmptyFO;
+
+  p = NMEA_Field_Dec(p, &val); fo.AlarmLevel       = val;
+  p = NMEA_Field_Dec(p, &val); fo.RelativeNorth    = val;
+  p = NMEA_Field_Dec(p, &val); fo.RelativeEast     = val;
+  p = NMEA_Field_Dec(p, &val); fo.RelativeVertical = val;
+  p = NMEA_Field_Dec(p, &val); fo.IDType           = val;
+  p = NMEA_Field_Hex(p, &id);  fo.ID               = id;
+  p = NMEA_Field_Dec(p, &val); fo.Track            = val;
+  p = NMEA_Field_Dec(p, &val); fo.TurnRate         = val;
+  p = NMEA_Field_Dec(p, &val); fo.GroundSpeed      = val;
+  p = NMEA_Field_Dec(p, &val); /* ClimbRate: TBD */
+  p = NMEA_Field_Dec(p, &val); fo.AcftType         = val;
+
+  fo.timestamp = now();
+
+  Traffic_Add();
+}
+
+/* $PFLAU,RX,TX,GPS,Power,AlarmLevel,RelativeBearing,AlarmType,RelativeVertical,RelativeDistance,ID */
+static void NMEA_Parse_PFLAU(const char *p)
+{
+  int32_t  val;
+  uint32_t id;
+
+  NMEA_Status.timestamp = now();
+
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.RX               = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.TX               = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.GPS              = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.Power            = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.AlarmLevel       = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.RelativeBearing  = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.AlarmType        = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.RelativeVertical = val;
+  p = NMEA_Field_Dec(p, &val); NMEA_Status.RelativeDistance = val;
+  p = NMEA_Field_Hex(p, &id);  NMEA_Status.ID               = id;
+
+  NMEA_Status_TimeMarker = millis();
+}
+
+static void NMEA_Parse_Sentence(const char *str, size_t len)
+{
+  if (len < 7 || str[0] != '$' || NMEA_Verify(str, len) == NULL) {
+    return;
+  }
+
+  if (!strncmp(str, "$PFLAA,", 7)) {
+    NMEA_Parse_PFLAA(str + 7);
+  } else if (!strncmp(str, "$PFLAU,", 7)) {
+    NMEA_Parse_PFLAU(str + 7);
+  } else if (str[1] == 'G') {
+    bool isValidSentence = false;
+
+    for (size_t i=0; i < len; i++) {
+      isValidSentence = nmea.encode(str[i]);
+    }
+    isValidSentence = nmea.encode('\n') || isValidSentence;
+
     if (isValidSentence) {
       if (nmea.location.isUpdated()) {
         ThisAircraft.latitude  = nmea.location.lat();
@@ -73,152 +196,50 @@ static void NMEA_Parse_Character(char c)
       if (nmea.speed.isUpdated()) {
         ThisAircraft.GroundSpeed = nmea.speed.knots();
       }
-      if (T_ID.isUpdated()) {
-        fo = EmptyFO;
-
-//        Serial.print(F(" ID=")); Serial.print(ID.value());
-
-        fo.ID = strtol(T_ID.value(), NULL, 16);
+    }
+  }
+}
 
-#if 0
-        Serial.print(F(" ID="));
-        Serial.print((fo.ID >> 16) & 0xFF, HEX);
-        Serial.print((fo.ID >>  8) & 0xFF, HEX);
-        Serial.print((fo.ID      ) & 0xFF, HEX);
-        Serial.println();
-#endif
+void NMEA_Parse_Buffer(const char *buf, size_t size)
+{
+  const char *end = buf + size;
 
-        if (T_AlarmLevel.isUpdated())
-        {
-//          Serial.print(F(" AlarmLevel=")); Serial.print(T_AlarmLevel.value());
-          fo.AlarmLevel = atoi(T_AlarmLevel.value());
-//          Serial.print(F(" AlarmLevel=")); Serial.println(fo.AlarmLevel);
-        }
-        if (T_RelativeNorth.isUpdated())
-        {
-//          Serial.print(F(" RelativeNorth=")); Serial.print(T_RelativeNorth.value());
-          fo.RelativeNorth = atoi(T_RelativeNorth.value());
-//          Serial.print(F(" RelativeNorth=")); Serial.println(fo.RelativeNorth);
-        }
-        if (T_RelativeEast.isUpdated())
-        {
-//          Serial.print(F(" RelativeEast=")); Serial.print(T_RelativeEast.value());
-          fo.RelativeEast = atoi(T_RelativeEast.value());
-//          Serial.print(F(" RelativeEast=")); Serial.println(fo.RelativeEast);
-        }
-        if (T_RelativeVertical.isUpdated())
-        {
-//          Serial.print(F(" RelativeVertical=")); Serial.print(T_RelativeVertical.value());
-          fo.RelativeVertical = atoi(T_RelativeVertical.value());
-//          Serial.print(F(" RelativeVertical=")); Serial.println(fo.RelativeVertical);
-        }
-        if (T_IDType.isUpdated())
-        {
-//          Serial.print(F(" IDType=")); Serial.print(T_IDType.value());
-          fo.IDType = atoi(T_IDType.value());
-//          Serial.print(F(" IDType=")); Serial.println(fo.IDType);
-        }
-        if (T_Track.isUpdated())
-        {
-//          Serial.print(F(" Track=")); Serial.print(T_Track.value());
-          fo.Track = atoi(T_Track.value());
-//          Serial.print(F(" Track=")); Serial.println(fo.Track);
-        }
-        if (T_TurnRate.isUpdated())
-        {
-//          Serial.print(F(" TurnRate=")); Serial.print(T_TurnRate.value());
-          fo.TurnRate = atoi(T_TurnRate.value());
-//          Serial.print(F(" TurnRate=")); Serial.println(fo.TurnRate);
-        }
-        if (T_GroundSpeed.isUpdated())
-        {
-//          Serial.print(F(" GroundSpeed=")); Serial.print(T_GroundSpeed.value());
-          fo.GroundSpeed = atoi(T_GroundSpeed.value());
-//          Serial.print(F(" GroundSpeed=")); Serial.println(fo.GroundSpeed);
-        }
-        if (T_ClimbRate.isUpdated())
-        {
-//          Serial.print(F(" ClimbRate=")); Serial.println(T_ClimbRate.value());
-          /* TBD */
-        }
-        if (T_AcftType.isUpdated())
-        {
-//          Serial.print(F(" AcftType=")); Serial.print(T_AcftType.value());
-          fo.AcftType = atoi(T_AcftType.value());
-//          Serial.print(F(" AcftType=")); Serial.println(fo.AcftType);
-        }
+  while (buf < end) {
+    const char *eol = (const char *) memchr(buf, '\n', end - buf);
+    size_t chunk = (eol ? eol : end) - buf;
 
-        fo.timestamp = now();
+    if (!NMEA_line_overflow) {
+      if (NMEA_line_len + chunk < sizeof(NMEA_line)) {
+        memcpy(NMEA_line + NMEA_line_len, buf, chunk);
+        NMEA_line_len += chunk;
+      } else {
+        NMEA_line_overflow = true;
+      }
+    }
 
-        Traffic_Add();
+    if (eol == NULL) {
+      break;
+    }
 
-      } else if (S_RX.isUpdated()) {
+    if (!NMEA_line_overflow) {
+      size_t len = NMEA_line_len;
 
-        NMEA_Status.timestamp = now();
-        NMEA_Status.RX = atoi(S_RX.value());
+      if (len > 0 && NMEA_line[len - 1] == '\r') {
+        len--;
+      }
+      NMEA_line[len] = 0;
 
-        if (S_TX.isUpdated())
-        {
-//          Serial.print(F(" TX=")); Serial.print(S_TX.value());
-          NMEA_Status.TX = atoi(S_TX.value());
-//          Serial.print(F(" TX=")); Serial.println(NMEA_Status.TX);
-        }
-        if (S_GPS.isUpdated())
-        {
-//          Serial.print(F(" GPS=")); Serial.print(S_GPS.value());
-          NMEA_Status.GPS = atoi(S_GPS.value());
-//          Serial.print(F(" GPS=")); Serial.println(NMEA_Status.GPS);
-        }
-        if (S_Power.isUpdated())
-        {
-//          Serial.print(F(" Power=")); Serial.print(S_Power.value());
-          NMEA_Status.Power = atoi(S_Power.value());
-//          Serial.print(F(" Power=")); Serial.println(NMEA_Status.Power);
-        }
-        if (S_AlarmLevel.isUpdated())
-        {
-//          Serial.print(F(" AlarmLevel=")); Serial.print(S_AlarmLevel.value());
-          NMEA_Status.AlarmLevel = atoi(S_AlarmLevel.value());
-//          Serial.print(F(" AlarmLevel=")); Serial.println(NMEA_Status.AlarmLevel);
-        }
-        if (S_RelativeBearing.isUpdated())
-        {
-//          Serial.print(F(" RelativeBearing=")); Serial.print(S_RelativeBearing.value());
-          NMEA_Status.RelativeBearing = atoi(S_RelativeBearing.value());
-//          Serial.print(F(" RelativeBearing=")); Serial.println(NMEA_Status.RelativeBearing);
-        }
-        if (S_AlarmType.isUpdated())
-        {
-//          Serial.print(F(" AlarmType=")); Serial.print(S_AlarmType.value());
-          NMEA_Status.AlarmType = atoi(S_AlarmType.value());
-//          Serial.print(F(" AlarmType=")); Serial.println(NMEA_Status.AlarmType);
-        }
-        if (S_RelativeVertical.isUpdated())
-        {
-//          Serial.print(F(" RelativeVertical=")); Serial.print(S_RelativeVertical.value());
-          NMEA_Status.RelativeVertical = atoi(S_RelativeVertical.value());
-//          Serial.print(F(" RelativeVertical=")); Serial.println(NMEA_Status.RelativeVertical);
-        }
-        if (S_RelativeDistance.isUpdated())
-        {
-//          Serial.print(F(" RelativeDistance=")); Serial.print(S_RelativeDistance.value());
-          NMEA_Status.RelativeDistance = strtol(S_RelativeDistance.value(), NULL, 10);
-//          Serial.print(F(" RelativeDistance=")); Serial.println(NMEA_Status.RelativeDistance);
-        }
-        if (S_ID.isUpdated())
-        {
-//          Serial.print(F(" ID=")); Serial.print(S_ID.value());
-          NMEA_Status.ID = strtol(S_ID.value(), NULL, 16);
-#if 0
-          Serial.print(F(" ID="));
-          Serial.print((NMEA_Status.ID >> 16) & 0xFF, HEX);
-          Serial.print((NMEA_Status.ID >>  8) & 0xFF, HEX);
-          Serial.print((NMEA_Status.ID      ) & 0xFF, HEX);
-          Serial.println();
-#endif
-        }
+      /* a sentence may follow some garbage within the same line */
+      const char *start = (const char *) memchr(NMEA_line, '$', len);
+      if (start) {
+        NMEA_Parse_Sentence(start, len - (start - NMEA_line));
       }
     }
+
+    NMEA_line_len = 0;
+    NMEA_line_overflow = false;
+    buf = eol + 1;
+  }
 }
 
 void NMEA_setup()
@@ -276,14 +297,18 @@ void NMEA_setup()
 void NMEA_loop()
 {
   size_t size;
+  char buf[NMEA_CHUNK_SIZE];
 
   switch (settings->connection)
   {
   case CON_SERIAL:
     while (SerialInput.available() > 0) {
-      char c = SerialInput.read();
-      Serial.print(c);
-      NMEA_Parse_Character(c);
+      size = 0;
+      while (size < sizeof(buf) && SerialInput.available() > 0) {
+        buf[size++] = SerialInput.read();
+      }
+      Serial.write((uint8_t *) buf, size);
+      NMEA_Parse_Buffer(buf, size);
       NMEA_TimeMarker = millis();
     }
     /* read data from microUSB port */
@@ -292,9 +317,11 @@ void NMEA_loop()
 #endif
     {
       while (Serial.available() > 0) {
-        char c = Serial.read();
-//        Serial.print(c);
-        NMEA_Parse_Character(c);
+        size = 0;
+        while (size < sizeof(buf) && Serial.available() > 0) {
+          buf[size++] = Serial.read();
+        }
+        NMEA_Parse_Buffer(buf, size);
         NMEA_TimeMarker = millis();
       }
     }
@@ -302,10 +329,8 @@ void NMEA_loop()
   case CON_WIFI_UDP:
     size = SoC->WiFi_Receive_UDP((uint8_t *) UDPpacketBuffer, sizeof(UDPpacketBuffer));
     if (size > 0) {
-      for (size_t i=0; i < size; i++) {
-        Serial.print(UDPpacketBuffer[i]);
-        NMEA_Parse_Character(UDPpacketBuffer[i]);
-      }
+      Serial.write((uint8_t *) UDPpacketBuffer, size);
+      NMEA_Parse_Buffer(UDPpacketBuffer, size);
       NMEA_TimeMarker = millis();
     }
     break;
@@ -313,9 +338,12 @@ void NMEA_loop()
   case CON_BLUETOOTH_LE:
     if (SoC->Bluetooth) {
       while (SoC->Bluetooth->available() > 0) {
-        char c = SoC->Bluetooth->read();
-        Serial.print(c);
-        NMEA_Parse_Character(c);
+        size = 0;
+        while (size < sizeof(buf) && SoC->Bluetooth->available() > 0) {
+          buf[size++] = SoC->Bluetooth->read();
+        }
+        Serial.write((uint8_t *) buf, size);
+        NMEA_Parse_Buffer(buf, size);
         NMEA_TimeMarker = millis();
       }
     }
@@ -339,5 +367,6 @@ bool NMEA_hasGNSS()
 
 bool NMEA_hasFLARM()
 {
-  return (S_RX.isValid() && S_RX.age() < NMEA_EXP_TIME);
+  return (NMEA_Status_TimeMarker != 0 &&
+         (millis() - NMEA_Status_TimeMarker) < NMEA_EXP_TIME);
 }
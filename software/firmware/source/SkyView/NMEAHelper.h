@@ -107,6 +107,9 @@ typedef struct nmea_status_struct {
 #define NMEA_UDP_PORT     10110
 #define NMEA_TCP_PORT     2000
 
+#define NMEA_BUFFER_SIZE  128 /* longest PFLAA sentence with an OGN/FLARM tag */
+#define NMEA_CHUNK_SIZE   128 /* bytes pulled from a stream input at once */
+
 /*
  * Both GGA and RMC NMEA sentences are required.
  * No fix when any of them is missing or lost.
@@ -122,6 +125,7 @@ typedef struct nmea_status_struct {
 
 void NMEA_setup(void);
 void NMEA_loop(void);
+void NMEA_Parse_Buffer(const char *, size_t);
 
 bool NMEA_isConnected(void);
 bool NMEA_hasGNSS(void);
@@ -139,7 +139,7 @@ void OLED_loop()
 
       if (isTimeToDisplay()) {
 
-        int j=0;
+        int j;
         uint16_t x = 0;
         uint16_t y = 9;
         char id_str  [9];
@@ -147,17 +147,7 @@ void OLED_loop()
         char brg_str [4];
         char elev_str[6];
 
-        for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-          if (Container[i].ID && (now() - Container[i].timestamp) <= OLED_EXPIRATION_TIME) {
-
-            traffic[j].fop = &Container[i];
-            traffic[j].distance = sqrtf(Container[i].RelativeNorth * Container[i].RelativeNorth +
-                                        Container[i].RelativeEast  * Container[i].RelativeEast);
-            j++;
-          }
-        }
-
-        qsort(traffic, j, sizeof(traffic_by_dist_t), traffic_cmp_by_distance);
+        j = Traffic_Ranked(traffic, OLED_LINES_PER_PAGE, OLED_EXPIRATION_TIME);
 
         odisplay.fillRect(x, y, odisplay.width(), odisplay.height() - y, BLACK);
 
@@ -392,6 +392,10 @@ static void ESP32_EPD_update(int val)
 {
 //  EPD_Update_Sync(val);
   EPD_task_command = val;
+
+  if (EPD_Task_Handle != NULL) {
+    xTaskNotifyGive(EPD_Task_Handle);
+  }
 }
 
 static size_t ESP32_WiFi_Receive_UDP(uint8_t *buf, size_t max_size)
@@ -48,9 +48,15 @@
 
 #include "SkyView.h"
 
+extern "C" {
+#include <gdl90.h>
+}
+
 #include <alsa/asoundlib.h>
 #include <sndfile.h>
 #include <string.h>
+#include <pthread.h>
+#include <dirent.h>
 
 #include <iostream>
 
@@ -410,93 +416,351 @@ static void RPi_DB_fini()
   }
 }
 
-static void play_file(snd_pcm_t *pcm_handle, char *filename, short int* buf, snd_pcm_uframes_t frames)
+/*
+ * Voice callouts are played by a thread of its own, out of clips that
+ * are decoded into memory once, at start up. The PCM device stays open.
+ * A request is queued and returns at once. A more urgent request, or one
+ * of the same urgency, interrupts the callout being played and supersedes
+ * those that wait in the queue. Requests that have waited for more than
+ * VOICE_EXPIRATION_TIME are dropped as stale.
+ */
+typedef struct tts_clip_struct {
+  char      word[TTS_MAX_WORD_LEN];
+  short int *samples;
+  sf_count_t frames;
+} tts_clip_t;
+
+typedef struct tts_msg_struct {
+  uint8_t       priority;
+  uint8_t       count;          /* 0 - empty */
+  uint8_t       clips[TTS_MAX_WORDS];
+  unsigned long timestamp;      /* millis() */
+} tts_msg_t;
+
+tts_stats_t TTS_stats;
+
+static tts_clip_t tts_clips[TTS_MAX_CLIPS];
+static unsigned int tts_clips_count = 0;
+
+static tts_msg_t tts_queue[TTS_QUEUE_SIZE];
+static uint8_t tts_playing = 0;       /* priority, 0 - idle */
+static volatile bool tts_preempt = false;
+
+static snd_pcm_t *pcm_handle = NULL;
+static snd_pcm_uframes_t pcm_frames;
+
+static pthread_t       tts_thread;
+static pthread_mutex_t tts_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  tts_cond  = PTHREAD_COND_INITIALIZER;
+
+static bool TTS_Load_Clip(const char *dir, const char *name)
+{
+  char filename[MAX_FILENAME_LEN];
+  size_t len = strlen(name);
+  size_t suffix_len = strlen(WAV_FILE_SUFFIX);
+
+  if (tts_clips_count >= TTS_MAX_CLIPS ||
+      len <= suffix_len || len - suffix_len >= TTS_MAX_WORD_LEN ||
+      strcmp(name + len - suffix_len, WAV_FILE_SUFFIX)) {
+    return false;
+  }
+
+  snprintf(filename, sizeof(filename), "%s%s", dir, name);
+
+  SF_INFO sfinfo;
+  SNDFILE *infile = sf_open(filename, SFM_READ, &sfinfo);
+
+  if (infile == NULL) {
+    return false;
+  }
+
+  if (sfinfo.channels != 1 || sfinfo.samplerate != PCM_RATE) {
+    fprintf(stderr, "%s: not a %d Hz mono clip\n", filename, PCM_RATE);
+    sf_close(infile);
+    return false;
+  }
+
+  tts_clip_t *clip = &tts_clips[tts_clips_count];
+
+  clip->samples = (short int *) malloc(sfinfo.frames * sizeof(short int));
+  if (clip->samples == NULL) {
+    sf_close(infile);
+    return false;
+  }
+
+  clip->frames = sf_readf_short(infile, clip->samples, sfinfo.frames);
+  sf_close(infile);
+
+  memcpy(clip->word, name, len - suffix_len);
+  clip->word[len - suffix_len] = 0;
+
+  tts_clips_count++;
+
+  return true;
+}
+
+static int TTS_Lookup(const char *word)
+{
+  for (unsigned int i = 0; i < tts_clips_count; i++) {
+    if (!strcmp(tts_clips[i].word, word)) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+/* returns false when interrupted */
+static bool TTS_Play_Clip(const tts_clip_t *clip)
 {
-    int pcmrc;
-    int readcount;
+  sf_count_t offset = 0;
 
-    SF_INFO sfinfo;
-    SNDFILE *infile = NULL;
+  while (offset < clip->frames) {
+    if (tts_preempt) {
+      return false;
+    }
+
+    snd_pcm_uframes_t count = clip->frames - offset;
+    if (count > pcm_frames) {
+      count = pcm_frames;
+    }
+
+    snd_pcm_sframes_t pcmrc = snd_pcm_writei(pcm_handle,
+                                             &clip->samples[offset], count);
+    if (pcmrc == -EPIPE) {
+      fprintf(stderr, "Underrun!\n");
+      snd_pcm_prepare(pcm_handle);
+    } else if (pcmrc < 0) {
+      fprintf(stderr, "Error writing to PCM device: %s\n", snd_strerror(pcmrc));
+      return true;
+    } else {
+      offset += pcmrc;
+    }
+  }
+
+  return true;
+}
+
+static void *TTS_Task(void *arg)
+{
+  tts_msg_t msg;
+
+  while (true) {
+    pthread_mutex_lock(&tts_mutex);
 
-    infile = sf_open(filename, SFM_READ, &sfinfo);
+    int best;
 
-    while ((readcount = sf_readf_short(infile, buf, frames))>0) {
+    while (true) {
+      unsigned long ms = millis();
 
-        pcmrc = snd_pcm_writei(pcm_handle, buf, readcount);
-        if (pcmrc == -EPIPE) {
-            fprintf(stderr, "Underrun!\n");
-            snd_pcm_prepare(pcm_handle);
+      best = -1;
+      for (int i = 0; i < TTS_QUEUE_SIZE; i++) {
+        if (tts_queue[i].count == 0) {
+          continue;
         }
-        else if (pcmrc < 0) {
-            fprintf(stderr, "Error writing to PCM device: %s\n", snd_strerror(pcmrc));
+        if (ms - tts_queue[i].timestamp > VOICE_EXPIRATION_TIME * 1000UL) {
+          tts_queue[i].count = 0;
+          TTS_stats.expired++;
+          TTS_stats.depth--;
+          continue;
         }
-        else if (pcmrc != readcount) {
-            fprintf(stderr,"PCM write difffers from file read.\n");
+        if (best < 0 ||
+            tts_queue[i].priority >  tts_queue[best].priority ||
+           (tts_queue[i].priority == tts_queue[best].priority &&
+            (long) (tts_queue[i].timestamp - tts_queue[best].timestamp) > 0)) {
+          best = i;
         }
+      }
+
+      if (best >= 0) {
+        break;
+      }
+      pthread_cond_wait(&tts_cond, &tts_mutex);
     }
 
-    sf_close(infile);
+    msg = tts_queue[best];
+    tts_queue[best].count = 0;
+    TTS_stats.depth--;
+
+    tts_playing = msg.priority;
+    tts_preempt = false;
+
+    TTS_stats.latency = millis() - msg.timestamp;
+    if (TTS_stats.latency > TTS_stats.latency_max) {
+      TTS_stats.latency_max = TTS_stats.latency;
+    }
+
+    pthread_mutex_unlock(&tts_mutex);
+
+    bool complete = true;
+
+    for (uint8_t i = 0; i < msg.count && complete; i++) {
+      complete = TTS_Play_Clip(&tts_clips[msg.clips[i]]);
+    }
+
+    if (complete) {
+      snd_pcm_drain(pcm_handle);
+      TTS_stats.played++;
+    } else {
+      snd_pcm_drop(pcm_handle);
+      TTS_stats.preempted++;
+    }
+    snd_pcm_prepare(pcm_handle);
+
+    pthread_mutex_lock(&tts_mutex);
+    tts_playing = 0;
+    pthread_mutex_unlock(&tts_mutex);
+  }
+
+  return NULL;
 }
 
-static void RPi_TTS(char *message)
+static bool TTS_setup()
 {
-  snd_pcm_t *pcm_handle;
+  char dir[MAX_FILENAME_LEN];
   snd_pcm_hw_params_t *params;
-  snd_pcm_uframes_t frames;
-  short int* buf = NULL;
-  int dir;
-  int channels = 1;
+  int pcm_dir;
 
-  char filename[MAX_FILENAME_LEN];
+  snprintf(dir, sizeof(dir), "%s%s", WAV_FILE_PREFIX,
+           settings->voice == VOICE_1 ? VOICE1_SUBDIR :
+          (settings->voice == VOICE_2 ? VOICE2_SUBDIR :
+          (settings->voice == VOICE_3 ? VOICE3_SUBDIR :
+           "" )));
 
+  DIR *d = opendir(dir);
+  if (d == NULL) {
+    fprintf(stderr, "Unable to open %s\n", dir);
+    return false;
+  }
+
+  struct dirent *entry;
+  while ((entry = readdir(d)) != NULL) {
+    TTS_Load_Clip(dir, entry->d_name);
+  }
+  closedir(d);
+
+  /* Open the PCM device in playback mode */
+  if (snd_pcm_open(&pcm_handle, PCM_DEVICE, SND_PCM_STREAM_PLAYBACK, 0) < 0) {
+    fprintf(stderr, "Unable to open PCM device %s\n", PCM_DEVICE);
+    return false;
+  }
+
+  /* Allocate parameters object and fill it with default values*/
+  snd_pcm_hw_params_alloca(&params);
+  snd_pcm_hw_params_any(pcm_handle, params);
+  /* Set parameters */
+  snd_pcm_hw_params_set_access(pcm_handle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+  snd_pcm_hw_params_set_format(pcm_handle, params, SND_PCM_FORMAT_S16_LE);
+  snd_pcm_hw_params_set_channels(pcm_handle, params, 1);
+  snd_pcm_hw_params_set_rate(pcm_handle, params, PCM_RATE, 0);
+
+  /* Write parameters */
+  snd_pcm_hw_params(pcm_handle, params);
+
+  /* Write clips in chunks of single period, to be able to stop in time */
+  snd_pcm_hw_params_get_period_size(params, &pcm_frames, &pcm_dir);
+
+  memset(tts_queue, 0, sizeof(tts_queue));
+  memset(&TTS_stats, 0, sizeof(TTS_stats));
+
+  if (pthread_create(&tts_thread, NULL, &TTS_Task, (void *)0) != 0) {
+    fprintf(stderr, "pthread_create(TTS_Task) Failed\n\n");
+    snd_pcm_close(pcm_handle);
+    pcm_handle = NULL;
+    return false;
+  }
+
+  Serial.print(F("INFO: "));
+  Serial.print(tts_clips_count);
+  Serial.println(F(" voice clips are loaded"));
+
+  return true;
+}
+
+/*
+ * Urgency of a traffic callout is told by its words:
+ * each of distance and altitude that is "near" adds one.
+ */
+static uint8_t TTS_Priority(const char *message)
+{
+  uint8_t priority = 1;
+  const char *s = message;
+
+  while ((s = strstr(s, "near")) != NULL) {
+    priority++;
+    s += strlen("near");
+  }
+
+  return priority;
+}
+
+static void RPi_TTS(char *message)
+{
   if (!strcmp(message, "POST")) {
+    if (settings->voice != VOICE_OFF) {
+      TTS_setup();
+    }
     if (hw_info.display == DISPLAY_EPD_2_7) {
       /* keep boot-time SkyView logo on the screen for 7 seconds */
       delay(7000);
     }
-  } else if (settings->voice != VOICE_OFF) {
-
-    /* Open the PCM device in playback mode */
-    snd_pcm_open(&pcm_handle, PCM_DEVICE, SND_PCM_STREAM_PLAYBACK, 0);
-
-    /* Allocate parameters object and fill it with default values*/
-    snd_pcm_hw_params_alloca(&params);
-    snd_pcm_hw_params_any(pcm_handle, params);
-    /* Set parameters */
-    snd_pcm_hw_params_set_access(pcm_handle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
-    snd_pcm_hw_params_set_format(pcm_handle, params, SND_PCM_FORMAT_S16_LE);
-    snd_pcm_hw_params_set_channels(pcm_handle, params, 1);
-    snd_pcm_hw_params_set_rate(pcm_handle, params, 22050, 0);
-
-    /* Write parameters */
-    snd_pcm_hw_params(pcm_handle, params);
+  } else if (settings->voice != VOICE_OFF && pcm_handle != NULL) {
 
-    /* Allocate buffer to hold single period */
-    snd_pcm_hw_params_get_period_size(params, &frames, &dir);
+    tts_msg_t msg;
 
-    buf = (short int *) malloc(frames * channels * sizeof(short int));
+    msg.priority  = TTS_Priority(message);
+    msg.count     = 0;
+    msg.timestamp = millis();
 
     char *word = strtok (message, " ");
 
-    while (word != NULL)
+    while (word != NULL && msg.count < TTS_MAX_WORDS)
     {
-        strcpy(filename, WAV_FILE_PREFIX);
-        strcat(filename,  settings->voice == VOICE_1 ? VOICE1_SUBDIR :
-                         (settings->voice == VOICE_2 ? VOICE2_SUBDIR :
-                         (settings->voice == VOICE_3 ? VOICE3_SUBDIR :
-                          "" )));
-        strcat(filename, word);
-        strcat(filename, WAV_FILE_SUFFIX);
-        play_file(pcm_handle, filename, buf, frames);
+        int ndx = TTS_Lookup(word);
+
+        if (ndx >= 0) {
+          msg.clips[msg.count++] = ndx;
+        } else {
+          TTS_stats.missing++;
+        }
         word = strtok (NULL, " ");
+    }
 
-        /* Poll input source(s) */
-        Input_loop();
+    if (msg.count == 0) {
+      return;
     }
 
-    snd_pcm_drain(pcm_handle);
-    snd_pcm_close(pcm_handle);
-    free(buf);
+    pthread_mutex_lock(&tts_mutex);
+
+    /* a newer callout supersedes those of the same or lower urgency */
+    int slot = -1;
+
+    for (int i = 0; i < TTS_QUEUE_SIZE; i++) {
+      if (tts_queue[i].count && tts_queue[i].priority <= msg.priority) {
+        tts_queue[i].count = 0;
+        TTS_stats.depth--;
+      }
+      if (slot < 0 && tts_queue[i].count == 0) {
+        slot = i;
+      }
+    }
+
+    /* the queue is full of more urgent ones */
+    if (slot >= 0) {
+      tts_queue[slot] = msg;
+      TTS_stats.queued++;
+      TTS_stats.depth++;
+      if (TTS_stats.depth > TTS_stats.depth_max) {
+        TTS_stats.depth_max = TTS_stats.depth;
+      }
+
+      if (tts_playing && msg.priority >= tts_playing) {
+        tts_preempt = true;
+      }
+      pthread_cond_signal(&tts_cond);
+    }
+
+    pthread_mutex_unlock(&tts_mutex);
   }
 }
 
@@ -708,18 +972,134 @@ void Input_loop() {
   }
 }
 
+/*
+ * Ingest throughput check: a synthetic picture of 'targets' aircraft
+ * is encoded both as $PFLAA sentences and as GDL90 traffic reports,
+ * then fed through the parsers in stream sized chunks.
+ */
+#define INGEST_BENCH_ROUNDS   200
+
+static void RPi_Ingest_Bench(int targets)
+{
+  std::string nmea_stream;
+  std::string gdl90_stream;
+  char sentence[NMEA_BUFFER_SIZE];
+  gdl_message_t msg;
+  gdl90_msg_traffic_report_t report;
+
+  gdl90_crcInit();
+
+  ThisAircraft.latitude  = 56.0;
+  ThisAircraft.longitude = 38.0;
+  ThisAircraft.altitude  = 500;
+
+  for (int i = 0; i < targets; i++) {
+    int north = ((i * 37) % 2000) - 1000;
+    int east  = ((i * 53) % 2000) - 1000;
+    int vert  = ((i * 7)  %  200) -  100;
+    uint32_t id = 0x400000 + i;
+
+    int len = snprintf(sentence, sizeof(sentence),
+                       "$PFLAA,0,%d,%d,%d,2,%06X!FLR_%06X,%d,,%d,%s,%d*",
+                       north, east, vert, id, id, (i * 11) % 360,
+                       20 + i % 30, "0.5", 1);
+    uint8_t csum = 0;
+    for (int j = 1; j < len - 1; j++) {
+      csum ^= sentence[j];
+    }
+    snprintf(sentence + len, sizeof(sentence) - len, "%02X\r\n", csum);
+    nmea_stream += sentence;
+
+    memset(&report, 0, sizeof(report));
+    report.address            = id;
+    report.addressType        = ADS_B_WITH_ICAO_ADDRESS;
+    report.latitude           = ThisAircraft.latitude  + north / 111000.0;
+    report.longitude          = ThisAircraft.longitude + east  / 62000.0;
+    report.altitude           = (ThisAircraft.altitude + vert) * _GPS_FEET_PER_METER;
+    report.horizontalVelocity = 40 + i % 60;
+    report.trackOrHeading     = (i * 11) % 360;
+    report.emitterCategory    = (emitter_category_t) 9;
+    memcpy(report.callsign, "BENCH   ", sizeof(report.callsign));
+    encode_gdl90_traffic_report(&msg, &report);
+
+    uint8_t *raw = (uint8_t *) &msg;
+    size_t raw_len = 1 + 1 + GDL90_MSG_LEN_TRAFFIC_REPORT + 2 + 1;
+
+    gdl90_stream += (char) GDL90_FLAG_BYTE;
+    for (size_t j = 1; j < raw_len - 1; j++) {
+      if (raw[j] == GDL90_FLAG_BYTE || raw[j] == GDL90_CONTROL_ESCAPE) {
+        gdl90_stream += (char) GDL90_CONTROL_ESCAPE;
+        gdl90_stream += (char) (raw[j] ^ GDL90_ESCAPE_BYTE);
+      } else {
+        gdl90_stream += (char) raw[j];
+      }
+    }
+    gdl90_stream += (char) GDL90_FLAG_BYTE;
+  }
+
+  for (int pass = 0; pass < 2; pass++) {
+    const std::string &stream = pass ? gdl90_stream : nmea_stream;
+    const char *data = stream.data();
+    size_t size = stream.size();
+    unsigned long start = micros();
+
+    for (int round = 0; round < INGEST_BENCH_ROUNDS; round++) {
+      for (size_t ofs = 0; ofs < size; ofs += NMEA_CHUNK_SIZE) {
+        size_t chunk = size - ofs < NMEA_CHUNK_SIZE ? size - ofs : NMEA_CHUNK_SIZE;
+
+        if (pass) {
+          GDL90_Parse_Buffer((const uint8_t *) data + ofs, chunk);
+        } else {
+          NMEA_Parse_Buffer(data + ofs, chunk);
+        }
+      }
+    }
+
+    unsigned long elapsed = micros() - start;
+    double seconds = (elapsed ? elapsed : 1) / 1000000.0;
+    int tracked = 0;
+
+    for (int i = 0; i < MAX_TRACKING_OBJECTS; i++) {
+      if (Container[i].ID != 0) {
+        tracked++;
+      }
+    }
+
+    fprintf(stderr, "%s: %d targets, %u bytes x %d, %lu us, "
+                    "%.0f msgs/s, %.0f KB/s, %d tracked\n",
+                    pass ? "GDL90" : "NMEA", targets, (unsigned int) size,
+                    INGEST_BENCH_ROUNDS, elapsed,
+                    targets * INGEST_BENCH_ROUNDS / seconds,
+                    size * INGEST_BENCH_ROUNDS / seconds / 1024,
+                    tracked);
+
+    for (int i = 0; i < MAX_TRACKING_OBJECTS; i++) {
+      Container[i] = EmptyFO;
+      Traffic_Rank_Update(i);
+    }
+  }
+}
+
 int main(int argc, char *argv[])
 {
   bool isSysVinit = false;
+  int bench_targets = 0;
   int opt;
 
-  while ((opt = getopt(argc, argv, "b")) != -1) {
+  while ((opt = getopt(argc, argv, "bt:")) != -1) {
       switch (opt) {
       case 'b': isSysVinit = true; break;
+      case 't': bench_targets = atoi(optarg); break;
       default: break;
       }
   }
 
+  /* does not need any hardware, so run it off target as well */
+  if (bench_targets > 0) {
+    RPi_Ingest_Bench(bench_targets);
+    exit(EXIT_SUCCESS);
+  }
+
   // Init GPIO bcm
   if (!bcm2835_init()) {
       fprintf( stderr, "bcm2835_init() Failed\n\n" );
@@ -827,6 +1207,16 @@ void shutdown(const char *msg)
 {
   SoC->WDT_fini();
 
+  if (TTS_stats.queued) {
+    fprintf(stderr, "Voice: %u queued, %u played, %u preempted, %u expired, "
+                    "%u missing words, depth %u (max. %u), "
+                    "latency %u ms (max. %u ms)\n",
+            TTS_stats.queued, TTS_stats.played, TTS_stats.preempted,
+            TTS_stats.expired, TTS_stats.missing,
+            TTS_stats.depth, TTS_stats.depth_max,
+            TTS_stats.latency, TTS_stats.latency_max);
+  }
+
   SoC->DB_fini();
 
   EPD_fini(msg);
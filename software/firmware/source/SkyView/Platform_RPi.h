@@ -28,8 +28,28 @@
 #define MAX_TRACKING_OBJECTS    9
 
 #define PCM_DEVICE              "default"
+#define PCM_RATE                22050
 #define WAV_FILE_PREFIX         "Audio/"
 
+#define TTS_QUEUE_SIZE          4
+#define TTS_MAX_CLIPS           64
+#define TTS_MAX_WORDS           16
+#define TTS_MAX_WORD_LEN        16
+
+typedef struct tts_stats_struct {
+  uint32_t queued;
+  uint32_t played;
+  uint32_t preempted;   /* interrupted by a more urgent one */
+  uint32_t expired;     /* waited in the queue for too long */
+  uint32_t missing;     /* words without a clip */
+  uint8_t  depth;
+  uint8_t  depth_max;
+  uint32_t latency;     /* ms, from the request to start of playback */
+  uint32_t latency_max;
+} tts_stats_t;
+
+extern tts_stats_t TTS_stats;
+
 /* Waveshare Pi HAT 2.7" buttons mapping */
 #define SOC_GPIO_BUTTON_MODE    RPI_V2_GPIO_P1_29
 #define SOC_GPIO_BUTTON_UP      RPI_V2_GPIO_P1_31
@@ -29,6 +29,15 @@
 traffic_t ThisAircraft, Container[MAX_TRACKING_OBJECTS], fo, EmptyFO;
 traffic_by_dist_t traffic[MAX_TRACKING_OBJECTS];
 
+/*
+ * Container entries that are in use, the most important one first:
+ * higher alarm level, then shorter distance. A slot is moved into its
+ * place every time when it is written, so that the views and the voice
+ * only have to walk the head of the list.
+ */
+static traffic_by_dist_t traffic_rank[MAX_TRACKING_OBJECTS];
+static int traffic_ranked = 0;
+
 static unsigned long UpdateTrafficTimeMarker = 0;
 static unsigned long Traffic_Voice_TimeMarker = 0;
 static uint32_t Traffic_Voice_ID_prev = 0;
@@ -51,6 +60,7 @@ void Traffic_Add()
       for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
         if (Container[i].ID == fo.ID) {
           Container[i] = fo;
+          Traffic_Rank_Update(i);
           return;
         }
       }
@@ -63,6 +73,7 @@ void Traffic_Add()
       for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
         if (now() - Container[i].timestamp > ENTRY_EXPIRATION_TIME) {
           Container[i] = fo;
+          Traffic_Rank_Update(i);
           return;
         }
 
@@ -80,12 +91,14 @@ void Traffic_Add()
 
       if (fo.AlarmLevel > Container[min_level_ndx].AlarmLevel) {
         Container[min_level_ndx] = fo;
+        Traffic_Rank_Update(min_level_ndx);
         return;
       }
 
       if (fo_distance_sq <  max_distance_sq &&
           fo.AlarmLevel  >= Container[max_dist_ndx].AlarmLevel) {
         Container[max_dist_ndx] = fo;
+        Traffic_Rank_Update(max_dist_ndx);
         return;
       }
     }
@@ -110,19 +123,11 @@ void Traffic_Update(traffic_t *fop)
 
 static void Traffic_Voice()
 {
-  int j=0;
+  int j;
   int bearing;
   char message[80];
 
-  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (Container[i].ID && (now() - Container[i].timestamp) <= VOICE_EXPIRATION_TIME) {
-
-      traffic[j].fop = &Container[i];
-      traffic[j].distance = sqrtf(Container[i].RelativeNorth * Container[i].RelativeNorth +
-                                  Container[i].RelativeEast  * Container[i].RelativeEast);
-      j++;
-    }
-  }
+  j = Traffic_Ranked(traffic, 1, VOICE_EXPIRATION_TIME);
 
   if (j > 0 && traffic[0].fop->ID != Traffic_Voice_ID_prev) {
 
@@ -133,8 +138,6 @@ static void Traffic_Voice()
     char how_far[32];
     char elev[32];
 
-    qsort(traffic, j, sizeof(traffic_by_dist_t), traffic_cmp_by_distance);
-
     bearing = (int) (atan2f(traffic[0].fop->RelativeNorth,
                             traffic[0].fop->RelativeEast) * 180.0 / PI);  /* -180 ... 180 */
 
@@ -264,10 +267,13 @@ void Traffic_loop()
 
         if (Container[i].ID &&
             (ThisAircraft.timestamp - Container[i].timestamp) <= ENTRY_EXPIRATION_TIME) {
-          if ((ThisAircraft.timestamp - Container[i].timestamp) >= TRAFFIC_VECTOR_UPDATE_INTERVAL)
+          if ((ThisAircraft.timestamp - Container[i].timestamp) >= TRAFFIC_VECTOR_UPDATE_INTERVAL) {
             Traffic_Update(&Container[i]);
+            Traffic_Rank_Update(i);
+          }
         } else {
           Container[i] = EmptyFO;
+          Traffic_Rank_Update(i);
         }
       }
 
@@ -289,6 +295,7 @@ void Traffic_ClearExpired()
   for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
     if (Container[i].ID && (now() - Container[i].timestamp) > ENTRY_EXPIRATION_TIME) {
       Container[i] = EmptyFO;
+      Traffic_Rank_Update(i);
     }
   }
 }
@@ -306,6 +313,65 @@ int Traffic_Count()
   return count;
 }
 
+static inline bool traffic_rank_above(traffic_t *fop, float distance,
+                                      traffic_by_dist_t *tp)
+{
+  if (fop->AlarmLevel != tp->fop->AlarmLevel) {
+    return fop->AlarmLevel > tp->fop->AlarmLevel;
+  }
+
+  return distance < tp->distance;
+}
+
+/* has to be called every time when Container[ndx] is written or cleared */
+void Traffic_Rank_Update(int ndx)
+{
+  traffic_t *fop = &Container[ndx];
+  int pos;
+
+  for (pos = 0; pos < traffic_ranked; pos++) {
+    if (traffic_rank[pos].fop == fop) {
+      traffic_ranked--;
+      memmove(&traffic_rank[pos], &traffic_rank[pos + 1],
+              (traffic_ranked - pos) * sizeof(traffic_by_dist_t));
+      break;
+    }
+  }
+
+  if (fop->ID == 0) {
+    return;
+  }
+
+  /* the only place where the distance gets a square root taken */
+  float distance = sqrtf(fop->RelativeNorth * fop->RelativeNorth +
+                         fop->RelativeEast  * fop->RelativeEast);
+
+  for (pos = traffic_ranked;
+       pos > 0 && traffic_rank_above(fop, distance, &traffic_rank[pos - 1]);
+       pos--) {
+    traffic_rank[pos] = traffic_rank[pos - 1];
+  }
+
+  traffic_rank[pos].fop      = fop;
+  traffic_rank[pos].distance = distance;
+  traffic_ranked++;
+}
+
+/* copies up to 'max' most important entries that are not older than 'age' */
+int Traffic_Ranked(traffic_by_dist_t *list, int max, time_t age)
+{
+  time_t timestamp = now();
+  int j = 0;
+
+  for (int i = 0; i < traffic_ranked && j < max; i++) {
+    if (timestamp - traffic_rank[i].fop->timestamp <= age) {
+      list[j++] = traffic_rank[i];
+    }
+  }
+
+  return j;
+}
+
 int traffic_cmp_by_distance(const void *a, const void *b)
 {
   traffic_by_dist_t *ta = (traffic_by_dist_t *)a;
@@ -76,6 +76,9 @@ void Traffic_Update       (traffic_t *);
 void Traffic_ClearExpired (void);
 int  Traffic_Count        (void);
 
+void Traffic_Rank_Update  (int);
+int  Traffic_Ranked       (traffic_by_dist_t *, int, time_t);
+
 int  traffic_cmp_by_distance(const void *, const void *);
 
 extern traffic_t ThisAircraft, Container[MAX_TRACKING_OBJECTS], fo, EmptyFO;
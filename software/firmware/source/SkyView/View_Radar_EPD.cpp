@@ -41,6 +41,65 @@ static navbox_t navbox4;
 
 static int EPD_zoom = ZOOM_MEDIUM;
 
+#define EPD_RADAR_MAX_GLYPHS    (MAX_TRACKING_OBJECTS + 12)
+#define EPD_RADAR_TARGET_SIZE   15      /* pixels, largest target symbol */
+
+/* retained scene of two most recent frames */
+static epd_glyph_t EPD_scene[2][EPD_RADAR_MAX_GLYPHS];
+static int  EPD_scene_count[2] = { 0, 0 };
+static int  EPD_scene_curr     = 0;
+static bool EPD_scene_valid    = false;
+
+static void EPD_Scene_Add(uint8_t type, int32_t key,
+                          int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int count = EPD_scene_count[EPD_scene_curr];
+
+  if (count < EPD_RADAR_MAX_GLYPHS) {
+    epd_glyph_t *glyph = &EPD_scene[EPD_scene_curr][count];
+
+    glyph->type = type;
+    glyph->key  = key;
+    glyph->x    = x;
+    glyph->y    = y;
+    glyph->w    = w;
+    glyph->h    = h;
+
+    EPD_scene_count[EPD_scene_curr] = count + 1;
+  } else {
+    /* untracked glyph - next frame has to be a full one */
+    EPD_Damage(x, y, w, h);
+    EPD_scene_valid = false;
+  }
+}
+
+static int32_t EPD_Scene_Key(const char *text)
+{
+  int32_t key = 0;
+
+  for (const char *c = text; *c; c++) {
+    key = key * 31 + *c;
+  }
+
+  return key;
+}
+
+static void EPD_Scene_Add_Text(const char *text, int16_t x, int16_t y)
+{
+  int16_t  tbx, tby;
+  uint16_t tbw, tbh;
+
+  display->getTextBounds(text, x, y, &tbx, &tby, &tbw, &tbh);
+
+  EPD_Scene_Add(EPD_GLYPH_LABEL, EPD_Scene_Key(text),
+                tbx - 1, tby - 1, tbw + 2, tbh + 2);
+}
+
+static void EPD_Scene_Add_NavBox(navbox_t *nb)
+{
+  EPD_Scene_Add(EPD_GLYPH_LABEL, nb->value, nb->x, nb->y, nb->width, nb->height);
+}
+
 static void EPD_Draw_NavBoxes()
 {
   int16_t  tbx, tby;
@@ -84,6 +143,9 @@ static void EPD_Draw_NavBoxes()
     display->setCursor(navbox2.x + 8, navbox2.y + 30);
     display->print(navbox2.value == PROTOCOL_NMEA  ? "NMEA" :
                    navbox2.value == PROTOCOL_GDL90 ? " GDL" : " UNK" );
+
+    EPD_Scene_Add_NavBox(&navbox1);
+    EPD_Scene_Add_NavBox(&navbox2);
   }
 
   uint16_t bottom_navboxes_x = navbox3.x;
@@ -133,6 +195,9 @@ static void EPD_Draw_NavBoxes()
 
     display->setCursor(navbox4.x + 15, navbox4.y + 32);
     display->print((float) navbox4.value / 10);
+
+    EPD_Scene_Add_NavBox(&navbox3);
+    EPD_Scene_Add_NavBox(&navbox4);
   }
 }
 
@@ -287,6 +352,14 @@ static void EPD_Draw_Radar()
         int16_t x = constrain((rel_x * radius) / divider, -32768, 32767);
         int16_t y = constrain((rel_y * radius) / divider, -32768, 32767);
 
+        int32_t shape = (Container[i].RelativeVertical >   EPD_RADAR_V_THRESHOLD ? 1 :
+                         Container[i].RelativeVertical < - EPD_RADAR_V_THRESHOLD ? 2 : 0);
+
+        EPD_Scene_Add(EPD_GLYPH_TARGET, isTeam ? shape + 3 : shape,
+                      radar_center_x + x - EPD_RADAR_TARGET_SIZE / 2,
+                      radar_center_y - y - EPD_RADAR_TARGET_SIZE / 2,
+                      EPD_RADAR_TARGET_SIZE, EPD_RADAR_TARGET_SIZE);
+
         if        (Container[i].RelativeVertical >   EPD_RADAR_V_THRESHOLD) {
           if (isTeam) {
             display->drawTriangle(radar_center_x + x - 5, radar_center_y - y + 4,
@@ -370,32 +443,39 @@ static void EPD_Draw_Radar()
       y = radar_y + (radar_w + tbh) / 2;
       display->setCursor(x , y);
       display->print("W");
+      EPD_Scene_Add_Text("W", x, y);
       x = radar_x + radar_w / 2 + radius - (3 * tbw)/2;
       y = radar_y + (radar_w + tbh) / 2;
       display->setCursor(x , y);
       display->print("E");
+      EPD_Scene_Add_Text("E", x, y);
       x = radar_x + (radar_w - tbw) / 2;
       y = radar_y + radar_w/2 - radius + (3 * tbh)/2;
       display->setCursor(x , y);
       display->print("N");
+      EPD_Scene_Add_Text("N", x, y);
       x = radar_x + (radar_w - tbw) / 2;
       y = radar_y + radar_w/2 + radius - tbh/2;
       display->setCursor(x , y);
       display->print("S");
+      EPD_Scene_Add_Text("S", x, y);
       break;
     case DIRECTION_TRACK_UP:
       x = radar_x + radar_w / 2 - radius + tbw/2;
       y = radar_y + (radar_w + tbh) / 2;
       display->setCursor(x , y);
       display->print("L");
+      EPD_Scene_Add_Text("L", x, y);
       x = radar_x + radar_w / 2 + radius - (3 * tbw)/2;
       y = radar_y + (radar_w + tbh) / 2;
       display->setCursor(x , y);
       display->print("R");
+      EPD_Scene_Add_Text("R", x, y);
       x = radar_x + (radar_w - tbw) / 2;
       y = radar_y + radar_w/2 + radius - tbh/2;
       display->setCursor(x , y);
       display->print("B");
+      EPD_Scene_Add_Text("B", x, y);
 
       display->setFont(&FreeMonoBold9pt7b);
       snprintf(cog_text, sizeof(cog_text), "%03d", ThisAircraft.Track);
@@ -408,6 +488,8 @@ static void EPD_Draw_Radar()
       display->drawRoundRect( x - 2, y - tbh - 2,
                               tbw + 8, tbh + 6,
                               4, GxEPD_BLACK);
+      EPD_Scene_Add(EPD_GLYPH_LABEL, ThisAircraft.Track,
+                    x - 2, y - tbh - 2, tbw + 8, tbh + 6);
       break;
     default:
       /* TBD */
@@ -457,10 +539,35 @@ void EPD_radar_setup()
   navbox4.timestamp  = millis();
 }
 
+void EPD_radar_invalidate()
+{
+  EPD_scene_valid = false;
+}
+
+static void EPD_radar_Scene_Message(const char *msg)
+{
+  uint16_t radar_y = (display->height() - display->width()) / 2;
+  uint16_t radar_w = display->width();
+
+  EPD_Scene_Add(EPD_GLYPH_LABEL, EPD_Scene_Key(msg),
+                0, radar_y, radar_w, radar_w);
+}
+
 void EPD_radar_loop()
 {
   if (isTimeToDisplay() && SoC->EPD_is_ready()) {
 
+    int  scene_prev = EPD_scene_curr;
+    bool partial    = EPD_scene_valid;
+
+    EPD_scene_curr ^= 1;
+    EPD_scene_count[EPD_scene_curr] = 0;
+    EPD_scene_valid = true;
+
+    if (partial) {
+      EPD_Damage_Begin();
+    }
+
     bool hasData = settings->protocol == PROTOCOL_NMEA  ? NMEA_isConnected()  :
                    settings->protocol == PROTOCOL_GDL90 ? GDL90_isConnected() :
                    false;
@@ -475,9 +582,11 @@ void EPD_radar_loop()
         EPD_Draw_Radar();
       } else {
         EPD_radar_Draw_Message(NO_FIX_TEXT, NULL);
+        EPD_radar_Scene_Message(NO_FIX_TEXT);
       }
     } else {
       EPD_radar_Draw_Message(NO_DATA_TEXT, NULL);
+      EPD_radar_Scene_Message(NO_DATA_TEXT);
     }
 
     navbox1.value = Traffic_Count();
@@ -500,6 +609,12 @@ void EPD_radar_loop()
 
     EPD_Draw_NavBoxes();
 
+    if (partial) {
+      EPD_Damage_Scene(EPD_scene[scene_prev], EPD_scene_count[scene_prev],
+                       EPD_scene[EPD_scene_curr],
+                       EPD_scene_count[EPD_scene_curr]);
+    }
+
     SoC->EPD_update(EPD_UPDATE_FAST);
 
     EPDTimeMarker = millis();
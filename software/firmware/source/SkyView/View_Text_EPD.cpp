@@ -34,20 +34,12 @@ static int EPD_current = 1;
 
 static void EPD_Draw_Text()
 {
-  int j=0;
+  int j;
   int bearing;
   char info_line [TEXT_VIEW_LINE_LENGTH];
   char id_text   [TEXT_VIEW_LINE_LENGTH];
 
-  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (Container[i].ID && (now() - Container[i].timestamp) <= EPD_EXPIRATION_TIME) {
-
-      traffic[j].fop = &Container[i];
-      traffic[j].distance = sqrtf(Container[i].RelativeNorth * Container[i].RelativeNorth +
-                                  Container[i].RelativeEast  * Container[i].RelativeEast);
-      j++;
-    }
-  }
+  j = Traffic_Ranked(traffic, MAX_TRACKING_OBJECTS, EPD_EXPIRATION_TIME);
 
   if (j > 0) {
 
@@ -56,8 +48,6 @@ static void EPD_Draw_Text()
     float disp_dist;
     int   disp_alt, disp_spd;
 
-    qsort(traffic, j, sizeof(traffic_by_dist_t), traffic_cmp_by_distance);
-
     if (EPD_current > j) {
       EPD_current = j;
     }
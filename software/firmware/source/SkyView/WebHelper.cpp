@@ -25,6 +25,7 @@
 #include "NMEAHelper.h"
 #include "BatteryHelper.h"
 #include "GDL90Helper.h"
+#include "EPDHelper.h"
 
 #define NOLOGO
 
@@ -434,7 +435,7 @@ void handleRoot() {
   time_t timestamp = now();
   char str_Vcc[8];
 
-  size_t size = 2300;
+  size_t size = 2500;
   char *offset;
   size_t len = 0;
 
@@ -483,6 +484,19 @@ void handleRoot() {
   offset += len;
   size -= len;
 
+  if (hw_info.display == DISPLAY_EPD_2_7) {
+    snprintf_P ( offset, size,
+      PSTR("\
+  <tr><th align=left>Display refresh (max), ms</th><td align=right>%u (%u)</td></tr>\
+  <tr><th align=left>Frames shown / dropped</th><td align=right>%u / %u</td></tr>"),
+      (unsigned int) EPD_stats.refresh_ms, (unsigned int) EPD_stats.refresh_max_ms,
+      (unsigned int) EPD_stats.frames,     (unsigned int) EPD_stats.dropped
+    );
+    len = strlen(offset);
+    offset += len;
+    size -= len;
+  }
+
   switch (settings->connection)
   {
   case CON_WIFI_UDP:
@@ -45,6 +45,19 @@ bool TFT_vmode_updated = true;
 
 static Gesture_t gesture = { false, {0,0}, {0,0} };
 
+/*
+ * Views render into the back one of two long-lived 1 bpp frame buffers.
+ * On push it is compared with the front buffer, that holds what is on
+ * the panel, and only the band of rows that differ is sent over SPI.
+ */
+static uint8_t  TFT_back          = 2;
+static bool     TFT_front_valid   = false;
+static int16_t  TFT_dirty_y0      = INT16_MAX;
+static int16_t  TFT_dirty_y1      = -1;
+static uint32_t TFT_frame_start   = 0;
+
+tft_stats_t TFT_stats;
+
 const char SoftRF_text[]   = "SoftRF";
 
 void TFT_off()
@@ -105,6 +118,66 @@ void TFT_backlight_on()
 void TFT_Clear_Screen()
 {
   tft->fillScreen(TFT_NAVY);
+  TFT_Frame_Invalidate();
+}
+
+void TFT_Frame_Invalidate()
+{
+  TFT_front_valid = false;
+}
+
+/* rows drawn straight onto the panel, to be restored with the next push */
+void TFT_Frame_Dirty(int16_t y0, int16_t y1)
+{
+  if (y0 < TFT_dirty_y0) TFT_dirty_y0 = y0;
+  if (y1 > TFT_dirty_y1) TFT_dirty_y1 = y1;
+}
+
+void TFT_Frame_Begin()
+{
+  TFT_frame_start = micros();
+  sprite->frameBuffer(TFT_back);
+}
+
+void TFT_Frame_Push()
+{
+  int16_t  w      = sprite->width();
+  int16_t  h      = sprite->height();
+  size_t   stride = (w + 7) / 8;
+  uint8_t *back   = (uint8_t *) sprite->frameBuffer(TFT_back);
+  uint8_t *front  = (uint8_t *) sprite->frameBuffer(TFT_back == 1 ? 2 : 1);
+  int16_t  y0     = 0;
+  int16_t  y1     = h - 1;
+
+  if (TFT_front_valid) {
+    while (y0 < h  && !memcmp(back + y0 * stride, front + y0 * stride, stride)) y0++;
+    while (y1 > y0 && !memcmp(back + y1 * stride, front + y1 * stride, stride)) y1--;
+
+    if (TFT_dirty_y1 >= 0) {
+      if (TFT_dirty_y0 < y0) y0 = max(TFT_dirty_y0, (int16_t) 0);
+      if (TFT_dirty_y1 > y1) y1 = min(TFT_dirty_y1, (int16_t) (h - 1));
+    }
+  }
+
+  if (y0 < h && y0 <= y1) {
+    tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
+    tft->pushImage(0, y0, w, y1 - y0 + 1, back + y0 * stride, false);
+    TFT_stats.rows = y1 - y0 + 1;
+  } else {
+    TFT_stats.rows = 0;
+    TFT_stats.skipped++;
+  }
+
+  TFT_back        = (TFT_back == 1 ? 2 : 1);
+  TFT_front_valid = true;
+  TFT_dirty_y0    = INT16_MAX;
+  TFT_dirty_y1    = -1;
+
+  TFT_stats.frames++;
+  TFT_stats.frame_us = micros() - TFT_frame_start;
+  if (TFT_stats.frame_us > TFT_stats.frame_us_max) {
+    TFT_stats.frame_us_max = TFT_stats.frame_us;
+  }
 }
 
 byte TFT_setup()
@@ -124,6 +197,7 @@ byte TFT_setup()
 
     sprite = new TFT_eSprite(tft);
     sprite->setColorDepth(1);
+    sprite->createSprite(tft->width(), tft->height(), TFT_FRAMES);
 
     if (hw_info.baro == BARO_MODULE_NONE) {
       pinMode(SOC_GPIO_PIN_TWATCH_TP_IRQ, INPUT);
@@ -394,6 +468,8 @@ void TFT_Message(const char *msg1, const char *msg2)
   uint16_t x, y;
 
   if (msg1 != NULL && strlen(msg1) != 0) {
+    TFT_Frame_Invalidate();
+
     tft->setTextFont(4);
     tft->setTextSize(2);
 
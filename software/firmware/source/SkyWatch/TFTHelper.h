@@ -38,6 +38,16 @@
 #define TEXT_VIEW_LINE_LENGTH   13      /* characters */
 #define TEXT_VIEW_LINE_SPACING  8      /* pixels */
 
+#define TFT_FRAMES              2       /* 1 bpp frame buffers: front + back */
+
+typedef struct tft_stats_struct {
+  uint32_t frames;
+  uint32_t skipped;       /* back buffer identical to the front one */
+  uint32_t frame_us;      /* render + push of the last frame */
+  uint32_t frame_us_max;
+  uint16_t rows;          /* rows pushed with the last frame */
+} tft_stats_t;
+
 typedef struct Gesture_struct {
   bool     touched;
   TP_Point t_loc;
@@ -60,6 +70,11 @@ void TFT_Up();
 void TFT_Down();
 void TFT_Message(const char *, const char *);
 
+void TFT_Frame_Begin();
+void TFT_Frame_Push();
+void TFT_Frame_Dirty(int16_t, int16_t);
+void TFT_Frame_Invalidate();
+
 void TFT_status_setup();
 void TFT_status_loop();
 void TFT_status_next();
@@ -83,5 +98,6 @@ void TFT_time_prev();
 extern TFT_eSPI *tft;
 extern TFT_eSprite *sprite;
 extern bool TFT_vmode_updated;
+extern tft_stats_t TFT_stats;
 
 #endif /* TFTHELPER_H */
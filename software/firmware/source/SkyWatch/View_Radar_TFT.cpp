@@ -53,7 +53,7 @@ static void TFT_Draw_Radar()
   /* divider is a half of full scale */
   int32_t divider = 2000; 
 
-  sprite->createSprite(tft->width(), tft->height());
+  TFT_Frame_Begin();
 
   sprite->fillSprite(TFT_BLACK);
   sprite->setTextColor(TFT_WHITE);
@@ -204,9 +204,7 @@ static void TFT_Draw_Radar()
                   TFT_zoom == ZOOM_HIGH   ? " 1 NM" : "");
   }
 
-  tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
-  sprite->pushSprite(0, 0);
-  sprite->deleteSprite();
+  TFT_Frame_Push();
 
   for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
     if (Container[i].ID && (now() - Container[i].timestamp) <= TFT_EXPIRATION_TIME) {
@@ -267,6 +265,8 @@ static void TFT_Draw_Radar()
                         radar_center_y - y,
                         5, color);
       }
+
+      TFT_Frame_Dirty(radar_center_y - y - 5, radar_center_y - y + 5);
     }
   }
 }
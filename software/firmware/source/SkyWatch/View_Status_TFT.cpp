@@ -56,7 +56,7 @@ void TFT_status_loop()
   uint16_t tbw;
   uint16_t tbh;
 
-  sprite->createSprite(tft->width(), tft->height());
+  TFT_Frame_Begin();
 
   sprite->fillSprite(TFT_BLACK);
   sprite->setTextColor(TFT_WHITE);
@@ -147,9 +147,7 @@ void TFT_status_loop()
   sprite->setCursor(sprite->width()/2 + sprite->textWidth("  "), (5 * sprite->height())/6);
   sprite->print(Battery_voltage(), 1);
 
-  tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
-  sprite->pushSprite(0, 0);
-  sprite->deleteSprite();
+  TFT_Frame_Push();
 }
 
 void TFT_status_next()
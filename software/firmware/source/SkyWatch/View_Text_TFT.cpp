@@ -44,20 +44,12 @@ static int view_state_prev = STATE_TVIEW_NONE;
 
 static void TFT_Draw_Text()
 {
-  int j=0;
+  int j;
   int bearing;
   char info_line [TEXT_VIEW_LINE_LENGTH];
   char id_text   [TEXT_VIEW_LINE_LENGTH];
 
-  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (Container[i].ID && (now() - Container[i].timestamp) <= TFT_EXPIRATION_TIME) {
-
-      traffic[j].fop = &Container[i];
-      traffic[j].distance = sqrtf(Container[i].RelativeNorth * Container[i].RelativeNorth +
-                                  Container[i].RelativeEast  * Container[i].RelativeEast);
-      j++;
-    }
-  }
+  j = Traffic_Ranked(traffic, MAX_TRACKING_OBJECTS, TFT_EXPIRATION_TIME);
 
   if (j > 0) {
 
@@ -66,8 +58,6 @@ static void TFT_Draw_Text()
     float disp_dist;
     int   disp_alt, disp_spd;
 
-    qsort(traffic, j, sizeof(traffic_by_dist_t), traffic_cmp_by_distance);
-
     if (TFT_current > j) {
       TFT_current = j;
     }
@@ -173,7 +163,7 @@ static void TFT_Draw_Text()
      Serial.println(micros()-start);
 #endif
 
-    sprite->createSprite(tft->width(), tft->height());
+    TFT_Frame_Begin();
 
     sprite->fillSprite(TFT_BLACK);
     sprite->setTextColor(TFT_WHITE);
@@ -270,9 +260,7 @@ static void TFT_Draw_Text()
       sprite->print(id_text);
     }
 
-    tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
-    sprite->pushSprite(0, 0);
-    sprite->deleteSprite();
+    TFT_Frame_Push();
   }
 }
 
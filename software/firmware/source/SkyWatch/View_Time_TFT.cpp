@@ -55,7 +55,7 @@ void TFT_time_loop()
              now.hour, now.minute, now.second);
   }
 
-  sprite->createSprite(tft->width(), tft->height());
+  TFT_Frame_Begin();
 
   sprite->fillSprite(TFT_BLACK);
   sprite->setTextColor(TFT_WHITE);
@@ -77,9 +77,7 @@ void TFT_time_loop()
   sprite->setCursor((sprite->width() - tbw) / 2, (2 * sprite->height()) / 3);
   sprite->print(TZ_text);
 
-  tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
-  sprite->pushSprite(0, 0);
-  sprite->deleteSprite();
+  TFT_Frame_Push();
 }
 
 void TFT_time_next()
@@ -27,6 +27,11 @@
 #include "GDL90Helper.h"
 #include "BaroHelper.h"
 
+#if !defined(EXCLUDE_TFT)
+#include "TFTHelper.h"
+#include <esp_heap_caps.h>
+#endif /* EXCLUDE_TFT */
+
 #include <protocol.h>
 #include <freqplan.h>
 
@@ -941,7 +946,7 @@ void handleStatus() {
   time_t timestamp = now();
   char str_Vcc[8];
 
-  size_t size = 2700;
+  size_t size = 3000;
   char *offset;
   size_t len = 0;
 
@@ -1001,6 +1006,27 @@ void handleStatus() {
     len = strlen(offset);
     offset += len;
     size -= len;
+
+#if !defined(EXCLUDE_TFT)
+    if (hw_info.display == DISPLAY_TFT_TTGO) {
+      size_t heap_free    = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+      size_t heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+      snprintf_P ( offset, size,
+        PSTR("\
+<tr><th align=left>Frame time (last / max)</th><td align=right>%u / %u ms</td></tr>\
+<tr><th align=left>Frames (unchanged)</th><td align=right>%u (%u)</td></tr>\
+<tr><th align=left>Heap fragmentation</th><td align=right>%u %%</td></tr>"),
+        TFT_stats.frame_us / 1000, TFT_stats.frame_us_max / 1000,
+        TFT_stats.frames, TFT_stats.skipped,
+        heap_free ? (unsigned int) (100 - (100 * heap_largest) / heap_free) : 0
+      );
+
+      len = strlen(offset);
+      offset += len;
+      size -= len;
+    }
+#endif /* EXCLUDE_TFT */
   }
 
   snprintf_P ( offset, size,
@@ -117,6 +117,8 @@ typedef struct UFO {
     uint8_t   addr_type;
     float     latitude;
     float     longitude;
+    int32_t   lat_e7;   /* 1e-7 degrees, the same position as above */
+    int32_t   lon_e7;
     float     altitude;
     float     pressure_altitude;
     float     course;     /* CoG */
@@ -138,6 +140,8 @@ typedef struct UFO {
     /* 'legacy' specific data */
     float     distance;
     float     bearing;
+    int32_t   north;    /* metres from this aircraft */
+    int32_t   east;
     int8_t    alarm_level;
 
     /* ADS-B (ES, UAT, GDL90) specific data */
@@ -167,6 +171,16 @@ typedef struct IODev_ops_struct {
   size_t (*write)(const uint8_t *buffer, size_t size);
 } IODev_ops_t;
 
+typedef struct FlashDev_ops_struct {
+  const char name[16];
+  uint32_t (*setup)();  /* returns size of the area in bytes, 0 - N/A */
+  void (*fini)();
+  bool (*erase)(uint32_t addr);
+  bool (*write)(uint32_t addr, const uint8_t *buffer, size_t size);
+  bool (*read)(uint32_t addr, uint8_t *buffer, size_t size);
+  bool (*busy)();       /* area is not to be written now, NULL - never */
+} FlashDev_ops_t;
+
 enum
 {
 	SOFTRF_MODE_NORMAL,
@@ -87,6 +87,29 @@
 #include "src/system/Log.h"
 #endif /* LOGGER_IS_ENABLED */
 
+#if defined(USE_RECORDER)
+#include "src/system/Recorder.h"
+#endif /* USE_RECORDER */
+
+#if defined(USE_FISB)
+#include "src/protocol/data/FISB.h"
+#endif /* USE_FISB */
+
+#if defined(USE_RELAY)
+#include "src/system/Relay.h"
+#endif /* USE_RELAY */
+
+#if defined(USE_PROFILER)
+#include "src/system/Profile.h"
+#endif /* USE_PROFILER */
+
+#include "src/system/Export.h"
+#include "src/system/Position.h"
+
+#if defined(USE_TICKLESS)
+#include "src/system/Tickless.h"
+#endif /* USE_TICKLESS */
+
 #define DEBUG 0
 #define DEBUG_TIMING 0
 
@@ -226,6 +249,29 @@ void setup()
 
   SoC->post_init();
 
+#if defined(USE_RECORDER)
+  Recorder_setup();
+#endif /* USE_RECORDER */
+
+#if defined(USE_FISB)
+  FISB_setup();
+#endif /* USE_FISB */
+
+#if defined(USE_RELAY)
+  Relay_setup();
+#endif /* USE_RELAY */
+
+  Export_setup();
+
+#if defined(USE_PROFILER)
+  Profile_setup();
+  Position_Benchmark();
+#endif /* USE_PROFILER */
+
+#if defined(USE_TICKLESS)
+  Tickless_setup();
+#endif /* USE_TICKLESS */
+
   SoC->WDT_setup();
 }
 
@@ -281,6 +327,14 @@ void loop()
   Logger_loop();
 #endif /* LOGGER_IS_ENABLED */
 
+#if defined(USE_RECORDER)
+  Recorder_loop();
+#endif /* USE_RECORDER */
+
+#if defined(USE_FISB)
+  FISB_loop();
+#endif /* USE_FISB */
+
   SoC->loop();
 
   if (SoC->Bluetooth_ops) {
@@ -306,7 +360,12 @@ void loop()
   }
 #endif /* TAKE_CARE_OF_MILLIS_ROLLOVER */
 
+#if defined(USE_TICKLESS)
+  /* sleep till the earliest deadline or a radio/PPS interrupt */
+  Tickless_loop();
+#else
   yield();
+#endif /* USE_TICKLESS */
 }
 
 void shutdown(int reason)
@@ -329,6 +388,10 @@ void shutdown(int reason)
 
   WiFi_fini();
 
+#if defined(USE_RECORDER)
+  Recorder_fini();
+#endif /* USE_RECORDER */
+
   if (settings->mode != SOFTRF_MODE_UAV) {
     GNSS_fini();
   }
@@ -387,7 +450,14 @@ void normal()
   success = true;
 #endif
 
-  if (success && isValidFix()) ParseData();
+  if (success) {
+    /* traffic is of no use until own position is known */
+    if (isValidFix()) ParseData(); else RF_Receive_Flush();
+  }
+
+  if (settings->mode == SOFTRF_MODE_RELAY) {
+    RF_Relay();
+  }
 
 #if defined(ENABLE_TTN)
   TTN_loop();
@@ -449,7 +519,10 @@ void uav()
 
   success = RF_Receive();
 
-  if (success && isValidMAVFix()) ParseData();
+  if (success) {
+    /* traffic is of no use until own position is known */
+    if (isValidMAVFix()) ParseData(); else RF_Receive_Flush();
+  }
 
   if (isTimeToExport() && isValidMAVFix()) {
     MAVLinkShareTraffic();
@@ -22,12 +22,24 @@
 #include "driver/GNSS.h"
 #include "ui/Web.h"
 #include "protocol/radio/Legacy.h"
+#include "system/Recorder.h"
+#include "system/Profile.h"
+#include "system/Position.h"
 
 unsigned long UpdateTrafficTimeMarker = 0;
 
 ufo_t fo, Container[MAX_TRACKING_OBJECTS], EmptyFO;
 traffic_by_dist_t traffic_by_dist[MAX_TRACKING_OBJECTS];
 
+/*
+ * Container entries that are in use, the most important one first:
+ * higher alarm level, then shorter distance. A slot is moved into its
+ * place every time when it is written, so that a view only has to walk
+ * the head of the list instead of sorting the whole Container.
+ */
+static traffic_by_dist_t traffic_rank[MAX_TRACKING_OBJECTS];
+static int traffic_ranked = 0;
+
 static int8_t (*Alarm_Level)(ufo_t *, ufo_t *);
 
 /*
@@ -120,24 +132,24 @@ static int8_t Alarm_Legacy(ufo_t *this_aircraft, ufo_t *fop)
 
 void Traffic_Update(ufo_t *fop)
 {
-  fop->distance = gnss.distanceBetween( ThisAircraft.latitude,
-                                        ThisAircraft.longitude,
-                                        fop->latitude,
-                                        fop->longitude);
+  PROFILE_SCOPE(PROFILE_TRAFFIC);
+
+  Position_Reference(&ThisAircraft);
+  Position_Project(fop);
 
-  fop->bearing  = gnss.courseTo( ThisAircraft.latitude,
-                                 ThisAircraft.longitude,
-                                 fop->latitude,
-                                 fop->longitude);
+  fop->distance = Position_Distance(fop->north, fop->east);
+  fop->bearing  = Position_Bearing(fop->north, fop->east);
 
   if (Alarm_Level) {
     fop->alarm_level = (*Alarm_Level)(&ThisAircraft, fop);
   }
 }
 
+/* decodes the frame in RxBuffer and every other one queued by the RF driver */
 void ParseData()
 {
-    size_t rx_size = RF_Payload_Size(settings->rf_protocol);
+  do {
+    size_t rx_size = RF_Payload_Size(RF_last_protocol);
     rx_size = rx_size > sizeof(fo.raw) ? sizeof(fo.raw) : rx_size;
 
 #if DEBUG
@@ -154,53 +166,69 @@ void ParseData()
       StdOut.println(RF_last_rssi);
     }
 
-    if (protocol_decode && (*protocol_decode)((void *) RxBuffer, &ThisAircraft, &fo)) {
-
-      int i;
+    if (RF_Decode(RF_last_protocol, (void *) RxBuffer, &ThisAircraft, &fo)) {
 
       fo.rssi = RF_last_rssi;
 
+#if defined(USE_RECORDER)
+      Recorder_Traffic(&fo);
+#endif /* USE_RECORDER */
+
       Traffic_Update(&fo);
 
-      for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
-        if (Container[i].addr == fo.addr) {
-          Container[i] = fo;
-          return;
-        }
-      }
+      Traffic_Add(&fo);
+    }
+  } while (RF_Receive_Next());
+}
 
-      int max_dist_ndx = 0;
-      int min_level_ndx = 0;
+void Traffic_Add(ufo_t *fop)
+{
+  int i;
 
-      for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
-        if (now() - Container[i].timestamp > ENTRY_EXPIRATION_TIME) {
-          Container[i] = fo;
-          return;
-        }
+  for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    if (Container[i].addr == fop->addr) {
+      Container[i] = *fop;
+      Traffic_Rank_Update(i);
+      return;
+    }
+  }
+
+  int max_dist_ndx = 0;
+  int min_level_ndx = 0;
+
+  for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    if (now() - Container[i].timestamp > ENTRY_EXPIRATION_TIME) {
+      Container[i] = *fop;
+      Traffic_Rank_Update(i);
+      return;
+    }
 #if !defined(EXCLUDE_TRAFFIC_FILTER_EXTENSION)
-        if  (Container[i].distance > Container[max_dist_ndx].distance)  {
-          max_dist_ndx = i;
-        }
-        if  (Container[i].alarm_level < Container[min_level_ndx].alarm_level)  {
-          min_level_ndx = i;
-        }
+    if  (Container[i].distance > Container[max_dist_ndx].distance)  {
+      max_dist_ndx = i;
+    }
+    if  (Container[i].alarm_level < Container[min_level_ndx].alarm_level)  {
+      min_level_ndx = i;
+    }
 #endif /* EXCLUDE_TRAFFIC_FILTER_EXTENSION */
-      }
+  }
 
 #if !defined(EXCLUDE_TRAFFIC_FILTER_EXTENSION)
-      if (fo.alarm_level > Container[min_level_ndx].alarm_level) {
-        Container[min_level_ndx] = fo;
-        return;
-      }
+  if (fop->alarm_level > Container[min_level_ndx].alarm_level) {
+    Container[min_level_ndx] = *fop;
+    Traffic_Rank_Update(min_level_ndx);
+    return;
+  }
 
-      if (fo.distance    <  Container[max_dist_ndx].distance &&
-          fo.alarm_level >= Container[max_dist_ndx].alarm_level) {
-        Container[max_dist_ndx] = fo;
-        return;
-      }
+  if (fop->distance    <  Container[max_dist_ndx].distance &&
+      fop->alarm_level >= Container[max_dist_ndx].alarm_level) {
+    Container[max_dist_ndx] = *fop;
+    Traffic_Rank_Update(max_dist_ndx);
+    return;
+  }
 #endif /* EXCLUDE_TRAFFIC_FILTER_EXTENSION */
 
-    }
+  /* no room for this one */
+  PROFILE_COUNT(PROFILE_DROPS, 1);
 }
 
 void Traffic_setup()
@@ -230,10 +258,13 @@ void Traffic_loop()
 
       if (Container[i].addr &&
           (ThisAircraft.timestamp - Container[i].timestamp) <= ENTRY_EXPIRATION_TIME) {
-        if ((ThisAircraft.timestamp - Container[i].timestamp) >= TRAFFIC_VECTOR_UPDATE_INTERVAL)
+        if ((ThisAircraft.timestamp - Container[i].timestamp) >= TRAFFIC_VECTOR_UPDATE_INTERVAL) {
           Traffic_Update(&Container[i]);
+          Traffic_Rank_Update(i);
+        }
       } else {
         Container[i] = EmptyFO;
+        Traffic_Rank_Update(i);
       }
     }
 
@@ -246,6 +277,7 @@ void ClearExpired()
   for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
     if (Container[i].addr && (ThisAircraft.timestamp - Container[i].timestamp) > ENTRY_EXPIRATION_TIME) {
       Container[i] = EmptyFO;
+      Traffic_Rank_Update(i);
     }
   }
 }
@@ -263,6 +295,61 @@ int Traffic_Count()
   return count;
 }
 
+static inline bool traffic_rank_above(ufo_t *fop, float distance,
+                                      traffic_by_dist_t *tp)
+{
+  if (fop->alarm_level != tp->fop->alarm_level) {
+    return fop->alarm_level > tp->fop->alarm_level;
+  }
+
+  return distance < tp->distance;
+}
+
+/* has to be called every time when Container[ndx] is written or cleared */
+void Traffic_Rank_Update(int ndx)
+{
+  ufo_t *fop = &Container[ndx];
+  int pos;
+
+  for (pos = 0; pos < traffic_ranked; pos++) {
+    if (traffic_rank[pos].fop == fop) {
+      traffic_ranked--;
+      memmove(&traffic_rank[pos], &traffic_rank[pos + 1],
+              (traffic_ranked - pos) * sizeof(traffic_by_dist_t));
+      break;
+    }
+  }
+
+  if (fop->addr == 0) {
+    return;
+  }
+
+  for (pos = traffic_ranked;
+       pos > 0 && traffic_rank_above(fop, fop->distance, &traffic_rank[pos - 1]);
+       pos--) {
+    traffic_rank[pos] = traffic_rank[pos - 1];
+  }
+
+  traffic_rank[pos].fop      = fop;
+  traffic_rank[pos].distance = fop->distance;
+  traffic_ranked++;
+}
+
+/* copies up to 'max' most important entries that are not older than 'age' */
+int Traffic_Ranked(traffic_by_dist_t *list, int max, time_t age)
+{
+  time_t timestamp = now();
+  int j = 0;
+
+  for (int i = 0; i < traffic_ranked && j < max; i++) {
+    if (timestamp - traffic_rank[i].fop->timestamp <= age) {
+      list[j++] = traffic_rank[i];
+    }
+  }
+
+  return j;
+}
+
 int traffic_cmp_by_distance(const void *a, const void *b)
 {
   traffic_by_dist_t *ta = (traffic_by_dist_t *)a;
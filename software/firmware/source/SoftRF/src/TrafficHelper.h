@@ -52,8 +52,12 @@ void Traffic_setup(void);
 void Traffic_loop(void);
 void ClearExpired(void);
 void Traffic_Update(ufo_t *);
+void Traffic_Add(ufo_t *);
 int  Traffic_Count(void);
 
+void Traffic_Rank_Update(int);
+int  Traffic_Ranked(traffic_by_dist_t *, int, time_t);
+
 int  traffic_cmp_by_distance(const void *, const void *);
 
 extern ufo_t fo, Container[MAX_TRACKING_OBJECTS], EmptyFO;
@@ -40,6 +40,8 @@ void Baro_loop()     {}
 
 #include <TinyGPS++.h>
 
+#include "GNSS.h"
+
 barochip_ops_t *baro_chip = NULL;
 
 #if !defined(EXCLUDE_BMP180)
@@ -56,17 +58,124 @@ MS5x ms5611(&Wire);
 #endif /* EXCLUDE_MS5611 */
 
 static unsigned long BaroTimeMarker = 0;
-static float prev_pressure_altitude = 0;
 
-// increasing the averaging factor to average more data from sensor form 4 to 10
-#define VS_AVERAGING_FACTOR   10
-static float Baro_VS[VS_AVERAGING_FACTOR];
-static int avg_ndx = 0;
+/*
+ * Alpha-beta filter over altitude and climb rate, that is the steady
+ * state form of a constant velocity Kalman filter. Gains are derived
+ * once from the noise figures, the per sample update is integer only.
+ */
+static int32_t  Baro_Alt_mm  = 0;     /* filtered pressure altitude */
+static int32_t  Baro_VS_mms  = 0;     /* filtered climb rate */
+static bool     Baro_Valid   = false; /* the filter has been started */
+static unsigned long Baro_Sample_ms = 0;  /* time of last sample */
+
+/* gains for 1 ... BARO_GAIN_STEPS sample intervals between two samples */
+static uint32_t Baro_Alpha[BARO_GAIN_STEPS];  /* Q16 */
+static uint32_t Baro_Beta [BARO_GAIN_STEPS];  /* Q16, per second */
+
+static unsigned long Baro_GNSS_Commit = 0;
+static int32_t       Baro_GNSS_Alt_mm = 0;
+
+/* sensor readings on a fixed 20 Hz grid */
+#define isTimeToBaro() ((millis() - BaroTimeMarker) >= BARO_SAMPLE_INTERVAL)
 
-/* 4 baro sensor readings per second */
-#define isTimeToBaro() ((millis() - BaroTimeMarker) > (1000 / VS_AVERAGING_FACTOR))
+#if !defined(EXCLUDE_BMP180) || !defined(EXCLUDE_MPL3115A2)
+static void baro_write8(uint8_t addr, uint8_t reg, uint8_t data)
+{
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  Wire.write(data);
+  Wire.endTransmission();
+}
+
+static bool baro_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  Wire.endTransmission(false);
+
+  if (Wire.requestFrom(addr, len) != len) {
+    return false;
+  }
+
+  while (len--) {
+    *buf++ = Wire.read();
+  }
+
+  return true;
+}
+#endif /* EXCLUDE_BMP180 && EXCLUDE_MPL3115A2 */
 
 #if !defined(EXCLUDE_BMP180)
+
+/*
+ * The library waits for every conversion with delay(), that is 5 + 26 ms
+ * per sample in ULTRAHIGHRES mode. Conversions are started here and read
+ * out on a later pass of the loop instead, temperature once a second.
+ */
+#define BMP180_OSS            BMP085_ULTRAHIGHRES /* as bmp180.begin() sets */
+#define BMP180_TEMP_TIME      5     /* ms */
+#define BMP180_PRES_TIME      26    /* ms */
+#define BMP180_TEMP_INTERVAL  1000  /* ms */
+
+enum
+{
+  BMP180_IDLE,
+  BMP180_TEMP,
+  BMP180_PRES
+};
+
+static struct {
+  int16_t  ac1, ac2, ac3;
+  uint16_t ac4, ac5, ac6;
+  int16_t  b1, b2, mb, mc, md;
+} bmp180_cal;
+
+static uint8_t       bmp180_state = BMP180_IDLE;
+static unsigned long bmp180_start = 0;
+static unsigned long bmp180_temp_ms = 0;
+static int32_t       bmp180_B5 = 0;
+
+static void bmp180_convert(uint8_t state)
+{
+  baro_write8(BMP085_I2CADDR, BMP085_CONTROL,
+              state == BMP180_TEMP ? BMP085_READTEMPCMD :
+              BMP085_READPRESSURECMD + (BMP180_OSS << 6));
+  bmp180_state = state;
+  bmp180_start = millis();
+}
+
+/* compensation as per the datasheet, same as Adafruit_BMP085::readPressure() */
+static int32_t bmp180_pressure(int32_t UP)
+{
+  int32_t  B3, B6, X1, X2, X3, p;
+  uint32_t B4, B7;
+
+  B6 = bmp180_B5 - 4000;
+  X1 = ((int32_t) bmp180_cal.b2 * ((B6 * B6) >> 12)) >> 11;
+  X2 = ((int32_t) bmp180_cal.ac2 * B6) >> 11;
+  X3 = X1 + X2;
+  B3 = ((((int32_t) bmp180_cal.ac1 * 4 + X3) << BMP180_OSS) + 2) / 4;
+
+  X1 = ((int32_t) bmp180_cal.ac3 * B6) >> 13;
+  X2 = ((int32_t) bmp180_cal.b1 * ((B6 * B6) >> 12)) >> 16;
+  X3 = ((X1 + X2) + 2) >> 2;
+  B4 = ((uint32_t) bmp180_cal.ac4 * (uint32_t) (X3 + 32768)) >> 15;
+  B7 = ((uint32_t) UP - B3) * (uint32_t) (50000UL >> BMP180_OSS);
+
+  if (B7 < 0x80000000) {
+    p = (B7 * 2) / B4;
+  } else {
+    p = (B7 / B4) * 2;
+  }
+
+  X1 = (p >> 8) * (p >> 8);
+  X1 = (X1 * 3038) >> 16;
+  X2 = (-7357 * p) >> 16;
+
+  return p + ((X1 + X2 + (int32_t) 3791) >> 4);
+}
+
 static bool bmp180_probe()
 {
   return bmp180.begin();
@@ -102,11 +211,71 @@ static void bmp180_setup()
   
   Serial.println();
   delay(500);
+
+  uint8_t buf[22];
+  int16_t *cal = (int16_t *) &bmp180_cal;
+
+  /* AC1 ... MD, MSB first */
+  if (baro_read(BMP085_I2CADDR, BMP085_CAL_AC1, buf, sizeof(buf))) {
+    for (int i = 0; i < 11; i++) {
+      cal[i] = (int16_t) ((buf[2 * i] << 8) | buf[2 * i + 1]);
+    }
+  }
+
+  bmp180_state = BMP180_IDLE;
 }
 
+/* NAN - there is no new reading yet */
 static float bmp180_altitude(float sealevelPressure)
 {
-  return bmp180.readAltitude(sealevelPressure * 100);
+  uint8_t buf[3];
+  float altitude = NAN;
+
+  switch (bmp180_state)
+  {
+  case BMP180_TEMP:
+    if (millis() - bmp180_start < BMP180_TEMP_TIME) {
+      return NAN;
+    }
+    if (baro_read(BMP085_I2CADDR, BMP085_TEMPDATA, buf, 2)) {
+      int32_t UT = (buf[0] << 8) | buf[1];
+      int32_t X1 = (UT - (int32_t) bmp180_cal.ac6) *
+                   ((int32_t) bmp180_cal.ac5) >> 15;
+      int32_t X2 = ((int32_t) bmp180_cal.mc << 11) /
+                   (X1 + (int32_t) bmp180_cal.md);
+
+      bmp180_B5      = X1 + X2;
+      bmp180_temp_ms = bmp180_start;
+    }
+    bmp180_convert(BMP180_PRES);
+    return NAN;
+
+  case BMP180_PRES:
+    if (millis() - bmp180_start < BMP180_PRES_TIME) {
+      return NAN;
+    }
+    if (baro_read(BMP085_I2CADDR, BMP085_PRESSUREDATA, buf, 3)) {
+      int32_t UP = (((uint32_t) buf[0] << 16) | (buf[1] << 8) | buf[2]) >>
+                   (8 - BMP180_OSS);
+      float pressure = bmp180_pressure(UP);
+
+      altitude = 44330 * (1.0 - pow(pressure / (sealevelPressure * 100), 0.1903));
+    }
+    break;
+
+  case BMP180_IDLE:
+  default:
+    break;
+  }
+
+  if (bmp180_state == BMP180_IDLE ||
+      millis() - bmp180_temp_ms >= BMP180_TEMP_INTERVAL) {
+    bmp180_convert(BMP180_TEMP);
+  } else {
+    bmp180_convert(BMP180_PRES);
+  }
+
+  return altitude;
 }
 
 barochip_ops_t bmp180_ops = {
@@ -183,10 +352,56 @@ static void mpl3115a2_setup()
   delay(250);
 }
 
+/*
+ * getAltitude() polls for the end of conversion with delay(10), that is
+ * about 500 ms at OS128. A one-shot conversion is started here and
+ * picked up on a later pass of the loop instead. The status register
+ * is not read before the conversion time is over and then once a slot,
+ * the bus is shared with OLED and PMU.
+ */
+#define MPL3115A2_CONV_TIME   512   /* ms, OS128 */
+#define MPL3115A2_TIMEOUT     1000  /* ms, give up a conversion and start over */
+
+static bool          mpl3115a2_busy  = false;
+static unsigned long mpl3115a2_start = 0;
+static unsigned long mpl3115a2_wait  = 0;  /* ms, next status read */
+
+/* NAN - there is no new reading yet */
 static float mpl3115a2_altitude(float sealevelPressure)
 {
+  uint8_t buf[3];
+  float altitude = NAN;
+
+  if (mpl3115a2_busy) {
+    unsigned long elapsed = millis() - mpl3115a2_start;
+
+    if (elapsed < mpl3115a2_wait) {
+      return NAN;
+    }
+
+    if (!baro_read(MPL3115A2_ADDRESS, MPL3115A2_REGISTER_STATUS, buf, 1) ||
+        !(buf[0] & MPL3115A2_REGISTER_STATUS_PDR)) {
+      if (elapsed < MPL3115A2_TIMEOUT) {
+        mpl3115a2_wait = elapsed + BARO_SAMPLE_INTERVAL;
+        return NAN;
+      }
+    } else if (baro_read(MPL3115A2_ADDRESS, MPL3115A2_REGISTER_PRESSURE_MSB, buf, 3)) {
+      int32_t alt = ((uint32_t) buf[0] << 24) | ((uint32_t) buf[1] << 16) |
+                    ((uint32_t) buf[2] << 8);
+
+      altitude = alt / 65536.0;
+    }
+  }
+
   mpl3115a2.setSeaPressure(sealevelPressure * 100);
-  return mpl3115a2.getAltitude();
+  baro_write8(MPL3115A2_ADDRESS, MPL3115A2_CTRL_REG1,
+              MPL3115A2_CTRL_REG1_OS128 | MPL3115A2_CTRL_REG1_ALT |
+              MPL3115A2_CTRL_REG1_OST);
+  mpl3115a2_busy  = true;
+  mpl3115a2_start = millis();
+  mpl3115a2_wait  = MPL3115A2_CONV_TIME;
+
+  return altitude;
 }
 
 barochip_ops_t mpl3115a2_ops = {
@@ -218,7 +433,7 @@ static bool ms5611_probe()
 		return false;
   }
 	Serial.println(F("Connected to MS5611 Sensor"));
-	ms5611.setDelay(1000); // barometer will wait 250 ms before taking new temperature and pressure readings
+	ms5611.setDelay(BARO_SAMPLE_INTERVAL); // barometer will wait BARO_SAMPLE_INTERVAL ms before taking new temperature and pressure readings
 	return true;
 }
 
@@ -319,6 +534,57 @@ bool Baro_probe()
          );
 }
 
+/*
+ * Samples may come in later than on the next slot of the grid
+ * (BMP180 and MPL3115A2 conversions, a busy loop), so that the gains
+ * are tabulated for every whole number of intervals up to a second.
+ */
+static void Baro_Gains()
+{
+  for (int i = 0; i < BARO_GAIN_STEPS; i++) {
+    const float T = (i + 1) * BARO_SAMPLE_INTERVAL / 1000.0;
+
+    /* tracking index and optimal gains, Kalata 1984 */
+    float lambda = BARO_ACC_NOISE * T * T / BARO_ALT_NOISE;
+    float r      = (4 + lambda - sqrtf(8 * lambda + lambda * lambda)) / 4;
+    float alpha  = 1 - r * r;
+    float beta   = 2 * (2 - alpha) - 4 * sqrtf(1 - alpha);
+
+    Baro_Alpha[i] = (uint32_t) (alpha * 65536);
+    Baro_Beta [i] = (uint32_t) (beta / T * 65536);
+  }
+}
+
+/*
+ * GNSS altitude is coarse but free of baro drift,
+ * feed its rate of change in with a small weight on every new fix.
+ */
+static void Baro_GNSS_Blend()
+{
+  if (!isValidGNSSFix()) {
+    Baro_GNSS_Commit = 0;
+    return;
+  }
+
+  unsigned long commit = millis() - gnss.altitude.age();
+  unsigned long dt     = commit - Baro_GNSS_Commit;
+
+  if (dt < 500) {
+    return;
+  }
+
+  int32_t alt_mm = (int32_t) (gnss.altitude.meters() * 1000);
+
+  if (Baro_GNSS_Commit != 0 && dt <= 2000) {
+    int32_t gnss_vs_mms = (int32_t) ((alt_mm - Baro_GNSS_Alt_mm) * 1000L / (long) dt);
+
+    Baro_VS_mms += (gnss_vs_mms - Baro_VS_mms) >> BARO_GNSS_VS_SHIFT;
+  }
+
+  Baro_GNSS_Alt_mm = alt_mm;
+  Baro_GNSS_Commit = commit;
+}
+
 byte Baro_setup()
 {
   if ( SoC->Baro_setup() && Baro_probe() ) {
@@ -328,12 +594,11 @@ byte Baro_setup()
 
     baro_chip->setup();
 
-    prev_pressure_altitude = baro_chip->altitude(1013.25);
-    BaroTimeMarker = millis();
+    Baro_Gains();
 
-    for (int i=0; i<VS_AVERAGING_FACTOR; i++) {
-      Baro_VS[i] = 0;
-    }
+    /* the filter starts from the first reading */
+    Baro_Valid = false;
+    BaroTimeMarker = millis();
 
     return baro_chip->type;
 
@@ -349,31 +614,51 @@ void Baro_loop()
 {
   if (baro_chip && isTimeToBaro()) {
 
-    /* Draft of pressure altitude and vertical speed calculation */
-    ThisAircraft.pressure_altitude = baro_chip->altitude(1013.25);
-
-    Baro_VS[avg_ndx] = (ThisAircraft.pressure_altitude - prev_pressure_altitude) /
-      (millis() - BaroTimeMarker) * 1000;  /* in m/s */
+    float altitude = baro_chip->altitude(1013.25);
 
-    ThisAircraft.vs = 0;
-    for (int i=0; i<VS_AVERAGING_FACTOR; i++) {
-      ThisAircraft.vs += Baro_VS[i];
+    /* conversion is still in progress, look again on next pass */
+    if (isnan(altitude)) {
+      return;
     }
-    ThisAircraft.vs /= VS_AVERAGING_FACTOR;
 
-    if (ThisAircraft.vs > -0.1 && ThisAircraft.vs < 0.1) {
-      ThisAircraft.vs = 0;
+    unsigned long now   = millis();
+    unsigned long dt    = now - Baro_Sample_ms;
+    unsigned long steps = (dt + BARO_SAMPLE_INTERVAL / 2) / BARO_SAMPLE_INTERVAL;
+    int32_t z_mm = (int32_t) (altitude * 1000);
+
+    if (!Baro_Valid || steps > BARO_GAIN_STEPS) {
+      /* first reading or sampling has stalled, restart the filter */
+      Baro_Alt_mm = z_mm;
+      Baro_VS_mms = 0;
+      Baro_Valid  = true;
+    } else {
+      if (steps == 0) {
+        steps = 1;
+      }
+
+      /* predict */
+      Baro_Alt_mm += (int32_t) (Baro_VS_mms * (long) dt / 1000);
+
+      /* correct */
+      int32_t residual = z_mm - Baro_Alt_mm;
+      Baro_Alt_mm += (int32_t) (((int64_t) Baro_Alpha[steps - 1] * residual) >> 16);
+      Baro_VS_mms += (int32_t) (((int64_t) Baro_Beta [steps - 1] * residual) >> 16);
     }
 
-    ThisAircraft.vs *= (_GPS_FEET_PER_METER * 60.0) ; /* feet per minute */
+    Baro_Sample_ms = now;
 
-    prev_pressure_altitude = ThisAircraft.pressure_altitude;
-    BaroTimeMarker = millis();
-    avg_ndx = (avg_ndx + 1) % VS_AVERAGING_FACTOR;
+    Baro_GNSS_Blend();
+
+    ThisAircraft.pressure_altitude = Baro_Alt_mm / 1000.0;
+    ThisAircraft.vs = Baro_VS_mms / 1000.0 * (_GPS_FEET_PER_METER * 60.0); /* feet per minute */
+
+    /* keep the grid, skip missed slots rather than catch up */
+    unsigned long late = now - BaroTimeMarker;
+    BaroTimeMarker += late - (late % BARO_SAMPLE_INTERVAL);
 
 #if 0
     Serial.print(F("P.Alt. = ")); Serial.print(ThisAircraft.pressure_altitude);
-    Serial.print(F(" , VS avg. = ")); Serial.println(ThisAircraft.vs);
+    Serial.print(F(" , VS = ")); Serial.println(ThisAircraft.vs);
 #endif
   }
 }
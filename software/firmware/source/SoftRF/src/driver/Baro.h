@@ -21,6 +21,20 @@
 
 #define BMP280_ADDRESS_ALT  0x76 /* GY-91, SA0 is NC */
 
+#define BARO_SAMPLE_INTERVAL  50    /* ms, 20 Hz */
+/* filter gains are kept for up to this many intervals between samples */
+#define BARO_GAIN_STEPS       20
+
+/*
+ * Altitude and vario filter tuning: expected RMS noise of a single
+ * altitude sample and RMS of vertical acceleration of the aircraft
+ */
+#define BARO_ALT_NOISE        0.3   /* m */
+#define BARO_ACC_NOISE        1.0   /* m/s^2 */
+
+/* share of GNSS vertical rate blended into the vario, 1/16 per fix */
+#define BARO_GNSS_VS_SHIFT    4
+
 enum
 {
   BARO_MODULE_NONE,
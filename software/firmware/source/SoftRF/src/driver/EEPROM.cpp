@@ -17,13 +17,59 @@
  */
 
 #include "../system/SoC.h"
+#include "EEPROM.h"
+
+/* SETTINGS_CHANGED_* bits of what differs between two sets of settings */
+uint8_t EEPROM_changes(const settings_t *a, const settings_t *b)
+{
+  uint8_t rval = 0;
+
+  if (a->mode         != b->mode         ||
+      a->rf_protocol  != b->rf_protocol  ||
+      a->band         != b->band         ||
+      a->txpower      != b->txpower      ||
+      a->freq_corr    != b->freq_corr    ||
+      a->rx_protocols != b->rx_protocols) {
+    rval |= SETTINGS_CHANGED_RADIO;
+  }
+
+  if (a->alarm != b->alarm) {
+    rval |= SETTINGS_CHANGED_TRAFFIC;
+  }
+
+  if (a->nmea_g   != b->nmea_g   ||
+      a->nmea_p   != b->nmea_p   ||
+      a->nmea_l   != b->nmea_l   ||
+      a->nmea_s   != b->nmea_s   ||
+      a->nmea_out != b->nmea_out ||
+      a->gdl90    != b->gdl90    ||
+      a->d1090    != b->d1090    ||
+      a->json     != b->json) {
+    rval |= SETTINGS_CHANGED_DATA;
+  }
+
+  if (a->volume     != b->volume     ||
+      a->led_num    != b->led_num    ||
+      a->pointer    != b->pointer    ||
+      a->bluetooth  != b->bluetooth  ||
+      a->power_save != b->power_save) {
+    rval |= SETTINGS_CHANGED_UI;
+  }
+
+  if (a->aircraft_type != b->aircraft_type ||
+      a->stealth       != b->stealth       ||
+      a->no_track      != b->no_track) {
+    rval |= SETTINGS_CHANGED_ID;
+  }
+
+  return rval;
+}
 
 #if defined(EXCLUDE_EEPROM)
 void EEPROM_setup()    {}
 void EEPROM_store()    {}
 #else
 
-#include "EEPROM.h"
 #include "RF.h"
 #include "LED.h"
 #include "Sound.h"
@@ -40,22 +86,81 @@ void EEPROM_store()    {}
 eeprom_t eeprom_block;
 settings_t *settings;
 
+static uint16_t   eeprom_seq   = 0;  /* of the newest valid record */
+static uint8_t    eeprom_slot  = EEPROM_JOURNAL_SLOTS - 1;
+static bool       eeprom_valid = false; /* eeprom_stored is what is in flash */
+static bool       eeprom_journal = false; /* header of the journal is in flash */
+static settings_t eeprom_stored;
+
+static void EEPROM_read_bytes(size_t addr, void *buf, size_t size)
+{
+  uint8_t *p = (uint8_t *) buf;
+
+  for (size_t i=0; i<size; i++) {
+    p[i] = EEPROM.read(addr + i);
+  }
+}
+
+static void EEPROM_write_bytes(size_t addr, const void *buf, size_t size)
+{
+  const uint8_t *p = (const uint8_t *) buf;
+
+  for (size_t i=0; i<size; i++) {
+    EEPROM.write(addr + i, p[i]);
+  }
+}
+
+/* records of another settings layout never pass */
+static uint16_t EEPROM_crc(const eeprom_record_t *record)
+{
+  uint32_t version = SOFTRF_EEPROM_VERSION;
+  uint16_t crc = 0xFFFF;
+  const uint8_t *p;
+
+  p = (const uint8_t *) &version;
+  for (size_t i=0; i<sizeof(version); i++) {
+    crc = update_crc_ccitt(crc, p[i]);
+  }
+
+  p = (const uint8_t *) record;
+  for (size_t i=0; i<offsetof(eeprom_record_t, crc); i++) {
+    crc = update_crc_ccitt(crc, p[i]);
+  }
+
+  return crc;
+}
+
 void EEPROM_setup()
 {
-  if (!SoC->EEPROM_begin(sizeof(eeprom_t)))
+  eeprom_record_t record;
+  bool found = false;
+
+  if (!SoC->EEPROM_begin(EEPROM_JOURNAL_SIZE))
   {
     Serial.print(F("ERROR: Failed to initialize "));
-    Serial.print(sizeof(eeprom_t));
+    Serial.print(EEPROM_JOURNAL_SIZE);
     Serial.println(F(" bytes of EEPROM!"));
     Serial.flush();
     delay(1000000);
   }
 
-  for (int i=0; i<sizeof(eeprom_t); i++) {
-    eeprom_block.raw[i] = EEPROM.read(i);  
+  EEPROM_read_bytes(0, eeprom_block.raw, EEPROM_HEADER_SIZE);
+
+  /* the newest record, even when the header is gone: next one goes after it */
+  for (uint8_t i=0; i<EEPROM_JOURNAL_SLOTS; i++) {
+    EEPROM_read_bytes(EEPROM_RECORD_ADDR(i), &record, sizeof(record));
+
+    if (record.crc == EEPROM_crc(&record) &&
+        (!found || (int16_t) (record.seq - eeprom_seq) > 0)) {
+      eeprom_block.field.settings = record.settings;
+      eeprom_seq  = record.seq;
+      eeprom_slot = i;
+      found       = true;
+    }
   }
 
-  if (eeprom_block.field.magic != SOFTRF_EEPROM_MAGIC) {
+  if (eeprom_block.field.magic != SOFTRF_EEPROM_MAGIC &&
+      eeprom_block.field.magic != SOFTRF_JOURNAL_MAGIC) {
     Serial.println(F("WARNING! User defined settings are not initialized yet. Loading defaults..."));
 
     EEPROM_defaults();
@@ -66,6 +171,22 @@ void EEPROM_setup()
     if (eeprom_block.field.version != SOFTRF_EEPROM_VERSION) {
       Serial.println(F("WARNING! Version mismatch of user defined settings. Loading defaults..."));
 
+      EEPROM_defaults();
+    } else if (found) {
+      eeprom_stored  = eeprom_block.field.settings;
+      eeprom_valid   = true;
+      eeprom_journal = (eeprom_block.field.magic == SOFTRF_JOURNAL_MAGIC);
+    } else if (eeprom_block.field.magic == SOFTRF_EEPROM_MAGIC) {
+      /* single block, as it has been stored before the journal */
+      EEPROM_read_bytes(EEPROM_RECORD_ADDR(0), &eeprom_block.field.settings,
+                        sizeof(settings_t));
+      eeprom_slot = 0;
+
+      eeprom_stored = eeprom_block.field.settings;
+      eeprom_valid  = true;
+    } else {
+      Serial.println(F("WARNING! No valid record of user defined settings. Loading defaults..."));
+
       EEPROM_defaults();
     }
   }
@@ -112,15 +233,43 @@ void EEPROM_defaults()
   eeprom_block.field.settings.no_track   = false;
   eeprom_block.field.settings.power_save = POWER_SAVE_NONE;
   eeprom_block.field.settings.freq_corr  = 0;
+  eeprom_block.field.settings.rx_protocols = 0;
 }
 
+/* appends the settings into the journal, if there is anything new in them */
 void EEPROM_store()
 {
-  for (int i=0; i<sizeof(eeprom_t); i++) {
-    EEPROM.write(i, eeprom_block.raw[i]);  
+  eeprom_record_t record;
+
+  if (eeprom_valid &&
+      memcmp(&eeprom_stored, settings, sizeof(settings_t)) == 0) {
+    return;
   }
 
+  record.settings = *settings;
+  record.seq      = ++eeprom_seq;
+  record.crc      = EEPROM_crc(&record);
+
+  eeprom_slot = (eeprom_slot + 1) % EEPROM_JOURNAL_SLOTS;
+
+  EEPROM_write_bytes(EEPROM_RECORD_ADDR(eeprom_slot), &record, sizeof(record));
+
   EEPROM_commit();
+
+  /* a torn first record leaves no header that could vouch for it */
+  if (!eeprom_journal) {
+    eeprom_block.field.magic   = SOFTRF_JOURNAL_MAGIC;
+    eeprom_block.field.version = SOFTRF_EEPROM_VERSION;
+
+    EEPROM_write_bytes(0, eeprom_block.raw, EEPROM_HEADER_SIZE);
+
+    EEPROM_commit();
+
+    eeprom_journal = true;
+  }
+
+  eeprom_stored = *settings;
+  eeprom_valid  = true;
 }
 
 #endif /* EXCLUDE_EEPROM */
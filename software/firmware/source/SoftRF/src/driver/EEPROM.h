@@ -29,7 +29,8 @@
 #endif /* CC13XX or CC13X2 */
 #endif /* EXCLUDE_EEPROM */
 
-#define SOFTRF_EEPROM_MAGIC   0xBABADEDA
+#define SOFTRF_EEPROM_MAGIC   0xBABADEDA /* single block layout */
+#define SOFTRF_JOURNAL_MAGIC  0xBABADEDB /* journal layout */
 #define SOFTRF_EEPROM_VERSION 0x0000005F
 
 typedef struct Settings {
@@ -61,7 +62,7 @@ typedef struct Settings {
     uint8_t  power_save;
     int8_t   freq_corr; /* +/-, kHz */
     uint8_t  resvd23456;
-    uint8_t  resvd7;
+    uint8_t  rx_protocols; /* bitmask of extra protocols to time-slice Rx with */
     uint8_t  resvd8;
     uint8_t  resvd9;
     uint8_t  resvd10;
@@ -84,9 +85,40 @@ typedef union EEPROM_U {
    uint8_t raw[sizeof(eeprom_struct_t)];
 } eeprom_t;
 
+/*
+ * Settings are kept as a journal: magic and version, then a ring
+ * of records. A change is appended into the next slot and the valid record
+ * with the highest sequence number wins, so that a write that has been cut
+ * short leaves the previous settings in place. The journal magic goes in
+ * only after the first record has been committed. Slot 0 is where the
+ * settings of the single block layout were, these are taken as they are
+ * only under the magic of that layout, when the ring is empty.
+ */
+#if !defined(EEPROM_JOURNAL_SLOTS)
+#define EEPROM_JOURNAL_SLOTS  8
+#endif
+
+#define EEPROM_HEADER_SIZE    (2 * sizeof(uint32_t))
+#define EEPROM_RECORD_ADDR(n) (EEPROM_HEADER_SIZE + (n) * sizeof(eeprom_record_t))
+#define EEPROM_JOURNAL_SIZE   EEPROM_RECORD_ADDR(EEPROM_JOURNAL_SLOTS)
+
+typedef struct EEPROM_R {
+    settings_t settings;
+    uint16_t   seq;
+    uint16_t   crc;  /* CCITT of the version and the above */
+} __attribute__((packed)) eeprom_record_t;
+
+/* what a subsystem has to be set up again for, EEPROM_changes() */
+#define SETTINGS_CHANGED_RADIO    (1 << 0) /* mode, protocols, band, power */
+#define SETTINGS_CHANGED_TRAFFIC  (1 << 1) /* alarm method */
+#define SETTINGS_CHANGED_DATA     (1 << 2) /* NMEA, GDL90, D1090, JSON */
+#define SETTINGS_CHANGED_UI       (1 << 3) /* sound, LED, Bluetooth, power */
+#define SETTINGS_CHANGED_ID       (1 << 4) /* aircraft type, privacy */
+
 void EEPROM_setup(void);
 void EEPROM_defaults(void);
 void EEPROM_store(void);
+uint8_t EEPROM_changes(const settings_t *, const settings_t *);
 extern settings_t *settings;
 
 #endif /* EEPROMHELPER_H */
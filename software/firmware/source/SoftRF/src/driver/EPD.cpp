@@ -24,6 +24,7 @@
 #include "LED.h"
 #include "RF.h"
 #include "Baro.h"
+#include "../system/Profile.h"
 
 #include <Fonts/FreeMonoBold24pt7b.h>
 #include <Fonts/FreeMonoBold18pt7b.h>
@@ -46,6 +47,20 @@ bool EPD_vmode_updated = true;
 
 volatile bool EPD_ready_to_display = false;
 
+epd_stats_t EPD_stats = { 0, 0, 0, 0, 0 };
+
+#if defined(RASPBERRY_PI)
+static pthread_mutex_t EPD_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  EPD_cond  = PTHREAD_COND_INITIALIZER;
+#else
+static TaskHandle_t EPD_Task_Self = NULL;
+#endif /* RASPBERRY_PI */
+
+static epd_window_t EPD_windows[EPD_MAX_WINDOWS];
+static int  EPD_windows_count   = 0;
+static bool EPD_windows_valid   = false;
+static int  EPD_partial_updates = 0;
+
 void EPD_Clear_Screen()
 {
   while (EPD_ready_to_display) delay(100);
@@ -203,6 +218,13 @@ void EPD_loop()
   case DISPLAY_EPD_1_54:
 
     if (isTimeToEPD()) {
+      PROFILE_SCOPE(PROFILE_DISPLAY);
+
+      /* the panel is still busy with previous frame - skip this one */
+      if (EPD_ready_to_display) {
+        EPD_stats.dropped++;
+      }
+
       switch (EPD_view_mode)
       {
       case VIEW_MODE_RADAR:
@@ -243,6 +265,11 @@ void EPD_fini(int reason)
     while (EPD_ready_to_display) delay(100);
 
     EPD_HIBERNATE;
+
+    Serial.print(F("EPD frames: "));      Serial.print((unsigned long) EPD_stats.frames);
+    Serial.print(F(" windows: "));        Serial.print((unsigned long) EPD_stats.windows);
+    Serial.print(F(" dropped: "));        Serial.print((unsigned long) EPD_stats.dropped);
+    Serial.print(F(" max refresh ms: ")); Serial.println((unsigned long) EPD_stats.refresh_max_ms);
     break;
 
   case DISPLAY_NONE:
@@ -352,26 +379,233 @@ void EPD_Message(const char *msg1, const char *msg2)
     }
 
     /* a signal to background EPD update task */
-    EPD_ready_to_display = true;
+    EPD_Post();
+  }
+}
+
+/*
+ * A view that keeps a retained scene calls EPD_Damage_Begin() prior to
+ * drawing and then reports every screen area that differs from previous frame.
+ * Any other view leaves the damage list invalid and gets a full frame update.
+ */
+void EPD_Damage_Begin()
+{
+  EPD_windows_count = 0;
+  EPD_windows_valid = true;
+}
+
+static bool EPD_Window_Touches(epd_window_t *a, epd_window_t *b)
+{
+  return (a->x <= b->x + b->w + EPD_WINDOW_MERGE_GAP &&
+          b->x <= a->x + a->w + EPD_WINDOW_MERGE_GAP &&
+          a->y <= b->y + b->h + EPD_WINDOW_MERGE_GAP &&
+          b->y <= a->y + a->h + EPD_WINDOW_MERGE_GAP);
+}
+
+static void EPD_Window_Merge(epd_window_t *dst, epd_window_t *src)
+{
+  int16_t x2 = maxof2(dst->x + dst->w, src->x + src->w);
+  int16_t y2 = maxof2(dst->y + dst->h, src->y + src->h);
+
+  dst->x = dst->x < src->x ? dst->x : src->x;
+  dst->y = dst->y < src->y ? dst->y : src->y;
+  dst->w = x2 - dst->x;
+  dst->h = y2 - dst->y;
+}
+
+static int32_t EPD_Window_Merge_Cost(epd_window_t *a, epd_window_t *b)
+{
+  epd_window_t u = *a;
+
+  EPD_Window_Merge(&u, b);
+
+  return (int32_t) u.w * u.h - (int32_t) a->w * a->h - (int32_t) b->w * b->h;
+}
+
+void EPD_Damage(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  epd_window_t win;
+
+  if (!EPD_windows_valid) {
+    return;
+  }
+
+  /* clip to the screen */
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > display->width())  { w = display->width()  - x; }
+  if (y + h > display->height()) { h = display->height() - y; }
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  win.x = x; win.y = y; win.w = w; win.h = h;
+
+  /* absorb every window which touches the new one */
+  for (int i = 0; i < EPD_windows_count; ) {
+    if (EPD_Window_Touches(&EPD_windows[i], &win)) {
+      EPD_Window_Merge(&win, &EPD_windows[i]);
+      EPD_windows[i] = EPD_windows[--EPD_windows_count];
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+
+  if (EPD_windows_count < EPD_MAX_WINDOWS) {
+    EPD_windows[EPD_windows_count++] = win;
+  } else {
+    /* no free slot - grow the window that costs the least extra area */
+    int best = 0;
+    int32_t best_cost = EPD_Window_Merge_Cost(&EPD_windows[0], &win);
+
+    for (int i = 1; i < EPD_windows_count; i++) {
+      int32_t cost = EPD_Window_Merge_Cost(&EPD_windows[i], &win);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = i;
+      }
+    }
+    EPD_Window_Merge(&EPD_windows[best], &win);
+  }
+}
+
+static bool EPD_Glyph_Equal(const epd_glyph_t *a, const epd_glyph_t *b)
+{
+  return (a->type == b->type && a->key == b->key &&
+          a->x    == b->x    && a->y   == b->y   &&
+          a->w    == b->w    && a->h   == b->h);
+}
+
+static bool EPD_Glyph_Found(const epd_glyph_t *glyph,
+                            const epd_glyph_t *scene, int count)
+{
+  for (int i = 0; i < count; i++) {
+    if (EPD_Glyph_Equal(glyph, &scene[i])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/* damage every glyph which has appeared, moved, changed or gone */
+void EPD_Damage_Scene(const epd_glyph_t *prev, int prev_count,
+                      const epd_glyph_t *curr, int curr_count)
+{
+  for (int i = 0; i < prev_count; i++) {
+    if (!EPD_Glyph_Found(&prev[i], curr, curr_count)) {
+      EPD_Damage(prev[i].x, prev[i].y, prev[i].w, prev[i].h);
+    }
+  }
+
+  for (int i = 0; i < curr_count; i++) {
+    if (!EPD_Glyph_Found(&curr[i], prev, prev_count)) {
+      EPD_Damage(curr[i].x, curr[i].y, curr[i].w, curr[i].h);
+    }
   }
 }
 
+static void EPD_Refresh()
+{
+  /* a full refresh every now and then clears ghosting of partial updates */
+  bool full_refresh = !EPD_windows_valid ||
+                      EPD_partial_updates >= EPD_FULL_REFRESH_CYCLES;
+  bool full_frame   = full_refresh;
+
+  if (!full_frame) {
+    int32_t area = 0;
+
+    for (int i = 0; i < EPD_windows_count; i++) {
+      area += (int32_t) EPD_windows[i].w * EPD_windows[i].h;
+    }
+
+    full_frame = (area * 100 >  (int32_t) display->width() *
+                  display->height() * EPD_WINDOW_MAX_AREA);
+  }
+
+  if (full_frame) {
+
+    /* windows cover too much area - one partial update of the whole frame */
+    display->display(!full_refresh);
+
+    yield();
+
+    EPD_POWEROFF;
+
+    EPD_partial_updates = full_refresh ? 0 : EPD_partial_updates + 1;
+    EPD_stats.frames++;
+
+  } else if (EPD_windows_count > 0) {
+
+    for (int i = 0; i < EPD_windows_count; i++) {
+      display->displayWindow(EPD_windows[i].x, EPD_windows[i].y,
+                             EPD_windows[i].w, EPD_windows[i].h);
+      yield();
+    }
+
+    EPD_POWEROFF;
+
+    EPD_partial_updates++;
+    EPD_stats.windows += EPD_windows_count;
+    EPD_stats.frames++;
+  }
+
+  EPD_windows_valid = false;
+}
+
+/* hand the frame buffer over to background EPD update task */
+void EPD_Post()
+{
+#if defined(RASPBERRY_PI)
+  pthread_mutex_lock(&EPD_mutex);
+  EPD_ready_to_display = true;
+  pthread_cond_signal(&EPD_cond);
+  pthread_mutex_unlock(&EPD_mutex);
+#else
+  EPD_ready_to_display = true;
+  if (EPD_Task_Self != NULL) {
+    xTaskNotifyGive(EPD_Task_Self);
+  }
+#endif /* RASPBERRY_PI */
+}
+
+/* sleep until a view posts a new frame */
+static void EPD_Wait()
+{
+#if defined(RASPBERRY_PI)
+  pthread_mutex_lock(&EPD_mutex);
+  while (!EPD_ready_to_display) {
+    pthread_cond_wait(&EPD_cond, &EPD_mutex);
+  }
+  pthread_mutex_unlock(&EPD_mutex);
+#else
+  while (!EPD_ready_to_display) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+#endif /* RASPBERRY_PI */
+}
+
 EPD_Task_t EPD_Task( void * pvParameters )
 {
+#if !defined(RASPBERRY_PI)
+  EPD_Task_Self = xTaskGetCurrentTaskHandle();
+#endif /* RASPBERRY_PI */
+
   for( ;; )
   {
-    if (EPD_ready_to_display) {
+    EPD_Wait();
 
-      display->display(true);
+    unsigned long start_ms = millis();
 
-      yield();
+    EPD_Refresh();
 
-      EPD_POWEROFF;
-
-      EPD_ready_to_display = false;
+    EPD_stats.refresh_ms = millis() - start_ms;
+    if (EPD_stats.refresh_ms > EPD_stats.refresh_max_ms) {
+      EPD_stats.refresh_max_ms = EPD_stats.refresh_ms;
     }
 
-    yield();
+    EPD_ready_to_display = false;
   }
 }
 
@@ -49,6 +49,11 @@
 
 #define EPD_POWEROFF            display->powerOff()
 
+#define EPD_MAX_WINDOWS         4
+#define EPD_WINDOW_MERGE_GAP    8      /* pixels */
+#define EPD_WINDOW_MAX_AREA     50     /* % of screen, full frame update above */
+#define EPD_FULL_REFRESH_CYCLES 30     /* window updates between full frames */
+
 enum
 {
 	VIEW_MODE_STATUS,
@@ -150,6 +155,40 @@ typedef struct navbox_struct
   uint32_t  timestamp;
 } navbox_t;
 
+typedef struct epd_window_struct
+{
+  int16_t   x;
+  int16_t   y;
+  int16_t   w;
+  int16_t   h;
+} epd_window_t;
+
+enum
+{
+	EPD_GLYPH_TARGET,
+	EPD_GLYPH_LABEL
+};
+
+typedef struct epd_stats_struct
+{
+  uint32_t  frames;         /* pushed onto the panel */
+  uint32_t  windows;        /* partial window updates */
+  uint32_t  dropped;        /* coalesced while the panel was busy */
+  uint32_t  refresh_ms;     /* duration of most recent update */
+  uint32_t  refresh_max_ms;
+} epd_stats_t;
+
+/* an element of retained scene, identified by its type, key and placement */
+typedef struct epd_glyph_struct
+{
+  uint8_t   type;
+  int32_t   key;
+  int16_t   x;
+  int16_t   y;
+  int16_t   w;
+  int16_t   h;
+} epd_glyph_t;
+
 void EPD_Clear_Screen();
 bool EPD_setup(bool);
 void EPD_loop();
@@ -160,8 +199,13 @@ void EPD_Mode();
 void EPD_Up();
 void EPD_Down();
 void EPD_Message(const char *, const char *);
+void EPD_Post();
 EPD_Task_t EPD_Task(void *);
 
+void EPD_Damage_Begin();
+void EPD_Damage(int16_t, int16_t, int16_t, int16_t);
+void EPD_Damage_Scene(const epd_glyph_t *, int, const epd_glyph_t *, int);
+
 void EPD_status_setup();
 void EPD_status_loop();
 void EPD_status_next();
@@ -185,5 +229,6 @@ void EPD_time_prev();
 extern unsigned long EPDTimeMarker;
 extern bool EPD_vmode_updated;
 extern volatile bool EPD_ready_to_display;
+extern epd_stats_t EPD_stats;
 
 #endif /* EPDHELPER_H */
@@ -77,6 +77,7 @@ const char *GNSS_name[] = {
 #include "LED.h"
 #include "../protocol/data/GDL90.h"
 #include "../protocol/data/D1090.h"
+#include "../system/Recorder.h"
 
 TinyGPSCustom C_Version      (gnss, "PSRFC", 1);
 TinyGPSCustom C_Mode         (gnss, "PSRFC", 2);
@@ -204,6 +205,14 @@ const uint8_t setVTG[] PROGMEM = {0xF0, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01
 #if !defined(NMEA_TCP_SERVICE)
 const uint8_t setGSA[] PROGMEM = {0xF0, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
 #endif
+#if defined(USE_GNSS_UBX)
+const uint8_t setGGA[] PROGMEM = {0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+const uint8_t setRMC[] PROGMEM = {0xF0, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+ /* NAV-PVT on UART1 and USB, every navigation solution */
+const uint8_t setPVT[] PROGMEM = {0x01, 0x07, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00};
+ /* CFG-RATE: 200 ms (5 Hz), every measurement, GPS time */
+const uint8_t setRate[] PROGMEM = {0xC8, 0x00, 0x01, 0x00, 0x01, 0x00};
+#endif /* USE_GNSS_UBX */
  /* CFG-PRT */
 uint8_t setBR[] = {0x01, 0x00, 0x00, 0x00, 0xD0, 0x08, 0x00, 0x00, 0x00, 0x96,
                    0x00, 0x00, 0x07, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00};
@@ -405,6 +414,55 @@ static void setup_UBX()
 #endif
 }
 
+#if defined(USE_GNSS_UBX)
+/*
+ * Binary mode: fixes come in as UBX-NAV-PVT at 5 Hz, GGA and RMC are off.
+ * NAV-PVT is known to u-blox 7 (protocol 14) and newer.
+ * The configuration is not saved into flash of the module. A module that
+ * keeps it in battery backed RAM stays silent for NMEA probe at next start,
+ * ENABLE_UBLOX_RFS takes care of that.
+ */
+static bool setup_UBX_PVT()
+{
+  uint8_t msglen;
+
+  GNSS_DEBUG_PRINTLN(F("Switching on UBX NAV-PVT: "));
+
+  msglen = makeUBXCFG(0x06, 0x01, sizeof(setPVT), setPVT);
+  sendUBX(GNSSbuf, msglen);
+  gnss_set_sucess = getUBX_ACK(0x06, 0x01);
+
+  if (!gnss_set_sucess) {
+    GNSS_DEBUG_PRINTLN(F("WARNING: Unable to enable UBX NAV-PVT."));
+    return false;
+  }
+
+  msglen = makeUBXCFG(0x06, 0x08, sizeof(setRate), setRate);
+  sendUBX(GNSSbuf, msglen);
+  gnss_set_sucess = getUBX_ACK(0x06, 0x08);
+
+  if (!gnss_set_sucess) {
+    GNSS_DEBUG_PRINTLN(F("WARNING: Unable to set navigation rate."));
+  }
+
+  GNSS_DEBUG_PRINTLN(F("Switching off NMEA GGA and RMC: "));
+
+  msglen = makeUBXCFG(0x06, 0x01, sizeof(setGGA), setGGA);
+  sendUBX(GNSSbuf, msglen);
+  gnss_set_sucess = getUBX_ACK(0x06, 0x01);
+
+  msglen = makeUBXCFG(0x06, 0x01, sizeof(setRMC), setRMC);
+  sendUBX(GNSSbuf, msglen);
+  gnss_set_sucess = getUBX_ACK(0x06, 0x01) && gnss_set_sucess;
+
+  if (!gnss_set_sucess) {
+    GNSS_DEBUG_PRINTLN(F("WARNING: Unable to disable NMEA GGA or RMC."));
+  }
+
+  return true;
+}
+#endif /* USE_GNSS_UBX */
+
 /* ------ BEGIN -----------  https://github.com/Black-Thunder/FPV-Tracker */
 
 enum ubloxState{ WAIT_SYNC1, WAIT_SYNC2, GET_CLASS, GET_ID, GET_LL, GET_LH, GET_DATA, GET_CKA, GET_CKB };
@@ -502,6 +560,174 @@ static int ubloxProcessData(unsigned char data) {
 
 /* ------ END -----------  https://github.com/Black-Thunder/FPV-Tracker */
 
+#if defined(USE_GNSS_UBX)
+
+#define UBX_NAV_PVT_LEN     92  /* u-blox 8, u-blox 7 sends 84 bytes */
+#define UBX_NAV_PVT_MIN_LEN 84
+
+enum { UBX_SYNC1, UBX_SYNC2, UBX_CLASS, UBX_ID, UBX_LEN1, UBX_LEN2,
+       UBX_PAYLOAD, UBX_CKA, UBX_CKB };
+
+/* own state and buffer, GNSSbuf keeps the NMEA line being assembled */
+static struct {
+  uint8_t  state;
+  uint8_t  cls;
+  uint8_t  id;
+  uint16_t len;
+  uint16_t cnt;
+  uint8_t  ck_a;
+  uint8_t  ck_b;
+  uint8_t  payload[UBX_NAV_PVT_LEN];
+} ubx_rx;
+
+bool          GNSS_UBX_active = false;
+ubx_stats_t   GNSS_UBX_stats;
+uint32_t      GNSS_iTOW = 0;
+unsigned long GNSS_iTOW_Marker = 0;
+
+static inline uint16_t UBX_U2(const uint8_t *p)
+{
+  return (uint16_t) p[0] | ((uint16_t) p[1] << 8);
+}
+
+static inline uint32_t UBX_U4(const uint8_t *p)
+{
+  return (uint32_t) p[0]         | ((uint32_t) p[1] << 8) |
+        ((uint32_t) p[2] << 16)  | ((uint32_t) p[3] << 24);
+}
+
+#define UBX_I4(p)   ((int32_t) UBX_U4(p))
+
+/* fields are read in place, at the offsets of the NAV-PVT layout */
+static void UBX_NAV_PVT(const uint8_t *pvt)
+{
+  TinyGPSFix fix;
+  uint8_t valid    = pvt[11];
+  uint8_t fix_type = pvt[20];
+  uint8_t flags    = pvt[21];
+  int32_t nano     = UBX_I4(&pvt[16]);
+  int32_t height   = UBX_I4(&pvt[32]); /* mm, above ellipsoid */
+  int32_t hMSL     = UBX_I4(&pvt[36]); /* mm */
+
+  GNSS_iTOW        = UBX_U4(&pvt[0]);
+  GNSS_iTOW_Marker = millis();
+
+  fix.dateValid  = (valid & 0x01);
+  fix.timeValid  = (valid & 0x02);
+  /* 2D, 3D or GNSS + dead reckoning */
+  fix.hasFix     = (flags & 0x01) && fix_type >= 2 && fix_type <= 4;
+
+  fix.date       = pvt[7] * 10000UL + pvt[6] * 100UL + UBX_U2(&pvt[4]) % 100;
+  fix.time       = pvt[8] * 1000000UL + pvt[9] * 10000UL + pvt[10] * 100UL +
+                   (nano > 0 ? nano / 10000000L : 0);
+  fix.lng        = UBX_I4(&pvt[24]);
+  fix.lat        = UBX_I4(&pvt[28]);
+  fix.altitude   = hMSL / 10;
+  fix.separation = (height - hMSL) / 10;
+  fix.speed      = (int32_t) ((int64_t) UBX_I4(&pvt[60]) * 1944 / 10000);
+  fix.course     = UBX_I4(&pvt[64]) / 1000;
+  fix.hdop       = UBX_U2(&pvt[76]); /* PDOP, NAV-PVT has no HDOP */
+  fix.satellites = pvt[23];
+
+  gnss.commit(fix);
+  GNSS_UBX_stats.fixes++;
+
+#if defined(USE_NMEALIB)
+  static uint8_t last_sec = 0xFF;
+
+  /* NMEA output keeps its usual rate of 1 Hz */
+  if (settings->nmea_g && fix.hasFix && pvt[10] != last_sec) {
+    NMEA_GNSS();
+    last_sec = pvt[10];
+  }
+#endif /* USE_NMEALIB */
+}
+
+static void UBX_Process(uint8_t c)
+{
+  switch (ubx_rx.state)
+  {
+  case UBX_SYNC1:
+    if (c == 0xB5) {
+      ubx_rx.state = UBX_SYNC2;
+    }
+    break;
+  case UBX_SYNC2:
+    ubx_rx.state = (c == 0x62 ? UBX_CLASS : UBX_SYNC1);
+    break;
+  case UBX_CLASS:
+    ubx_rx.cls   = c;
+    ubx_rx.ck_a  = c;
+    ubx_rx.ck_b  = c;
+    ubx_rx.state = UBX_ID;
+    break;
+  case UBX_ID:
+    ubx_rx.id    = c;
+    ubx_rx.ck_a += c;
+    ubx_rx.ck_b += ubx_rx.ck_a;
+    ubx_rx.state = UBX_LEN1;
+    break;
+  case UBX_LEN1:
+    ubx_rx.len   = c;
+    ubx_rx.ck_a += c;
+    ubx_rx.ck_b += ubx_rx.ck_a;
+    ubx_rx.state = UBX_LEN2;
+    break;
+  case UBX_LEN2:
+    ubx_rx.len  |= (uint16_t) c << 8;
+    ubx_rx.ck_a += c;
+    ubx_rx.ck_b += ubx_rx.ck_a;
+    ubx_rx.cnt   = 0;
+    ubx_rx.state = ubx_rx.len ? UBX_PAYLOAD : UBX_CKA;
+    break;
+  case UBX_PAYLOAD:
+    ubx_rx.ck_a += c;
+    ubx_rx.ck_b += ubx_rx.ck_a;
+    /* only NAV-PVT is of interest, the rest is checksummed and dropped */
+    if (ubx_rx.cnt < sizeof(ubx_rx.payload)) {
+      ubx_rx.payload[ubx_rx.cnt] = c;
+    }
+    if (++ubx_rx.cnt == ubx_rx.len) {
+      ubx_rx.state = UBX_CKA;
+    }
+    break;
+  case UBX_CKA:
+    ubx_rx.state = (c == ubx_rx.ck_a ? UBX_CKB : UBX_SYNC1);
+    if (ubx_rx.state == UBX_SYNC1) {
+      GNSS_UBX_stats.errors++;
+    }
+    break;
+  case UBX_CKB:
+    ubx_rx.state = UBX_SYNC1;
+    if (c != ubx_rx.ck_b) {
+      GNSS_UBX_stats.errors++;
+    } else if (ubx_rx.cls == 0x01 && ubx_rx.id == 0x07 &&
+               ubx_rx.len >= UBX_NAV_PVT_MIN_LEN) {
+      UBX_NAV_PVT(ubx_rx.payload);
+    } else {
+      GNSS_UBX_stats.other++;
+    }
+    break;
+  }
+}
+
+static void UBX_loop()
+{
+  while (swSer.available() > 0) {
+    int c = swSer.read();
+
+    if (c == -1) {
+      break;
+    }
+
+    GNSS_UBX_stats.bytes++;
+
+    /* NMEA of the module is off, except for TXT, ignore what is left */
+    UBX_Process((uint8_t) c);
+  }
+}
+#endif /* USE_GNSS_UBX */
+
 static byte ublox_version() {
   byte rval = GNSS_MODULE_NMEA;
   unsigned long startTime = millis();
@@ -975,6 +1201,11 @@ byte GNSS_setup() {
     // Set the navigation mode (Airborne, 1G)
     // Turning off some GPS NMEA sentences on the uBlox modules
     ublox_ops.setup();
+#if defined(USE_GNSS_UBX)
+    if (gnss_id != GNSS_MODULE_U6) {
+      GNSS_UBX_active = setup_UBX_PVT();
+    }
+#endif /* USE_GNSS_UBX */
     break;
 #endif /* EXCLUDE_GNSS_UBLOX */
 #if !defined(EXCLUDE_GNSS_SONY)
@@ -1140,6 +1371,13 @@ void PickGNSSFix()
   int ndx;
   int c = -1;
 
+#if defined(USE_GNSS_UBX)
+  /* built-in GNSS input goes to UBX decoder, other sources remain NMEA */
+  if (GNSS_UBX_active) {
+    UBX_loop();
+  }
+#endif /* USE_GNSS_UBX */
+
   /*
    * Check SW/HW UARTs, USB and BT for data
    * WARNING! Make use only one input source at a time.
@@ -1287,6 +1525,16 @@ void PickGNSSFix()
             SoC->reset();
         } else if (strncmp(C_Version.value(), "OFF", 3) == 0) {
           shutdown(SOFTRF_SHUTDOWN_NMEA);
+#if defined(USE_RECORDER)
+        } else if (strncmp(C_Version.value(), "IGC", 3) == 0 ||
+                   strncmp(C_Version.value(), "CSV", 3) == 0) {
+          /* dump of flight recorder log may take a few seconds */
+          SoC->WDT_fini();
+          Recorder_Export(C_Version.value()[0] == 'I' ? RECORDER_EXPORT_IGC :
+                                                        RECORDER_EXPORT_CSV,
+                          C_NMEA_Source);
+          SoC->WDT_setup();
+#endif /* USE_RECORDER */
         } else if (strncmp(C_Version.value(), "?", 1) == 0) {
           char psrfc_buf[MAX_PSRFC_LEN];
 
@@ -56,6 +56,18 @@ typedef struct gnss_chip_ops_struct {
                            (gnss.altitude.age() <= NMEA_EXP_TIME) && \
                            (gnss.date.age()     <= NMEA_EXP_TIME))
 
+typedef struct ubx_stats_struct {
+  uint32_t bytes;
+  uint32_t fixes;   /* NAV-PVT */
+  uint32_t other;   /* UBX messages of no interest */
+  uint32_t errors;  /* bad checksum */
+} ubx_stats_t;
+
+extern bool          GNSS_UBX_active;
+extern ubx_stats_t   GNSS_UBX_stats;
+extern uint32_t      GNSS_iTOW;        /* ms, GPS time of week of last fix */
+extern unsigned long GNSS_iTOW_Marker; /* millis() when it has come in */
+
 byte GNSS_setup      (void);
 void GNSS_loop       (void);
 void GNSS_fini       (void);
@@ -23,6 +23,7 @@
 #include "LED.h"
 #include "Battery.h"
 #include "../TrafficHelper.h"
+#include "../system/Profile.h"
 
 static uint32_t prev_tx_packets_counter = 0;
 static uint32_t prev_rx_packets_counter = 0;
@@ -31,6 +32,20 @@ static uint32_t prev_rx_packets_counter = 0;
 static int status_LED = SOC_UNUSED_PIN;
 static unsigned long status_LED_TimeMarker = 0;
 
+#if !defined(EXCLUDE_LED_RING)
+/*
+ * Every frame is composed in LED_frame[] and goes out to the ring
+ * only when it differs from the one that is shown already, so that
+ * a steady picture does not hold the GNSS receiver off again and again.
+ */
+static color_t LED_frame      [PIX_NUM];
+static color_t LED_frame_shown[PIX_NUM];
+static bool    LED_frame_stale = true;
+
+/* ring LED number for every degree of bearing */
+static uint8_t LED_sector[360];
+#endif /* EXCLUDE_LED_RING */
+
 // IMPORTANT: To reduce NeoPixel burnout risk, add 1000 uF capacitor across
 // pixel power leads, add 300 - 500 Ohm resistor on first pixel's data input
 // and minimize distance between Arduino and first pixel.  Avoid connecting
@@ -41,6 +56,12 @@ void LED_setup() {
   if (SOC_GPIO_PIN_LED != SOC_UNUSED_PIN && settings->pointer != LED_OFF) {
     uni_begin();
     uni_show(); // Initialize all pixels to 'off'
+
+    for (int bearing = 0; bearing < 360; bearing++) {
+      LED_sector[bearing] = ((bearing + LED_ROTATE_ANGLE + SECTOR_PER_LED/2) % 360) /
+                            SECTOR_PER_LED;
+    }
+    LED_frame_stale = true;
   }
 #endif /* EXCLUDE_LED_RING */
 
@@ -98,6 +119,8 @@ void LED_test() {
     //  rainbowCycle(20);
     //  theaterChaseRainbow(50);
     colorWipe(uni_Color(0, 0, 0), 50); // clear
+
+    LED_frame_stale = true;
   }
 #endif /* EXCLUDE_LED_RING */
 }
@@ -105,38 +128,67 @@ void LED_test() {
 #if !defined(EXCLUDE_LED_RING)
 static void LED_Clear_noflush() {
     for (uint16_t i = 0; i < RING_LED_NUM; i++) {
-      uni_setPixelColor(i, LED_COLOR_BACKLIT);
+      LED_frame[i] = LED_COLOR_BACKLIT;
     }
 
     if (rx_packets_counter > prev_rx_packets_counter) {
-      uni_setPixelColor(LED_STATUS_RX, LED_COLOR_MI_GREEN);
+      LED_frame[LED_STATUS_RX] = LED_COLOR_MI_GREEN;
       prev_rx_packets_counter = rx_packets_counter;
 
       if (settings->mode == SOFTRF_MODE_WATCHOUT) {
         for (uint16_t i = 0; i < RING_LED_NUM; i++) {
-          uni_setPixelColor(i, LED_COLOR_RED);
+          LED_frame[i] = LED_COLOR_RED;
         }
       } else if (settings->mode == SOFTRF_MODE_BRIDGE) {
         for (uint16_t i = 0; i < RING_LED_NUM; i++) {
-          uni_setPixelColor(i, LED_COLOR_MI_RED);
+          LED_frame[i] = LED_COLOR_MI_RED;
         }
       }
 
     }  else {
-      uni_setPixelColor(LED_STATUS_RX, LED_COLOR_BLACK);
+      LED_frame[LED_STATUS_RX] = LED_COLOR_BLACK;
     }
 
     if (tx_packets_counter > prev_tx_packets_counter) {
-      uni_setPixelColor(LED_STATUS_TX, LED_COLOR_MI_GREEN);
+      LED_frame[LED_STATUS_TX] = LED_COLOR_MI_GREEN;
       prev_tx_packets_counter = tx_packets_counter;
     } else {
-      uni_setPixelColor(LED_STATUS_TX, LED_COLOR_BLACK);
+      LED_frame[LED_STATUS_TX] = LED_COLOR_BLACK;
     }
 
-    uni_setPixelColor(LED_STATUS_POWER,
-      Battery_voltage() > Battery_threshold() ? LED_COLOR_MI_GREEN : LED_COLOR_MI_RED);
-    uni_setPixelColor(LED_STATUS_SAT,
-      isValidFix() ? LED_COLOR_MI_GREEN : LED_COLOR_MI_RED);
+    LED_frame[LED_STATUS_POWER] =
+      Battery_voltage() > Battery_threshold() ? LED_COLOR_MI_GREEN : LED_COLOR_MI_RED;
+    LED_frame[LED_STATUS_SAT] =
+      isValidFix() ? LED_COLOR_MI_GREEN : LED_COLOR_MI_RED;
+}
+
+static void LED_Flush() {
+    uint16_t i;
+
+    for (i = 0; i < PIX_NUM; i++) {
+      if (LED_frame[i] != LED_frame_shown[i]) {
+        break;
+      }
+    }
+
+    if (i == PIX_NUM && !LED_frame_stale) {
+      return;
+    }
+
+    for (i = 0; i < PIX_NUM; i++) {
+      uni_setPixelColor(i, LED_frame[i]);
+      LED_frame_shown[i] = LED_frame[i];
+    }
+
+#if defined(LED_RING_ASYNC)
+    uni_show();
+#else
+    SoC->swSer_enableRx(false);
+    uni_show();
+    SoC->swSer_enableRx(true);
+#endif /* LED_RING_ASYNC */
+
+    LED_frame_stale = false;
 }
 #endif /* EXCLUDE_LED_RING */
 
@@ -144,10 +196,7 @@ void LED_Clear() {
 #if !defined(EXCLUDE_LED_RING)
   if (SOC_GPIO_PIN_LED != SOC_UNUSED_PIN && settings->pointer != LED_OFF) {
     LED_Clear_noflush();
-
-    SoC->swSer_enableRx(false);
-    uni_show();
-    SoC->swSer_enableRx(true);
+    LED_Flush();
   }
 #endif /* EXCLUDE_LED_RING */
 }
@@ -157,43 +206,43 @@ void LED_DisplayTraffic() {
   int bearing, distance;
   int led_num;
   color_t color;
+  traffic_by_dist_t list[MAX_TRACKING_OBJECTS];
 
   if (SOC_GPIO_PIN_LED != SOC_UNUSED_PIN && settings->pointer != LED_OFF) {
+    PROFILE_SCOPE(PROFILE_DISPLAY);
+
     LED_Clear_noflush();
 
-    for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    int j = Traffic_Ranked(list, MAX_TRACKING_OBJECTS, LED_EXPIRATION_TIME);
 
-      if (Container[i].addr && (now() - Container[i].timestamp) <= LED_EXPIRATION_TIME) {
+    /* least important one first, the most important one wins a shared LED */
+    for (int i = j - 1; i >= 0; i--) {
 
-        bearing  = (int) Container[i].bearing;
-        distance = (int) Container[i].distance;
+      bearing  = (int) list[i].fop->bearing % 360;
+      distance = (int) list[i].distance;
 
-        if (settings->pointer == DIRECTION_TRACK_UP) {
-          bearing = (360 + bearing - (int)ThisAircraft.course) % 360;
-        }
+      if (settings->pointer == DIRECTION_TRACK_UP) {
+        bearing = (360 + bearing - (int)ThisAircraft.course % 360) % 360;
+      }
 
-        led_num = ((bearing + LED_ROTATE_ANGLE + SECTOR_PER_LED/2) % 360) / SECTOR_PER_LED;
-//      Serial.print(bearing);
-//      Serial.print(" , ");
-//      Serial.println(led_num);
-//      Serial.println(distance);
-        if (distance < LED_DISTANCE_FAR) {
-          if (distance >= 0 && distance <= LED_DISTANCE_CLOSE) {
-            color =  LED_COLOR_RED;
-          } else if (distance > LED_DISTANCE_CLOSE && distance <= LED_DISTANCE_NEAR) {
-            color =  LED_COLOR_YELLOW;
-          } else if (distance > LED_DISTANCE_NEAR && distance <= LED_DISTANCE_FAR) {
-            color =  LED_COLOR_BLUE;
-          }
-          uni_setPixelColor(led_num, color);
+      led_num = LED_sector[bearing];
+//    Serial.print(bearing);
+//    Serial.print(" , ");
+//    Serial.println(led_num);
+//    Serial.println(distance);
+      if (distance < LED_DISTANCE_FAR) {
+        if (distance >= 0 && distance <= LED_DISTANCE_CLOSE) {
+          color =  LED_COLOR_RED;
+        } else if (distance > LED_DISTANCE_CLOSE && distance <= LED_DISTANCE_NEAR) {
+          color =  LED_COLOR_YELLOW;
+        } else if (distance > LED_DISTANCE_NEAR && distance <= LED_DISTANCE_FAR) {
+          color =  LED_COLOR_BLUE;
         }
+        LED_frame[led_num] = color;
       }
     }
 
-    SoC->swSer_enableRx(false);
-    uni_show();
-    SoC->swSer_enableRx(true);
-
+    LED_Flush();
   }
 #endif /* EXCLUDE_LED_RING */
 }
@@ -30,6 +30,7 @@
 #include "Baro.h"
 #include "Battery.h"
 #include "../TrafficHelper.h"
+#include "../system/Profile.h"
 
 enum
 {
@@ -578,6 +579,8 @@ void OLED_loop()
 {
   if (u8x8) {
     if (isTimeToOLED()) {
+      PROFILE_SCOPE(PROFILE_DISPLAY);
+
       switch (OLED_current_page)
       {
       case OLED_PAGE_OTHER:
@@ -32,6 +32,17 @@
 #include "../system/Log.h"
 #endif /* LOGGER_IS_ENABLED */
 
+#include "../system/Profile.h"
+#include "../system/Position.h"
+
+#if defined(USE_RELAY)
+#include "../system/Relay.h"
+#endif /* USE_RELAY */
+
+#if defined(USE_TICKLESS)
+#include "../system/Tickless.h"
+#endif /* USE_TICKLESS */
+
 byte RxBuffer[MAX_PKT_SIZE] __attribute__((aligned(sizeof(uint32_t))));
 
 unsigned long TxTimeMarker = 0;
@@ -41,6 +52,44 @@ uint32_t tx_packets_counter = 0;
 uint32_t rx_packets_counter = 0;
 
 int8_t RF_last_rssi = 0;
+uint8_t RF_last_protocol = RF_PROTOCOL_LEGACY;
+
+/*
+ * Single producer, single consumer queue of received frames.
+ * Drivers (or their RX callbacks) append at the head, RF_Receive()
+ * and RF_Receive_Next() take from the tail. Both indices run freely
+ * and are masked on access.
+ */
+static rf_rx_frame_t RF_rx_queue[RF_RX_QUEUE_SIZE];
+static volatile uint8_t RF_rx_head = 0;
+static volatile uint8_t RF_rx_tail = 0;
+static uint8_t RF_current_chan = 0;
+
+rf_rx_stats_t RF_rx_stats;
+
+/*
+ * Rx time slicing. Each period begins with the #0 time slot, which stays
+ * with the main protocol. The #1 slot is split between other slotted
+ * protocols by their recent reception counts, the rest of the period
+ * goes to FANET (it has no slots) or back to the main protocol.
+ */
+typedef struct rf_window_struct {
+  uint16_t end;   /* ms into the period */
+  uint8_t  slice; /* index in RF_slices[] */
+  uint8_t  slot;
+} rf_window_t;
+
+rf_slice_t RF_slices[RF_SLICES_MAX];
+uint8_t RF_slices_count = 0;
+
+static rf_window_t RF_windows[RF_SLICES_MAX + 1];
+static uint8_t RF_windows_count = 0;
+static uint8_t RF_slice_ndx = 0;
+static unsigned long RF_slice_phase = 0;
+static unsigned long RF_slice_marker = 0;
+
+static uint8_t RF_rx_protocol = RF_PROTOCOL_LEGACY; /* the receiver is set up for */
+static uint8_t RF_tx_chan = 0;
 
 FreqPlan RF_FreqPlan;
 static bool RF_ready = false;
@@ -193,6 +242,134 @@ uint8_t parity(uint32_t x) {
     return (parity % 2);
 }
  
+static void RF_Slice_Window(uint16_t end, uint8_t slice, uint8_t slot)
+{
+  rf_window_t *window = &RF_windows[RF_windows_count];
+  uint16_t start = RF_windows_count ? RF_windows[RF_windows_count - 1].end : 0;
+
+  window->end   = end;
+  window->slice = slice;
+  window->slot  = slot;
+  RF_slices[slice].share += end - start;
+
+  RF_windows_count++;
+}
+
+static void RF_Slice_Budget(void)
+{
+  uint8_t slotted[RF_SLICES_MAX];
+  uint8_t slotted_count = 0;
+  uint8_t fanet = 0;
+  uint32_t total = 0;
+
+  for (uint8_t i = 0; i < RF_slices_count; i++) {
+    RF_slices[i].share = 0;
+    if (i == 0) {
+      continue;
+    } else if (RF_slices[i].protocol == RF_PROTOCOL_FANET) {
+      fanet = i;
+    } else {
+      slotted[slotted_count++] = i;
+      total += RF_slices[i].score + 1;
+    }
+  }
+
+  RF_windows_count = 0;
+  RF_Slice_Window(RF_SLICE_SLOT_MS, 0, 0);
+
+  if (slotted_count == 0) {
+    RF_Slice_Window(2 * RF_SLICE_SLOT_MS, fanet, 0);
+  } else {
+    uint16_t spare = RF_SLICE_SLOT_MS - slotted_count * RF_SLICE_MIN_MS;
+    uint16_t end = RF_SLICE_SLOT_MS;
+
+    for (uint8_t k = 0; k < slotted_count; k++) {
+      rf_slice_t *slice = &RF_slices[slotted[k]];
+
+      end = (k == slotted_count - 1) ? 2 * RF_SLICE_SLOT_MS :
+            end + RF_SLICE_MIN_MS + spare * (slice->score + 1) / total;
+      RF_Slice_Window(end, slotted[k], 1);
+    }
+  }
+
+  RF_Slice_Window(RF_SLICE_PERIOD, fanet, 0);
+
+  /* older receptions weigh less, halves in about 5 periods */
+  for (uint8_t i = 0; i < RF_slices_count; i++) {
+    RF_slices[i].score -= RF_slices[i].score >> 3;
+  }
+}
+
+static void RF_Slice_Setup(void)
+{
+  RF_rx_protocol  = settings->rf_protocol;
+  RF_slices_count = 0;
+
+#if !defined(EXCLUDE_SX12XX)
+  const uint8_t protocols[] = {
+    RF_PROTOCOL_LEGACY, RF_PROTOCOL_OGNTP, RF_PROTOCOL_FANET
+  };
+  uint8_t mask = settings->rx_protocols & RF_RX_PROTOCOLS_ALL &
+                 ~(1 << settings->rf_protocol);
+
+  if (rf_chip == NULL ||
+      (rf_chip->type != RF_IC_SX1276 && rf_chip->type != RF_IC_SX1262)) {
+    return;
+  }
+
+  /* P3I has a frequency of its own, UAT is out of reach of SX12XX */
+  if (settings->rf_protocol == RF_PROTOCOL_P3I || mask == 0) {
+    return;
+  }
+
+  memset(RF_slices, 0, sizeof(RF_slices));
+  RF_slices[RF_slices_count++].protocol = settings->rf_protocol;
+
+  for (uint8_t i = 0; i < sizeof(protocols); i++) {
+    if (mask & (1 << protocols[i])) {
+      RF_slices[RF_slices_count++].protocol = protocols[i];
+    }
+  }
+
+  RF_Slice_Budget();
+  RF_slice_ndx    = 0;
+  RF_slice_marker = millis();
+#endif /* EXCLUDE_SX12XX */
+}
+
+/* picks the protocol to listen to at a given moment of the period */
+static uint8_t RF_Slice_Select(unsigned long phase)
+{
+  unsigned long ms = millis();
+  uint8_t ndx = 0;
+
+  RF_slices[RF_slice_ndx].time += ms - RF_slice_marker;
+  RF_slice_marker = ms;
+
+  if (phase < RF_slice_phase) {
+    RF_Slice_Budget();
+  }
+  RF_slice_phase = phase;
+
+  while (ndx < RF_windows_count - 1 && phase >= RF_windows[ndx].end) {
+    ndx++;
+  }
+
+  return ndx;
+}
+
+static uint8_t RF_Channel(time_t Time, uint8_t protocol, uint8_t Slot)
+{
+  uint8_t OGN = (protocol == RF_PROTOCOL_OGNTP ? 1 : 0);
+
+  /* FANET uses 868.2 MHz. Bandwidth is 250kHz  */
+  if (protocol == RF_PROTOCOL_FANET) {
+    Slot = 0;
+  }
+
+  return RF_FreqPlan.getChannel(Time, Slot, OGN);
+}
+
 byte RF_setup(void)
 {
 
@@ -261,6 +438,7 @@ byte RF_setup(void)
 
   if (rf_chip) {
     rf_chip->setup();
+    RF_Slice_Setup();
     return rf_chip->type;
   } else {
     return RF_IC_NONE;
@@ -271,6 +449,7 @@ void RF_SetChannel(void)
 {
   tmElements_t tm;
   time_t Time;
+  unsigned long phase = millis() % RF_SLICE_PERIOD;
 
   switch (settings->mode)
   {
@@ -296,6 +475,9 @@ void RF_SetChannel(void)
         time_corr_neg = 1000 - ((pps_btime_ms - lastCommitTime) % 1000);
       }
       time_corr_pos = 400; /* 400 ms after PPS for V6, 350 ms - for OGNTP */
+
+      phase = (millis() - pps_btime_ms + RF_SLICE_PERIOD - time_corr_pos) %
+              RF_SLICE_PERIOD;
     }
 
     int yr = gnss.date.year();
@@ -316,13 +498,33 @@ void RF_SetChannel(void)
 
   uint8_t Slot = 0; /* only #0 "400ms" timeslot is currently in use */
   uint8_t OGN = (settings->rf_protocol == RF_PROTOCOL_OGNTP ? 1 : 0);
+  uint8_t chan = RF_Channel(Time, settings->rf_protocol, Slot);
 
-  /* FANET uses 868.2 MHz. Bandwidth is 250kHz  */
-  if (settings->rf_protocol == RF_PROTOCOL_FANET) {
-    Slot = 0;
+  RF_tx_chan     = chan;
+  RF_rx_protocol = settings->rf_protocol;
+
+#if defined(USE_TICKLESS)
+  unsigned long phase_end = RF_SLICE_PERIOD;
+#endif /* USE_TICKLESS */
+
+  if (RF_slices_count > 1) {
+    rf_window_t *window = &RF_windows[RF_Slice_Select(phase)];
+
+    RF_slice_ndx   = window->slice;
+    RF_rx_protocol = RF_slices[RF_slice_ndx].protocol;
+    chan           = RF_Channel(Time, RF_rx_protocol, window->slot);
+
+#if defined(USE_TICKLESS)
+    if (window->end > phase) {
+      phase_end = window->end;
+    }
+#endif /* USE_TICKLESS */
   }
 
-  uint8_t chan = RF_FreqPlan.getChannel(Time, Slot, OGN);
+#if defined(USE_TICKLESS)
+  /* be awake for the next channel hop or protocol switch */
+  Tickless_Due(millis() + (phase_end - phase));
+#endif /* USE_TICKLESS */
 
 #if DEBUG
   Serial.print("Plan: "); Serial.println(RF_FreqPlan.Plan);
@@ -331,6 +533,8 @@ void RF_SetChannel(void)
   Serial.print("Channel: "); Serial.println(chan);
 #endif
 
+  RF_current_chan = chan;
+
   if (RF_ready && rf_chip) {
     rf_chip->channel(chan);
   }
@@ -405,21 +609,159 @@ bool RF_Transmit(size_t size, bool wait)
 
       TxTimeMarker = millis();
 
+#if defined(USE_TICKLESS)
+      Tickless_Due(TxTimeMarker + TxRandomValue + 1);
+#endif /* USE_TICKLESS */
+
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Sends out one queued packet of others, within the relay duty cycle.
+ * Does not affect the schedule of own transmissions.
+ */
+bool RF_Relay()
+{
+#if defined(USE_RELAY)
+  if (RF_ready && rf_chip && settings->txpower != RF_TX_POWER_OFF &&
+      settings->rf_protocol == RF_PROTOCOL_OGNTP) {
+
+    size_t size = Relay_Next(&TxBuffer[0]);
+
+    if (size > 0) {
+      RF_tx_size = size;
+
+      rf_chip->transmit();
+
+      if (settings->nmea_p) {
+        StdOut.print(F("$PSRFO,"));
+        StdOut.print((unsigned long) now());
+        StdOut.print(F(","));
+        StdOut.println(Bin2Hex((byte *) &TxBuffer[0], size));
+      }
+      tx_packets_counter++;
+      RF_tx_size = 0;
+
       return true;
     }
   }
+#endif /* USE_RELAY */
+
   return false;
 }
 
+static inline bool RF_Queue_Full(void)
+{
+  return (uint8_t) (RF_rx_head - RF_rx_tail) >= RF_RX_QUEUE_SIZE;
+}
+
+bool RF_Enqueue(const byte *buf, size_t size, int8_t rssi, uint8_t protocol)
+{
+  uint8_t head = RF_rx_head;
+  uint8_t depth = head - RF_rx_tail;
+
+  if (depth >= RF_RX_QUEUE_SIZE) {
+    RF_rx_stats.overruns++;
+    PROFILE_COUNT(PROFILE_OVERRUNS, 1);
+    return false;
+  }
+
+  rf_rx_frame_t *frame = &RF_rx_queue[head & (RF_RX_QUEUE_SIZE - 1)];
+
+  if (size > sizeof(frame->payload)) {
+    size = sizeof(frame->payload);
+  }
+
+  memcpy(frame->payload, buf, size);
+  memset(frame->payload + size, 0, sizeof(frame->payload) - size);
+  frame->size      = size;
+  frame->rssi      = rssi;
+  frame->channel   = RF_current_chan;
+  frame->protocol  = protocol;
+  frame->timestamp = millis();
+
+  /* the frame must be complete before the consumer can see it */
+  __sync_synchronize();
+  RF_rx_head = head + 1;
+
+  if (depth + 1 > RF_rx_stats.depth) {
+    RF_rx_stats.depth = depth + 1;
+  }
+  rx_packets_counter++;
+
+  for (uint8_t i = 0; i < RF_slices_count; i++) {
+    if (RF_slices[i].protocol == protocol) {
+      RF_slices[i].frames++;
+      if (RF_slices[i].score < UINT16_MAX) {
+        RF_slices[i].score++;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool RF_Receive_Next(void)
+{
+  uint8_t tail = RF_rx_tail;
+
+  if (tail == RF_rx_head) {
+    return false;
+  }
+
+  rf_rx_frame_t *frame = &RF_rx_queue[tail & (RF_RX_QUEUE_SIZE - 1)];
+
+  memcpy(RxBuffer, frame->payload, sizeof(RxBuffer));
+  RF_last_rssi     = frame->rssi;
+  RF_last_protocol = frame->protocol;
+
+  __sync_synchronize();
+  RF_rx_tail = tail + 1;
+
+  return true;
+}
+
+void RF_Receive_Flush(void)
+{
+  PROFILE_COUNT(PROFILE_DROPS, (uint8_t) (RF_rx_head - RF_rx_tail));
+  RF_rx_tail = RF_rx_head;
+}
+
 bool RF_Receive(void)
 {
-  bool rval = false;
+  PROFILE_SCOPE(PROFILE_RF_RX);
 
   if (RF_ready && rf_chip) {
-    rval = rf_chip->receive();
+    rf_chip->receive();
   }
-  
-  return rval;
+
+  return RF_Receive_Next();
+}
+
+/* frames of the main protocol go to its decoder, others are routed by type */
+bool RF_Decode(uint8_t protocol, void *pkt, ufo_t *this_aircraft, ufo_t *fop)
+{
+  bool (*decode)(void *, ufo_t *, ufo_t *) = protocol_decode;
+
+  PROFILE_SCOPE(PROFILE_DECODE);
+
+  /* decoders take the reference position out of lat_e7/lon_e7 */
+  Position_Reference(this_aircraft);
+
+  if (protocol != settings->rf_protocol) {
+    switch (protocol)
+    {
+    case RF_PROTOCOL_LEGACY:  decode = &legacy_decode; break;
+    case RF_PROTOCOL_OGNTP:   decode = &ogntp_decode;  break;
+    case RF_PROTOCOL_FANET:   decode = &fanet_decode;  break;
+    default:                  decode = NULL;           break;
+    }
+  }
+
+  return decode && (*decode)(pkt, this_aircraft, fop);
 }
 
 void RF_Shutdown(void)
@@ -578,9 +920,11 @@ static bool nrf905_receive()
     nrf905_receive_active = true;
   }
 
-  success = nRF905_getData(RxBuffer, LEGACY_PAYLOAD_SIZE);
+  byte buf[LEGACY_PAYLOAD_SIZE];
+
+  success = nRF905_getData(buf, LEGACY_PAYLOAD_SIZE);
   if (success) { // Got data
-    rx_packets_counter++;
+    RF_Enqueue(buf, LEGACY_PAYLOAD_SIZE, 0, RF_PROTOCOL_LEGACY);
   }
 
   return success;
@@ -754,33 +1098,213 @@ static bool sx1262_probe()
 }
 #endif
 
-static void sx12xx_channel(uint8_t channel)
+/*
+ * Frame processors, one instance per CRC type and whitening of a protocol.
+ * These properties of the descriptor are template arguments, so the per-byte
+ * loops are straight CRC + whitening code. The instance is picked once,
+ * when LMIC.protocol changes, and so is the CRC seed.
+ */
+typedef bool (*sx12xx_rx_proc_t)(u1_t *, u1_t, u1_t, u2_t);
+typedef u1_t (*sx12xx_tx_proc_t)(u1_t *, const u1_t *, u1_t, u2_t);
+
+typedef struct sx12xx_proc_struct {
+  const rf_proto_desc_t *desc;
+  sx12xx_rx_proc_t      rx;
+  sx12xx_tx_proc_t      tx;
+  u2_t                  seed;
+} sx12xx_proc_t;
+
+static sx12xx_proc_t sx12xx_proc = { NULL, NULL, NULL, 0 };
+
+/* de-whitens payload of the frame in place, returns true when CRC is valid */
+template <u1_t CRC_TYPE, u1_t WHITENING>
+static bool sx12xx_rx_frame(u1_t *frame, u1_t offset, u1_t size, u2_t seed)
 {
-  if (channel != sx12xx_channel_prev) {
-    uint32_t frequency = RF_FreqPlan.getChanFrequency(channel);
-    int8_t fc = settings->freq_corr;
+  u1_t *payload = &frame[offset];
+  u1_t crc8  = (u1_t) seed;
+  u2_t crc16 = seed;
+
+  for (u1_t i = 0; i < size; i++) {
+    if (CRC_TYPE == RF_CHECKSUM_TYPE_CRC8_107) {
+      update_crc8(&crc8, payload[i]);
+    } else if (CRC_TYPE == RF_CHECKSUM_TYPE_CCITT_FFFF) {
+      crc16 = update_crc_ccitt(crc16, payload[i]);
+    }
+    if (WHITENING == RF_WHITENING_NICERF) {
+      payload[i] ^= pgm_read_byte(&whitening_pattern[i]);
+    }
+  }
+
+  switch (CRC_TYPE)
+  {
+  case RF_CHECKSUM_TYPE_NONE:
+    return true;
+  case RF_CHECKSUM_TYPE_GALLAGER:
+    return !LDPC_Check((uint8_t *) &frame[0]);
+  case RF_CHECKSUM_TYPE_CRC8_107:
+    return crc8 == payload[size];
+  case RF_CHECKSUM_TYPE_CCITT_FFFF:
+  default:
+    return crc16 == (u2_t) (payload[size] << 8 | payload[size+1]);
+  }
+}
+
+/* whitens and checksums buf into frame, returns number of bytes written */
+template <u1_t CRC_TYPE, u1_t WHITENING>
+static u1_t sx12xx_tx_frame(u1_t *frame, const u1_t *buf, u1_t size, u2_t seed)
+{
+  u1_t crc8  = (u1_t) seed;
+  u2_t crc16 = seed;
 
-    //Serial.print("frequency: "); Serial.println(frequency);
+  for (u1_t i = 0; i < size; i++) {
+    frame[i] = WHITENING == RF_WHITENING_NICERF ?
+               buf[i] ^ pgm_read_byte(&whitening_pattern[i]) : buf[i];
+
+    if (CRC_TYPE == RF_CHECKSUM_TYPE_CRC8_107) {
+      update_crc8(&crc8, frame[i]);
+    } else if (CRC_TYPE == RF_CHECKSUM_TYPE_CCITT_FFFF) {
+      crc16 = update_crc_ccitt(crc16, frame[i]);
+    }
+  }
+
+  switch (CRC_TYPE)
+  {
+  case RF_CHECKSUM_TYPE_NONE:
+  case RF_CHECKSUM_TYPE_GALLAGER:
+    return size;
+  case RF_CHECKSUM_TYPE_CRC8_107:
+    frame[size] = crc8;
+    return size + 1;
+  case RF_CHECKSUM_TYPE_CCITT_FFFF:
+  default:
+    frame[size]   = (crc16 >>  8) & 0xFF;
+    frame[size+1] = (crc16      ) & 0xFF;
+    return size + 2;
+  }
+}
+
+#define SX12XX_PROC(crc, w)   { sx12xx_rx_frame<crc, w>, sx12xx_tx_frame<crc, w> }
+#define SX12XX_PROCS(crc)     { SX12XX_PROC(crc, RF_WHITENING_NONE), \
+                                SX12XX_PROC(crc, RF_WHITENING_NICERF) }
+
+static const struct {
+  sx12xx_rx_proc_t rx;
+  sx12xx_tx_proc_t tx;
+} sx12xx_proc_table[][2] = {
+  SX12XX_PROCS(RF_CHECKSUM_TYPE_NONE),
+  SX12XX_PROCS(RF_CHECKSUM_TYPE_GALLAGER),
+  SX12XX_PROCS(RF_CHECKSUM_TYPE_CRC8_107),
+  SX12XX_PROCS(RF_CHECKSUM_TYPE_CCITT_FFFF), /* CCITT_0000 differs by seed */
+};
+
+static void sx12xx_proc_setup(const rf_proto_desc_t *desc)
+{
+  u1_t crc_ndx;
+  u2_t seed;
+
+  switch (desc->crc_type)
+  {
+  case RF_CHECKSUM_TYPE_NONE:
+    crc_ndx = 0;
+    seed    = 0;
+    break;
+  case RF_CHECKSUM_TYPE_GALLAGER:
+    crc_ndx = 1;
+    seed    = 0;
+    break;
+  case RF_CHECKSUM_TYPE_CRC8_107:
+    crc_ndx = 2;
+    seed    = 0x71;
+    break;
+  case RF_CHECKSUM_TYPE_CCITT_0000:
+    crc_ndx = 3;
+    seed    = 0x0000;
+    break;
+  case RF_CHECKSUM_TYPE_CCITT_FFFF:
+  default:
+    crc_ndx = 3;
+    seed    = 0xffff;
+    break;
+  }
+
+  if (desc->type == RF_PROTOCOL_LEGACY) {
+    /* take in account NRF905/FLARM "address" bytes */
+    seed = update_crc_ccitt(seed, 0x31);
+    seed = update_crc_ccitt(seed, 0xFA);
+    seed = update_crc_ccitt(seed, 0xB6);
+  }
+
+  u1_t w_ndx = (desc->whitening == RF_WHITENING_NICERF);
+
+  sx12xx_proc.desc = desc;
+  sx12xx_proc.rx   = sx12xx_proc_table[crc_ndx][w_ndx].rx;
+  sx12xx_proc.tx   = sx12xx_proc_table[crc_ndx][w_ndx].tx;
+  sx12xx_proc.seed = seed;
+}
+
+static inline const sx12xx_proc_t *sx12xx_procs(const rf_proto_desc_t *desc)
+{
+  if (sx12xx_proc.desc != desc) {
+    sx12xx_proc_setup(desc);
+  }
+  return &sx12xx_proc;
+}
+
+static const rf_proto_desc_t *sx12xx_protocol(uint8_t protocol)
+{
+  switch (protocol)
+  {
+  case RF_PROTOCOL_OGNTP:   return &ogntp_proto_desc;
+  case RF_PROTOCOL_P3I:     return &p3i_proto_desc;
+  case RF_PROTOCOL_FANET:   return &fanet_proto_desc;
+  case RF_PROTOCOL_LEGACY:
+  default:                  return &legacy_proto_desc;
+  }
+}
+
+static uint32_t sx12xx_frequency(uint8_t channel)
+{
+  uint32_t frequency = RF_FreqPlan.getChanFrequency(channel);
+  int8_t fc = settings->freq_corr;
+
+  //Serial.print("frequency: "); Serial.println(frequency);
+
+  if (rf_chip->type == RF_IC_SX1276) {
+    /* correction of not more than 30 kHz is allowed */
+    if (fc > 30) {
+      fc = 30;
+    } else if (fc < -30) {
+      fc = -30;
+    };
+  } else {
+    /* Most of SX1262 designs use TCXO */
+    fc = 0;
+  }
+
+  return frequency + (fc * 1000);
+}
 
+static void sx12xx_channel(uint8_t channel)
+{
+  /* Rx time slicing may switch protocol along with the channel */
+  if (LMIC.protocol && LMIC.protocol->type != RF_rx_protocol) {
     if (sx12xx_receive_active) {
       os_radio(RADIO_RST);
       sx12xx_receive_active = false;
     }
 
-    if (rf_chip->type == RF_IC_SX1276) {
-      /* correction of not more than 30 kHz is allowed */
-      if (fc > 30) {
-        fc = 30;
-      } else if (fc < -30) {
-        fc = -30;
-      };
-    } else {
-      /* Most of SX1262 designs use TCXO */
-      fc = 0;
+    LMIC.protocol = sx12xx_protocol(RF_rx_protocol);
+  }
+
+  if (channel != sx12xx_channel_prev) {
+
+    if (sx12xx_receive_active) {
+      os_radio(RADIO_RST);
+      sx12xx_receive_active = false;
     }
 
     /* Actual RF chip's channel registers will be updated before each Tx or Rx session */
-    LMIC.freq = frequency + (fc * 1000);
+    LMIC.freq = sx12xx_frequency(channel);
     //LMIC.freq = 868200000UL;
 
     sx12xx_channel_prev = channel;
@@ -827,6 +1351,8 @@ static void sx12xx_setup()
     break;
   }
 
+  sx12xx_proc_setup(LMIC.protocol);
+
   switch(settings->txpower)
   {
   case RF_TX_POWER_FULL:
@@ -910,19 +1436,6 @@ static bool sx12xx_receive()
   };
 
   if (sx12xx_receive_complete == true) {
-
-    u1_t size = LMIC.dataLen - LMIC.protocol->payload_offset - LMIC.protocol->crc_size;
-
-    if (size >sizeof(RxBuffer)) {
-      size = sizeof(RxBuffer);
-    }
-
-    for (u1_t i=0; i < size; i++) {
-        RxBuffer[i] = LMIC.frame[i + LMIC.protocol->payload_offset];
-    }
-
-    RF_last_rssi = LMIC.rssi;
-    rx_packets_counter++;
     success = true;
   }
 
@@ -931,9 +1444,18 @@ static bool sx12xx_receive()
 
 static void sx12xx_transmit()
 {
+    const rf_proto_desc_t *rx_protocol = LMIC.protocol;
+    u4_t rx_freq = LMIC.freq;
+
     sx12xx_transmit_complete = false;
     sx12xx_receive_active = false;
 
+    /* the receiver may be lent to another protocol at the moment */
+    if (LMIC.protocol && LMIC.protocol->type != settings->rf_protocol) {
+      LMIC.protocol = sx12xx_protocol(settings->rf_protocol);
+      LMIC.freq     = sx12xx_frequency(RF_tx_chan);
+    }
+
     sx12xx_setvars();
     os_setCallback(&sx12xx_txjob, sx12xx_tx_func);
 
@@ -943,6 +1465,9 @@ static void sx12xx_transmit()
 
       yield();
     };
+
+    LMIC.protocol = rx_protocol;
+    LMIC.freq     = rx_freq;
 }
 
 static void sx12xx_shutdown()
@@ -965,253 +1490,84 @@ static void sx12xx_rx(osjobcb_t func) {
   //Serial.println("RX");
 }
 
-static void sx12xx_rx_func (osjob_t* job) {
-
-  u1_t crc8, pkt_crc8;
-  u2_t crc16, pkt_crc16;
-  u1_t i;
+static void sx12xx_rx_process () {
 
-  // SX1276 is in SLEEP after IRQ handler, Force it to enter RX mode
-  sx12xx_receive_active = false;
+  const rf_proto_desc_t *desc = LMIC.protocol;
+  const sx12xx_proc_t *proc = sx12xx_procs(desc);
 
   /* FANET (LoRa) LMIC IRQ handler may deliver empty packets here when CRC is invalid. */
   if (LMIC.dataLen == 0) {
     return;
   }
 
-  switch (LMIC.protocol->crc_type)
-  {
-  case RF_CHECKSUM_TYPE_GALLAGER:
-  case RF_CHECKSUM_TYPE_NONE:
-     /* crc16 left not initialized */
-    break;
-  case RF_CHECKSUM_TYPE_CRC8_107:
-    crc8 = 0x71;     /* seed value */
-    break;
-  case RF_CHECKSUM_TYPE_CCITT_0000:
-    crc16 = 0x0000;  /* seed value */
-    break;
-  case RF_CHECKSUM_TYPE_CCITT_FFFF:
-  default:
-    crc16 = 0xffff;  /* seed value */
-    break;
-  }
-
   //Serial.print("Got ");
   //Serial.print(LMIC.dataLen);
   //Serial.println(" bytes");
 
-  switch (LMIC.protocol->type)
-  {
-  case RF_PROTOCOL_LEGACY:
-    /* take in account NRF905/FLARM "address" bytes */
-    crc16 = update_crc_ccitt(crc16, 0x31);
-    crc16 = update_crc_ccitt(crc16, 0xFA);
-    crc16 = update_crc_ccitt(crc16, 0xB6);
-    break;
-  case RF_PROTOCOL_P3I:
-  case RF_PROTOCOL_OGNTP:
-  default:
-    break;
+  if (LMIC.dataLen < desc->payload_offset + desc->crc_size) {
+    return;
   }
 
-  for (i = LMIC.protocol->payload_offset;
-       i < (LMIC.dataLen - LMIC.protocol->crc_size);
-       i++)
-  {
+  u1_t size = LMIC.dataLen - desc->payload_offset - desc->crc_size;
 
-    switch (LMIC.protocol->crc_type)
-    {
-    case RF_CHECKSUM_TYPE_GALLAGER:
-    case RF_CHECKSUM_TYPE_NONE:
-      break;
-    case RF_CHECKSUM_TYPE_CRC8_107:
-      update_crc8(&crc8, (u1_t)(LMIC.frame[i]));
-      break;
-    case RF_CHECKSUM_TYPE_CCITT_FFFF:
-    case RF_CHECKSUM_TYPE_CCITT_0000:
-    default:
-      crc16 = update_crc_ccitt(crc16, (u1_t)(LMIC.frame[i]));
-      break;
-    }
-
-    switch (LMIC.protocol->whitening)
-    {
-    case RF_WHITENING_NICERF:
-      LMIC.frame[i] ^= pgm_read_byte(&whitening_pattern[i - LMIC.protocol->payload_offset]);
-      break;
-    case RF_WHITENING_MANCHESTER:
-    case RF_WHITENING_NONE:
-    default:
-      break;
-    }
+  sx12xx_receive_complete = proc->rx(&LMIC.frame[0], desc->payload_offset,
+                                     size, proc->seed);
 
 #if DEBUG
+  for (u1_t i = 0; i < LMIC.dataLen; i++) {
     Serial.printf("%02x", (u1_t)(LMIC.frame[i]));
-#endif
   }
-
-  switch (LMIC.protocol->crc_type)
-  {
-  case RF_CHECKSUM_TYPE_NONE:
-    sx12xx_receive_complete = true;
-    break;
-  case RF_CHECKSUM_TYPE_GALLAGER:
-    if (LDPC_Check((uint8_t  *) &LMIC.frame[0])) {
-#if DEBUG
-      Serial.printf(" %02x%02x%02x%02x%02x%02x is wrong FEC",
-        LMIC.frame[i], LMIC.frame[i+1], LMIC.frame[i+2],
-        LMIC.frame[i+3], LMIC.frame[i+4], LMIC.frame[i+5]);
-#endif
-      sx12xx_receive_complete = false;
-    } else {
-      sx12xx_receive_complete = true;
-    }
-    break;
-  case RF_CHECKSUM_TYPE_CRC8_107:
-    pkt_crc8 = LMIC.frame[i];
-#if DEBUG
-    if (crc8 == pkt_crc8 ) {
-      Serial.printf(" %02x is valid crc", pkt_crc8);
-    } else {
-      Serial.printf(" %02x is wrong crc", pkt_crc8);
-    }
-#endif
-    if (crc8 == pkt_crc8) {
-      sx12xx_receive_complete = true;
-    } else {
-      sx12xx_receive_complete = false;
-    }
-    break;
-  case RF_CHECKSUM_TYPE_CCITT_FFFF:
-  case RF_CHECKSUM_TYPE_CCITT_0000:
-  default:
-    pkt_crc16 = (LMIC.frame[i] << 8 | LMIC.frame[i+1]);
-#if DEBUG
-    if (crc16 == pkt_crc16 ) {
-      Serial.printf(" %04x is valid crc", pkt_crc16);
-    } else {
-      Serial.printf(" %04x is wrong crc", pkt_crc16);
-    }
+  Serial.println(sx12xx_receive_complete ? " is valid" : " is wrong");
 #endif
-    if (crc16 == pkt_crc16) {
-      sx12xx_receive_complete = true;
-    } else {
-      sx12xx_receive_complete = false;
-    }
-    break;
+
+  if (sx12xx_receive_complete == true) {
+    RF_Enqueue(&LMIC.frame[desc->payload_offset], size,
+               LMIC.rssi, desc->type);
+  } else {
+    PROFILE_COUNT(PROFILE_CRC_ERRORS, 1);
   }
+}
 
-#if DEBUG
-  Serial.println();
-#endif
+static void sx12xx_rx_func (osjob_t* job) {
 
+  sx12xx_rx_process();
+
+  /*
+   * SX1276 is in SLEEP after IRQ handler. The frame is in the queue already,
+   * so that the radio is put back into RX mode right away rather than
+   * on next pass of the loop.
+   */
+  sx12xx_rx(sx12xx_rx_func);
+  sx12xx_receive_active = true;
 }
 
 // Transmit the given string and call the given function afterwards
 static void sx12xx_tx(unsigned char *buf, size_t size, osjobcb_t func) {
 
-  u1_t crc8;
-  u2_t crc16;
+  const rf_proto_desc_t *desc = LMIC.protocol;
+  const sx12xx_proc_t *proc = sx12xx_procs(desc);
 
-  switch (LMIC.protocol->crc_type)
-  {
-  case RF_CHECKSUM_TYPE_GALLAGER:
-  case RF_CHECKSUM_TYPE_NONE:
-     /* crc16 left not initialized */
-    break;
-  case RF_CHECKSUM_TYPE_CRC8_107:
-    crc8 = 0x71;     /* seed value */
-    break;
-  case RF_CHECKSUM_TYPE_CCITT_0000:
-    crc16 = 0x0000;  /* seed value */
-    break;
-  case RF_CHECKSUM_TYPE_CCITT_FFFF:
-  default:
-    crc16 = 0xffff;  /* seed value */
-    break;
-  }
-  
   os_radio(RADIO_RST); // Stop RX first
   delay(1); // Wait a bit, without this os_radio below asserts, apparently because the state hasn't changed yet
 
   LMIC.dataLen = 0;
 
-  switch (LMIC.protocol->type)
-  {
-  case RF_PROTOCOL_LEGACY:
-    /* take in account NRF905/FLARM "address" bytes */
-    crc16 = update_crc_ccitt(crc16, 0x31);
-    crc16 = update_crc_ccitt(crc16, 0xFA);
-    crc16 = update_crc_ccitt(crc16, 0xB6);
-    break;
-  case RF_PROTOCOL_P3I:
+  if (desc->type == RF_PROTOCOL_P3I) {
     /* insert Net ID */
-    LMIC.frame[LMIC.dataLen++] = (u1_t) ((LMIC.protocol->net_id >> 24) & 0x000000FF);
-    LMIC.frame[LMIC.dataLen++] = (u1_t) ((LMIC.protocol->net_id >> 16) & 0x000000FF);
-    LMIC.frame[LMIC.dataLen++] = (u1_t) ((LMIC.protocol->net_id >>  8) & 0x000000FF);
-    LMIC.frame[LMIC.dataLen++] = (u1_t) ((LMIC.protocol->net_id >>  0) & 0x000000FF);
+    LMIC.frame[LMIC.dataLen++] = (u1_t) ((desc->net_id >> 24) & 0x000000FF);
+    LMIC.frame[LMIC.dataLen++] = (u1_t) ((desc->net_id >> 16) & 0x000000FF);
+    LMIC.frame[LMIC.dataLen++] = (u1_t) ((desc->net_id >>  8) & 0x000000FF);
+    LMIC.frame[LMIC.dataLen++] = (u1_t) ((desc->net_id >>  0) & 0x000000FF);
     /* insert byte with payload size */
-    LMIC.frame[LMIC.dataLen++] = LMIC.protocol->payload_size;
+    LMIC.frame[LMIC.dataLen++] = desc->payload_size;
 
     /* insert byte with CRC-8 seed value when necessary */
-    if (LMIC.protocol->crc_type == RF_CHECKSUM_TYPE_CRC8_107) {
-      LMIC.frame[LMIC.dataLen++] = crc8;
+    if (desc->crc_type == RF_CHECKSUM_TYPE_CRC8_107) {
+      LMIC.frame[LMIC.dataLen++] = (u1_t) proc->seed;
     }
-
-    break;
-  case RF_PROTOCOL_OGNTP:
-  default:
-    break;
   }
 
-  for (u1_t i=0; i < size; i++) {
-
-    switch (LMIC.protocol->whitening)
-    {
-    case RF_WHITENING_NICERF:
-      LMIC.frame[LMIC.dataLen] = buf[i] ^ pgm_read_byte(&whitening_pattern[i]);
-      break;
-    case RF_WHITENING_MANCHESTER:
-    case RF_WHITENING_NONE:
-    default:
-      LMIC.frame[LMIC.dataLen] = buf[i];
-      break;
-    }
-
-    switch (LMIC.protocol->crc_type)
-    {
-    case RF_CHECKSUM_TYPE_GALLAGER:
-    case RF_CHECKSUM_TYPE_NONE:
-      break;
-    case RF_CHECKSUM_TYPE_CRC8_107:
-      update_crc8(&crc8, (u1_t)(LMIC.frame[LMIC.dataLen]));
-      break;
-    case RF_CHECKSUM_TYPE_CCITT_FFFF:
-    case RF_CHECKSUM_TYPE_CCITT_0000:
-    default:
-      crc16 = update_crc_ccitt(crc16, (u1_t)(LMIC.frame[LMIC.dataLen]));
-      break;
-    }
-
-    LMIC.dataLen++;
-  }
-
-  switch (LMIC.protocol->crc_type)
-  {
-  case RF_CHECKSUM_TYPE_GALLAGER:
-  case RF_CHECKSUM_TYPE_NONE:
-    break;
-  case RF_CHECKSUM_TYPE_CRC8_107:
-    LMIC.frame[LMIC.dataLen++] = crc8;
-    break;
-  case RF_CHECKSUM_TYPE_CCITT_FFFF:
-  case RF_CHECKSUM_TYPE_CCITT_0000:
-  default:
-    LMIC.frame[LMIC.dataLen++] = (crc16 >>  8) & 0xFF;
-    LMIC.frame[LMIC.dataLen++] = (crc16      ) & 0xFF;
-    break;
-  }
+  LMIC.dataLen += proc->tx(&LMIC.frame[LMIC.dataLen], buf, size, proc->seed);
 
   LMIC.osjob.func = func;
   os_radio(RADIO_TX);
@@ -1239,12 +1595,30 @@ static void sx12xx_tx_func (osjob_t* job) {
 
 #include <uat.h>
 
-#define UAT_RINGBUF_SIZE  (sizeof(Stratux_frame_t) * 2)
+/*
+ * UART data is read in bulk straight into a power-of-two ring.
+ * uatbuf_head is where the next read goes to, uatbuf_tail - where the
+ * search for a frame header resumes. Both run freely and are masked on
+ * access. The ring has room for a ground uplink plus some slack.
+ */
+#define UAT_RINGBUF_SIZE  1024
+#define UAT_RINGBUF_MASK  (UAT_RINGBUF_SIZE - 1)
+#define UAT_RING(i)       uat_ringbuf[(i) & UAT_RINGBUF_MASK]
+
+#define STRATUX_UATRADIO_HEADER_SIZE  (sizeof(Stratux_frame_t) - LONG_FRAME_BYTES)
 
 static unsigned char uat_ringbuf[UAT_RINGBUF_SIZE];
 static unsigned int uatbuf_head = 0;
+static unsigned int uatbuf_tail = 0;
 Stratux_frame_t uatradio_frame;
 
+#if defined(USE_FISB)
+#include "../protocol/data/FISB.h"
+
+/* linear copy of an uplink that wraps around the end of the ring */
+static unsigned char uat_uplink_frame[UPLINK_FRAME_BYTES];
+#endif /* USE_FISB */
+
 const char UAT_ident[] PROGMEM = SOFTRF_IDENT;
 
 static bool uatm_probe()
@@ -1294,7 +1668,7 @@ static bool uatm_probe()
   }
 
   /* cleanup UAT data buffer */
-  uatbuf_head = 0;
+  uatbuf_head = uatbuf_tail = 0;
   memset(uat_ringbuf, 0, sizeof(uat_ringbuf));
 
   /* Current ESP32 Core has a bug with Serial2.end()+Serial2.begin() cycle */
@@ -1326,61 +1700,133 @@ static void uatm_setup()
   protocol_decode = &uat978_decode;
 }
 
-static bool uatm_receive()
+/* returns a contiguous view of 'size' ring bytes at 'ndx', copies if wrapped */
+static unsigned char *uatm_frame(unsigned int ndx, size_t size, unsigned char *copy)
 {
-  bool success = false;
-  unsigned int uatbuf_tail;
-  int rs_errors;
+  unsigned int ofs = ndx & UAT_RINGBUF_MASK;
 
-  while (UATSerial.available()) {
-    unsigned char c = UATSerial.read();
+  if (ofs + size <= UAT_RINGBUF_SIZE) {
+    return &uat_ringbuf[ofs];
+  }
 
-    uat_ringbuf[uatbuf_head % UAT_RINGBUF_SIZE] = c;
+  size_t part = UAT_RINGBUF_SIZE - ofs;
+  memcpy(copy, &uat_ringbuf[ofs], part);
+  memcpy(copy + part, uat_ringbuf, size - part);
 
-    uatbuf_tail = uatbuf_head - sizeof(Stratux_frame_t);
-    uatbuf_head++;
+  return copy;
+}
 
-    if (uat_ringbuf[ uatbuf_tail      % UAT_RINGBUF_SIZE] == STRATUX_UATRADIO_MAGIC_1 &&
-        uat_ringbuf[(uatbuf_tail + 1) % UAT_RINGBUF_SIZE] == STRATUX_UATRADIO_MAGIC_2 &&
-        uat_ringbuf[(uatbuf_tail + 2) % UAT_RINGBUF_SIZE] == STRATUX_UATRADIO_MAGIC_3 &&
-        uat_ringbuf[(uatbuf_tail + 3) % UAT_RINGBUF_SIZE] == STRATUX_UATRADIO_MAGIC_4) {
+/* moves everything the UART has buffered into the ring, as far as it fits */
+static void uatm_ingest()
+{
+  int avail;
 
-      unsigned char *pre_fec_buf = (unsigned char *) &uatradio_frame;
-      for (u1_t i=0; i < sizeof(Stratux_frame_t); i++) {
-          pre_fec_buf[i] = uat_ringbuf[(uatbuf_tail + i) % UAT_RINGBUF_SIZE];
-      }
+  while ((avail = UATSerial.available()) > 0) {
+    unsigned int room = UAT_RINGBUF_SIZE - (uatbuf_head - uatbuf_tail);
+    unsigned int ofs  = uatbuf_head & UAT_RINGBUF_MASK;
+    size_t size = UAT_RINGBUF_SIZE - ofs; /* up to the end of the ring */
+
+    if (size > room) {
+      size = room;
+    }
+    if (size > (size_t) avail) {
+      size = avail;
+    }
+    if (size == 0) {
+      break;
+    }
 
-      int frame_type = correct_adsb_frame(uatradio_frame.data, &rs_errors);
+    uatbuf_head += UATSerial.readBytes(&uat_ringbuf[ofs], size);
+  }
+}
 
-      if (frame_type == -1) {
-        continue;
-      }
+/* FEC-checks every complete frame in the ring, stops when the RX queue is full */
+static void uatm_parse()
+{
+  int rs_errors;
 
-      u1_t size = 0;
+  while (uatbuf_head - uatbuf_tail >= STRATUX_UATRADIO_HEADER_SIZE &&
+         !RF_Queue_Full()) {
 
-      if (frame_type == 1) {
-        size = SHORT_FRAME_DATA_BYTES;
-      } else if (frame_type == 2) {
-        size = LONG_FRAME_DATA_BYTES;
-      }
+    unsigned int ofs = uatbuf_tail & UAT_RINGBUF_MASK;
+    unsigned int end = uatbuf_head & UAT_RINGBUF_MASK;
+    size_t span = (end > ofs ? end : UAT_RINGBUF_SIZE) - ofs;
 
-      if (size > sizeof(RxBuffer)) {
-        size = sizeof(RxBuffer);
-      }
+    /* skip to the next candidate for the first magic byte */
+    unsigned char *p = (unsigned char *) memchr(&uat_ringbuf[ofs],
+                                                STRATUX_UATRADIO_MAGIC_1, span);
+    if (p == NULL) {
+      uatbuf_tail += span;
+      continue;
+    }
+    uatbuf_tail += p - &uat_ringbuf[ofs];
+
+    if (uatbuf_head - uatbuf_tail < STRATUX_UATRADIO_HEADER_SIZE) {
+      break;
+    }
 
-      if (size > 0) {
-        memcpy(RxBuffer, uatradio_frame.data, size);
+    if (UAT_RING(uatbuf_tail + 1) != STRATUX_UATRADIO_MAGIC_2 ||
+        UAT_RING(uatbuf_tail + 2) != STRATUX_UATRADIO_MAGIC_3 ||
+        UAT_RING(uatbuf_tail + 3) != STRATUX_UATRADIO_MAGIC_4) {
+      uatbuf_tail++;
+      continue;
+    }
 
-        RF_last_rssi = uatradio_frame.rssi;
-        rx_packets_counter++;
-        success = true;
+#if defined(USE_FISB)
+    uint16_t msgLen = UAT_RING(uatbuf_tail + 4) | (UAT_RING(uatbuf_tail + 5) << 8);
 
+    if (msgLen == UPLINK_FRAME_BYTES) {
+      if (uatbuf_head - uatbuf_tail < STRATUX_UATRADIO_HEADER_SIZE + UPLINK_FRAME_BYTES) {
         break;
       }
+
+      FISB_Uplink(uatm_frame(uatbuf_tail + STRATUX_UATRADIO_HEADER_SIZE,
+                             UPLINK_FRAME_BYTES, uat_uplink_frame));
+      uatbuf_tail += STRATUX_UATRADIO_HEADER_SIZE + UPLINK_FRAME_BYTES;
+      continue;
+    }
+#endif /* USE_FISB */
+
+    if (uatbuf_head - uatbuf_tail < sizeof(Stratux_frame_t)) {
+      break;
     }
+
+    /* FEC works in place, right in the ring unless the frame wraps */
+    Stratux_frame_t *frame = (Stratux_frame_t *)
+      uatm_frame(uatbuf_tail, sizeof(Stratux_frame_t),
+                 (unsigned char *) &uatradio_frame);
+
+    int frame_type = correct_adsb_frame(frame->data, &rs_errors);
+
+    if (frame_type == -1) {
+      /* a false sync, resume the search right after it */
+      uatbuf_tail++;
+      continue;
+    }
+
+    PROFILE_COUNT(PROFILE_FEC_CORRECTIONS, rs_errors);
+
+    RF_Enqueue(frame->data,
+               frame_type == 1 ? SHORT_FRAME_DATA_BYTES : LONG_FRAME_DATA_BYTES,
+               frame->rssi, RF_PROTOCOL_ADSB_UAT);
+
+    uatbuf_tail += sizeof(Stratux_frame_t);
   }
+}
 
-  return success;
+static bool uatm_receive()
+{
+  uint32_t rx_packets = rx_packets_counter;
+
+  /* drain the UART, parsing as we go so that the ring never blocks it */
+  do {
+    uatm_ingest();
+    uatm_parse();
+  } while (UATSerial.available() > 0 &&
+           uatbuf_head - uatbuf_tail < UAT_RINGBUF_SIZE &&
+           !RF_Queue_Full());
+
+  return rx_packets != rx_packets_counter;
 }
 
 static void uatm_transmit()
@@ -1431,6 +1877,7 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
 
   if (status == EasyLink_Status_Success) {
 
+    byte rx_buf[MAX_PKT_SIZE] = { 0 };
     size_t size = 0;
     uint8_t offset;
 
@@ -1480,8 +1927,8 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
       for (i = 0; i < cc13xx_protocol->payload_size; i++)
       {
         update_crc8(&crc8, (u1_t)(rxPacket_ptr->payload[i + offset]));
-        if (i < sizeof(RxBuffer)) {
-          RxBuffer[i] = rxPacket_ptr->payload[i + offset] ^
+        if (i < sizeof(rx_buf)) {
+          rx_buf[i] = rxPacket_ptr->payload[i + offset] ^
                         pgm_read_byte(&whitening_pattern[i]);
         }
       }
@@ -1512,8 +1959,8 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
           val1 = pgm_read_byte(&ManchesterDecode[rxPacket_ptr->payload[i + offset]]);
           i++;
           val2 = pgm_read_byte(&ManchesterDecode[rxPacket_ptr->payload[i + offset]]);
-          if ((i>>1) < sizeof(RxBuffer)) {
-            RxBuffer[i>>1] = ((val1 & 0x0F) << 4) | (val2 & 0x0F);
+          if ((i>>1) < sizeof(rx_buf)) {
+            rx_buf[i>>1] = ((val1 & 0x0F) << 4) | (val2 & 0x0F);
 
             if (i < size - (cc13xx_protocol->crc_size + cc13xx_protocol->crc_size)) {
               switch (cc13xx_protocol->crc_type)
@@ -1524,7 +1971,7 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
               case RF_CHECKSUM_TYPE_CCITT_FFFF:
               case RF_CHECKSUM_TYPE_CCITT_0000:
               default:
-                crc16 = update_crc_ccitt(crc16, (u1_t)(RxBuffer[i>>1]));
+                crc16 = update_crc_ccitt(crc16, (u1_t)(rx_buf[i>>1]));
                 break;
               }
             }
@@ -1534,7 +1981,7 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
         switch (cc13xx_protocol->crc_type)
         {
         case RF_CHECKSUM_TYPE_GALLAGER:
-          if (LDPC_Check((uint8_t  *) &RxBuffer[0]) == 0) {
+          if (LDPC_Check((uint8_t  *) &rx_buf[0]) == 0) {
 
             success = true;
           }
@@ -1542,8 +1989,8 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
         case RF_CHECKSUM_TYPE_CCITT_FFFF:
         case RF_CHECKSUM_TYPE_CCITT_0000:
           offset = cc13xx_protocol->payload_offset + cc13xx_protocol->payload_size;
-          if (offset + 1 < sizeof(RxBuffer)) {
-            pkt_crc16 = (RxBuffer[offset] << 8 | RxBuffer[offset+1]);
+          if (offset + 1 < sizeof(rx_buf)) {
+            pkt_crc16 = (rx_buf[offset] << 8 | rx_buf[offset+1]);
             if (crc16 == pkt_crc16) {
 
               success = true;
@@ -1564,18 +2011,20 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
 
       if (frame_type != -1) {
 
+        PROFILE_COUNT(PROFILE_FEC_CORRECTIONS, rs_errors);
+
         if (frame_type == 1) {
           size = SHORT_FRAME_DATA_BYTES;
         } else if (frame_type == 2) {
           size = LONG_FRAME_DATA_BYTES;
         }
 
-        if (size > sizeof(RxBuffer)) {
-          size = sizeof(RxBuffer);
+        if (size > sizeof(rx_buf)) {
+          size = sizeof(rx_buf);
         }
 
         if (size > 0) {
-          memcpy(RxBuffer, rxPacket_ptr->payload, size);
+          memcpy(rx_buf, rxPacket_ptr->payload, size);
 
           success = true;
         }
@@ -1584,8 +2033,7 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
     }
 
     if (success) {
-      RF_last_rssi = rxPacket_ptr->rssi;
-      rx_packets_counter++;
+      RF_Enqueue(rx_buf, sizeof(rx_buf), rxPacket_ptr->rssi, cc13xx_protocol->type);
 
       cc13xx_receive_complete  = true;
     }
@@ -2048,6 +2496,7 @@ static bool ognrf_receive()
 #if !defined(WITH_SI4X32)
 
   uint8_t RxRSSI = 0;
+  uint8_t rx_buf[MAX_PKT_SIZE];
   uint8_t Err [OGNTP_PAYLOAD_SIZE + OGNTP_CRC_SIZE];
 
   // Put into receive mode
@@ -2065,15 +2514,14 @@ static bool ognrf_receive()
   if(TRX.DIO0_isOn()) {
     RxRSSI = TRX.ReadRSSI();
 
-    TRX.ReadPacket(RxBuffer, Err);
-    if (LDPC_Check((uint8_t  *) RxBuffer) == 0) {
+    TRX.ReadPacket(rx_buf, Err);
+    if (LDPC_Check((uint8_t  *) rx_buf) == 0) {
       success = true;
     }
   }
 
   if (success) {
-    RF_last_rssi = RxRSSI;
-    rx_packets_counter++;
+    RF_Enqueue(rx_buf, OGNTP_PAYLOAD_SIZE, RxRSSI, RF_PROTOCOL_OGNTP);
   }
 
 #endif /* WITH_SI4X32 */
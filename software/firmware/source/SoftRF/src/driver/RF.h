@@ -51,6 +51,25 @@
                              P3I_PAYLOAD_SIZE, FANET_PAYLOAD_SIZE, \
                              UAT978_PAYLOAD_SIZE)
 
+/* Received frames waiting for ParseData(), must be a power of two */
+#if !defined(RF_RX_QUEUE_SIZE)
+#define RF_RX_QUEUE_SIZE  8
+#endif /* RF_RX_QUEUE_SIZE */
+
+/* Rx time slicing between protocols, SX12XX only */
+#define RF_SLICE_PERIOD   1000 /* ms, starts with the #0 time slot */
+#define RF_SLICE_SLOT_MS  400  /* duration of Legacy and OGNTP time slots */
+#define RF_SLICE_MIN_MS   100  /* floor of a protocol's share of the #1 slot */
+#define RF_SLICES_MAX     3
+
+/* values of settings->rx_protocols */
+#define RF_RX_PROTOCOLS_LEGACY  (1 << RF_PROTOCOL_LEGACY)
+#define RF_RX_PROTOCOLS_OGNTP   (1 << RF_PROTOCOL_OGNTP)
+#define RF_RX_PROTOCOLS_FANET   (1 << RF_PROTOCOL_FANET)
+#define RF_RX_PROTOCOLS_ALL     (RF_RX_PROTOCOLS_LEGACY | \
+                                 RF_RX_PROTOCOLS_OGNTP  | \
+                                 RF_RX_PROTOCOLS_FANET)
+
 #define RXADDR {0x31, 0xfa , 0xb6} // Address of this device (4 bytes)
 #define TXADDR {0x31, 0xfa , 0xb6} // Address of device to send to (4 bytes)
 
@@ -62,7 +81,8 @@ enum
   RF_IC_UATM,
   RF_IC_CC13XX,
   RF_DRV_OGN,
-  RF_IC_SX1262
+  RF_IC_SX1262,
+  RF_IC_SIMULATOR
 };
 
 enum
@@ -83,6 +103,28 @@ typedef struct rfchip_ops_struct {
   void (*shutdown)();
 } rfchip_ops_t;
 
+typedef struct rf_rx_frame_struct {
+  uint32_t timestamp; /* millis() of the reception */
+  byte     payload[MAX_PKT_SIZE];
+  uint8_t  size;
+  int8_t   rssi;
+  uint8_t  channel;
+  uint8_t  protocol;
+} rf_rx_frame_t;
+
+typedef struct rf_rx_stats_struct {
+  uint32_t overruns;  /* frames dropped because the queue was full */
+  uint8_t  depth;     /* high watermark of the queue */
+} rf_rx_stats_t;
+
+typedef struct rf_slice_struct {
+  uint8_t  protocol;
+  uint16_t share;   /* ms per period */
+  uint16_t score;   /* decaying count of received frames */
+  uint32_t time;    /* ms spent listening */
+  uint32_t frames;
+} rf_slice_t;
+
 String Bin2Hex(byte *, size_t);
 uint8_t parity(uint32_t);
 
@@ -91,9 +133,14 @@ void    RF_SetChannel(void);
 void    RF_loop(void);
 size_t  RF_Encode(ufo_t *);
 bool    RF_Transmit(size_t, bool);
+bool    RF_Relay(void);
 bool    RF_Receive(void);
+bool    RF_Receive_Next(void);
+void    RF_Receive_Flush(void);
+bool    RF_Enqueue(const byte *, size_t, int8_t, uint8_t);
 void    RF_Shutdown(void);
 uint8_t RF_Payload_Size(uint8_t);
+bool    RF_Decode(uint8_t, void *, ufo_t *, ufo_t *);
 
 extern byte TxBuffer[MAX_PKT_SIZE], RxBuffer[MAX_PKT_SIZE];
 extern unsigned long TxTimeMarker;
@@ -104,5 +151,9 @@ extern size_t (*protocol_encode)(void *, ufo_t *);
 extern bool (*protocol_decode)(void *, ufo_t *, ufo_t *);
 
 extern int8_t RF_last_rssi;
+extern uint8_t RF_last_protocol;
+extern rf_rx_stats_t RF_rx_stats;
+extern rf_slice_t RF_slices[RF_SLICES_MAX];
+extern uint8_t RF_slices_count;
 
 #endif /* RFHELPER_H */
@@ -747,6 +747,7 @@ const SoC_ops_t CC13XX_ops = {
   NULL,
   NULL, /* CC13XX has no built-in USB */
   NULL,
+  NULL,
   CC13XX_Display_setup,
   CC13XX_Display_loop,
   CC13XX_Display_fini,
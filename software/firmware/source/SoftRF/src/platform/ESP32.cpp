@@ -1123,6 +1123,9 @@ static bool ESP32_Baro_setup()
 
 static void ESP32_UATSerial_begin(unsigned long baud)
 {
+  /* room for a few ms of 2 Mbps UAT traffic between two uatm_receive() */
+  UATSerial.setRxBufferSize(UAT_RX_BUFFER_SIZE);
+
   /* open Standalone's I2C/UATSerial port */
   UATSerial.begin(baud, SERIAL_IN_BITS, SOC_GPIO_PIN_CE, SOC_GPIO_PIN_PWR);
 }
@@ -1252,6 +1255,7 @@ const SoC_ops_t ESP32_ops = {
   &ESP32_Bluetooth_ops,
   NULL,
   NULL,
+  NULL,
   ESP32_Display_setup,
   ESP32_Display_loop,
   ESP32_Display_fini,
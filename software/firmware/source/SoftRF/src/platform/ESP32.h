@@ -36,6 +36,7 @@
 #define SoftwareSerial          HardwareSerial
 #define swSer                   Serial1
 #define UATSerial               Serial2
+#define UAT_RX_BUFFER_SIZE      2048
 #define EEPROM_commit()         EEPROM.commit()
 
 #define isValidFix()            isValidGNSSFix()
@@ -60,6 +61,8 @@
 #define uni_numPixels()         strip.PixelCount()
 #define uni_Color(r,g,b)        RgbColor(r,g,b)
 #define color_t                 RgbColor
+/* I2S with DMA, Show() neither blocks nor masks interrupts */
+#define LED_RING_ASYNC
 
 extern NeoPixelBus<NeoGrbFeature, Neo800KbpsMethod> strip;
 #else /* USE_ADAFRUIT_NEO_LIBRARY */
@@ -230,6 +233,10 @@ struct rst_info {
 #define USE_TFT
 //#define USE_NMEA_CFG
 #define USE_BASICMAC
+#define USE_FISB
+#define USE_RELAY
+#define USE_PROFILER
+//#define USE_GNSS_UBX          /* binary UBX-NAV-PVT input of u-blox 7 and newer */
 
 //#define EXCLUDE_GNSS_UBLOX    /* Neo-6/7/8 */
 #define ENABLE_UBLOX_RFS        /* revert factory settings (when necessary)  */
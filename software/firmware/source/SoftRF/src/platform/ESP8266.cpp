@@ -416,6 +416,7 @@ const SoC_ops_t ESP8266_ops = {
   NULL, /* ESP8266 has no built-in Bluetooth */
   NULL, /* ESP8266 has no built-in USB */
   NULL,
+  NULL,
   ESP8266_Display_setup,
   ESP8266_Display_loop,
   ESP8266_Display_fini,
@@ -30,6 +30,7 @@
 #include "../protocol/data/NMEA.h"
 #include "../protocol/data/GDL90.h"
 #include "../protocol/data/D1090.h"
+#include "../system/Tickless.h"
 
 #include <innerWdt.h>
 #include <lorawan_port.h>
@@ -413,6 +414,9 @@ static float PSoC4_Battery_voltage()
 
 void PSoC4_GNSS_PPS_Interrupt_handler() {
   PPS_TimeMarker = millis();
+#if defined(USE_TICKLESS)
+  Tickless_Event();
+#endif /* USE_TICKLESS */
 }
 
 static unsigned long PSoC4_get_PPS_TimeMarker() {
@@ -610,6 +614,7 @@ const SoC_ops_t PSoC4_ops = {
   NULL, /* PSoC4 has no built-in Bluetooth */
   NULL, /* PSoC4 has no built-in USB */
   &PSoC4_UART_ops,
+  NULL,
   PSoC4_Display_setup,
   PSoC4_Display_loop,
   PSoC4_Display_fini,
@@ -164,6 +164,7 @@ struct rst_info {
 #if defined(CubeCell_GPS)
 #define USE_OLED                 //  +    kb
 #endif
+//#define USE_TICKLESS           //  +    kb
 
 /* trade performance for flash memory usage (-4 Kb) */
 #define cosf(x)                 cos  ((double) (x))
@@ -49,6 +49,9 @@
 #include <TinyGPS++.h>
 #if !defined(EXCLUDE_MAVLINK)
 #include <aircraft.h>
+#include <uat.h>
+#include <fec.h>
+#include <fec/rs.h>
 #endif /* EXCLUDE_MAVLINK */
 #include "../driver/RF.h"
 #include "../driver/LED.h"
@@ -63,6 +66,12 @@
 #include "../driver/EPD.h"
 #include "../driver/Battery.h"
 #include "../driver/Bluetooth.h"
+#include "../system/Recorder.h"
+#include "../protocol/data/FISB.h"
+#include "../system/Relay.h"
+#include "../system/Profile.h"
+#include "../system/Export.h"
+#include "../system/Position.h"
 
 #include "TCPServer.h"
 
@@ -70,6 +79,9 @@
 #include <sys/select.h>
 
 #include <iostream>
+#include <fstream>
+#include <vector>
+#include <time.h>
 
 #include <ArduinoJson.h>
 
@@ -210,6 +222,7 @@ ui_settings_t *ui;
 #include <sys/ioctl.h>
 
 static uint32_t SerialNumber = 0;
+static bool     RPi_Sim      = false;
 
 void RPi_SerialNumber(void)
 {
@@ -275,10 +288,14 @@ static void RPi_setup()
   eeprom_block.field.settings.no_track      = false;
   eeprom_block.field.settings.power_save    = POWER_SAVE_NONE;
   eeprom_block.field.settings.freq_corr     = 0;
+  eeprom_block.field.settings.rx_protocols  = 0;
 
   ui = &ui_settings;
 
-  RPi_SerialNumber();
+  /* off-line replay has to run on any Linux host */
+  if (!RPi_Sim) {
+    RPi_SerialNumber();
+  }
 }
 
 static void RPi_post_init()
@@ -330,7 +347,7 @@ static void RPi_reset()
 
 static uint32_t RPi_getChipId()
 {
-  uint32_t id = SerialNumber ? SerialNumber : gethostid();
+  uint32_t id = SerialNumber ? SerialNumber : (RPi_Sim ? 0 : gethostid());
 
   return DevID_Mapper(id);
 }
@@ -486,6 +503,95 @@ static void RPi_Button_fini()
   /* TODO */
 }
 
+#if defined(USE_RECORDER)
+static const char *RPi_Recorder_file = RPI_RECORDER_FILE;
+static FILE *RPi_Recorder_fp = NULL;
+static bool RPi_Recorder_readonly = false; /* export and replay */
+
+static uint32_t RPi_Recorder_setup()
+{
+  long size = 0;
+
+  RPi_Recorder_fp = fopen(RPi_Recorder_file,
+                          RPi_Recorder_readonly ? "rb" : "r+b");
+
+  if (RPi_Recorder_fp != NULL) {
+    fseek(RPi_Recorder_fp, 0, SEEK_END);
+    size = ftell(RPi_Recorder_fp);
+  } else if (!RPi_Recorder_readonly) {
+    /* only recording makes a new image */
+    RPi_Recorder_fp = fopen(RPi_Recorder_file, "w+b");
+  }
+
+  if (RPi_Recorder_fp == NULL) {
+    fprintf( stderr, "Unable to open flight recorder file %s\n", RPi_Recorder_file );
+    return 0;
+  }
+
+  if (RPi_Recorder_readonly) {
+    return (uint32_t) size;
+  }
+
+  /* new image reads back as erased flash */
+  if (size < 2 * RECORDER_SECTOR_SIZE) {
+    uint8_t sector[RECORDER_SECTOR_SIZE];
+
+    memset(sector, 0xFF, sizeof(sector));
+    fseek(RPi_Recorder_fp, 0, SEEK_SET);
+    for (size = 0; size < RPI_RECORDER_SIZE; size += sizeof(sector)) {
+      fwrite(sector, sizeof(sector), 1, RPi_Recorder_fp);
+    }
+    fflush(RPi_Recorder_fp);
+  }
+
+  return (uint32_t) size;
+}
+
+static void RPi_Recorder_fini()
+{
+  if (RPi_Recorder_fp != NULL) {
+    fclose(RPi_Recorder_fp);
+    RPi_Recorder_fp = NULL;
+  }
+}
+
+static bool RPi_Recorder_erase(uint32_t addr)
+{
+  uint8_t sector[RECORDER_SECTOR_SIZE];
+
+  memset(sector, 0xFF, sizeof(sector));
+
+  return fseek(RPi_Recorder_fp, addr, SEEK_SET) == 0 &&
+         fwrite(sector, sizeof(sector), 1, RPi_Recorder_fp) == 1;
+}
+
+static bool RPi_Recorder_write(uint32_t addr, const uint8_t *buffer, size_t size)
+{
+  bool rval = fseek(RPi_Recorder_fp, addr, SEEK_SET) == 0 &&
+              fwrite(buffer, size, 1, RPi_Recorder_fp) == 1;
+
+  fflush(RPi_Recorder_fp);
+
+  return rval;
+}
+
+static bool RPi_Recorder_read(uint32_t addr, uint8_t *buffer, size_t size)
+{
+  return fseek(RPi_Recorder_fp, addr, SEEK_SET) == 0 &&
+         fread(buffer, size, 1, RPi_Recorder_fp) == 1;
+}
+
+FlashDev_ops_t RPi_Recorder_ops = {
+  "RPi file",
+  RPi_Recorder_setup,
+  RPi_Recorder_fini,
+  RPi_Recorder_erase,
+  RPi_Recorder_write,
+  RPi_Recorder_read,
+  NULL
+};
+#endif /* USE_RECORDER */
+
 const SoC_ops_t RPi_ops = {
   SOC_RPi,
   "RPi",
@@ -514,6 +620,11 @@ const SoC_ops_t RPi_ops = {
   NULL,
   NULL,
   NULL,
+#if defined(USE_RECORDER)
+  &RPi_Recorder_ops,
+#else
+  NULL,
+#endif /* USE_RECORDER */
   RPi_Display_setup,
   RPi_Display_loop,
   RPi_Display_fini,
@@ -543,6 +654,220 @@ static bool inputAvailable()
   return (FD_ISSET(0, &fds));
 }
 
+/*
+ * Simulated RF IC for off-line replay of $PSRFI logs.
+ * Frames are taken from the replay input instead of the air and
+ * go through the regular protocol decoders and traffic pipeline.
+ * The replay runs on a virtual clock that follows the time stamps
+ * of the input, so a log is processed as fast as the host allows.
+ */
+static std::istream *RPi_Sim_input     = NULL;
+static bool          RPi_Sim_eof       = false;
+static bool          RPi_Sim_pending   = false;
+static byte          RPi_Sim_frame[MAX_PKT_SIZE];
+static int8_t        RPi_Sim_rssi      = 0;
+static uint32_t      RPi_Sim_tod       = 0;     /* ms since midnight */
+static bool          RPi_Sim_tod_valid = false;
+
+static struct {
+  uint32_t lines;
+  uint32_t frames;
+  uint32_t decoded;
+  uint32_t errors;
+} RPi_Sim_stats;
+
+static bool (*RPi_Sim_decoder)(void *, ufo_t *, ufo_t *) = NULL;
+
+static bool RPi_Sim_decode(void *buffer, ufo_t *this_aircraft, ufo_t *fop)
+{
+  bool rval = RPi_Sim_decoder && (*RPi_Sim_decoder)(buffer, this_aircraft, fop);
+
+  if (rval) {
+    RPi_Sim_stats.decoded++;
+  }
+
+  return rval;
+}
+
+static bool RPi_Sim_probe()
+{
+  return RPi_Sim;
+}
+
+static void RPi_Sim_setup()
+{
+  switch (settings->rf_protocol)
+  {
+  case RF_PROTOCOL_OGNTP:
+    protocol_encode = &ogntp_encode;
+    RPi_Sim_decoder = &ogntp_decode;
+    break;
+  case RF_PROTOCOL_P3I:
+    protocol_encode = &p3i_encode;
+    RPi_Sim_decoder = &p3i_decode;
+    break;
+  case RF_PROTOCOL_FANET:
+    protocol_encode = &fanet_encode;
+    RPi_Sim_decoder = &fanet_decode;
+    break;
+  case RF_PROTOCOL_ADSB_UAT:
+    protocol_encode = &uat978_encode;
+    RPi_Sim_decoder = &uat978_decode;
+    break;
+  case RF_PROTOCOL_LEGACY:
+  default:
+    protocol_encode = &legacy_encode;
+    RPi_Sim_decoder = &legacy_decode;
+    break;
+  }
+
+  protocol_decode = &RPi_Sim_decode;
+}
+
+static void RPi_Sim_channel(uint8_t channel)
+{
+  /* NOP */
+}
+
+static bool RPi_Sim_receive()
+{
+  if (!RPi_Sim_pending) {
+    return false;
+  }
+
+  RF_Enqueue(RPi_Sim_frame, sizeof(RPi_Sim_frame), RPi_Sim_rssi,
+             settings->rf_protocol);
+  RPi_Sim_pending = false;
+
+  return true;
+}
+
+static void RPi_Sim_transmit()
+{
+  /* ownship frames are not looped back into the replay */
+}
+
+static void RPi_Sim_shutdown()
+{
+  /* NOP */
+}
+
+const rfchip_ops_t RPi_Sim_ops = {
+  RF_IC_SIMULATOR,
+  "SIM",
+  RPi_Sim_probe,
+  RPi_Sim_setup,
+  RPi_Sim_channel,
+  RPi_Sim_receive,
+  RPi_Sim_transmit,
+  RPi_Sim_shutdown
+};
+
+static void RPi_Sim_Advance(uint32_t tod)
+{
+  if (RPi_Sim_tod_valid) {
+    if (tod < RPi_Sim_tod) {
+      if (RPi_Sim_tod - tod < 43200000UL) {
+        /* out of order time stamp, keep the clock monotonic */
+        return;
+      }
+      /* midnight roll-over */
+      tod += 86400000UL;
+    }
+    advanceVirtualClock(tod - RPi_Sim_tod);
+  }
+
+  RPi_Sim_tod       = tod % 86400000UL;
+  RPi_Sim_tod_valid = true;
+}
+
+/* $GPRMC and $GPGGA sentences carry the UTC time of the fix */
+static void RPi_Sim_NMEA_Time(const char *str, int len)
+{
+  const char *t = str + 7;
+
+  if (len < 14 ||
+      (strncmp(str + 3, "RMC,", 4) && strncmp(str + 3, "GGA,", 4))) {
+    return;
+  }
+
+  for (int i=0; i < 6; i++) {
+    if (!isdigit(t[i])) {
+      return;
+    }
+  }
+
+  uint32_t tod = ((t[0] - '0') * 10 + (t[1] - '0')) * 3600000UL +
+                 ((t[2] - '0') * 10 + (t[3] - '0')) *   60000UL +
+                 ((t[4] - '0') * 10 + (t[5] - '0')) *    1000UL;
+
+  if (t[6] == '.') {
+    tod += (uint32_t) (atof(t + 6) * 1000);
+  }
+
+  RPi_Sim_Advance(tod);
+}
+
+/* $PSRFI,<unix time>,<hex frame>,<RSSI> as produced by ParseData() */
+static void RPi_Sim_PSRFI(const char *str)
+{
+  unsigned long timestamp;
+  char hex[2 * 64 + 1];
+  int rssi = 0;
+
+  if (sscanf(str, "$PSRFI,%lu,%128[0-9A-Fa-f],%d", &timestamp, hex, &rssi) < 2) {
+    RPi_Sim_stats.errors++;
+    return;
+  }
+
+  RPi_Sim_Advance((timestamp % 86400UL) * 1000UL);
+
+  size_t size = strlen(hex) / 2;
+  if (size > sizeof(RPi_Sim_frame)) {
+    size = sizeof(RPi_Sim_frame);
+  }
+
+  memset(RPi_Sim_frame, 0, sizeof(RPi_Sim_frame));
+  for (size_t i=0; i < size; i++) {
+    unsigned int val;
+    sscanf(hex + 2 * i, "%2x", &val);
+    RPi_Sim_frame[i] = (byte) val;
+  }
+
+  RPi_Sim_rssi    = (int8_t) rssi;
+  RPi_Sim_pending = true;
+  RPi_Sim_stats.frames++;
+}
+
+static bool RPi_ReadLine(std::string &line)
+{
+  if (RPi_Sim_input == NULL) {
+    if (inputAvailable()) {
+      std::getline(std::cin, line);
+      return true;
+    }
+    return false;
+  }
+
+  if (!std::getline(*RPi_Sim_input, line)) {
+    RPi_Sim_eof = true;
+    return false;
+  }
+
+  RPi_Sim_stats.lines++;
+
+  if (line.compare(0, 7, "$PSRFI,") == 0) {
+    RPi_Sim_PSRFI(line.c_str());
+    return false;
+  }
+
+  if (line[0] == '$' && line[1] == 'G') {
+    RPi_Sim_NMEA_Time(line.c_str(), line.length());
+  }
+
+  return true;
+}
+
 static void parseNMEA(const char *str, int len)
 {
   // NMEA input
@@ -578,10 +903,26 @@ static void parseNMEA(const char *str, int len)
   }
 }
 
+/* a SOFTRF message sets up again only what its settings have changed */
+static void RPi_Settings(JsonObject& root)
+{
+  settings_t prev = *settings;
+
+  parseSettings(root);
+
+  uint8_t changes = EEPROM_changes(&prev, settings);
+
+  if (changes & SETTINGS_CHANGED_RADIO) {
+    RF_setup();
+  }
+  if (changes & SETTINGS_CHANGED_TRAFFIC) {
+    Traffic_setup();
+  }
+}
+
 static void RPi_PickGNSSFix()
 {
-  if (inputAvailable()) {
-    std::getline(std::cin, input_line);
+  if (RPi_ReadLine(input_line)) {
     const char *str = input_line.c_str();
     int len = input_line.length();
 
@@ -602,10 +943,7 @@ static void RPi_PickGNSSFix()
         if (!strcmp(msg_class_s,"TPV")) { // "TPV"
           parseTPV(root);
         } else if (!strcmp(msg_class_s,"SOFTRF")) {
-          parseSettings(root);
-
-          RF_setup();
-          Traffic_setup();
+          RPi_Settings(root);
         }
       }
 
@@ -621,7 +959,7 @@ static void RPi_PickGNSSFix()
 
       jsonBuffer.clear();
 
-      if ((time(NULL) - now()) > 3) {
+      if (!RPi_Sim && (time(NULL) - now()) > 3) {
         hasValidGPSDFix = false;
       }
     }
@@ -648,10 +986,7 @@ static void RPi_ReadTraffic()
         const char *msg_class_s = msg_class.as<char*>();
 
         if (!strcmp(msg_class_s,"SOFTRF")) {
-          parseSettings(root);
-
-          RF_setup();
-          Traffic_setup();
+          RPi_Settings(root);
         }
       }
 
@@ -678,6 +1013,16 @@ static void RPi_ReadTraffic()
     } else if (str[0] == 'q') {
       if (len >= 4 && str[1] == 'u' && str[2] == 'i' && str[3] == 't') {
         Traffic_TCP_Server.detach();
+        fprintf( stderr, "Traffic reports: %u, in range: %u, box updates: %u\n",
+                 JSON_filter_stats.reports, JSON_filter_stats.passed,
+                 JSON_filter_stats.updates);
+#if defined(USE_PROFILER)
+        char profile[2048];
+
+        if (Profile_JSON(profile, sizeof(profile)) > 0) {
+          fprintf( stderr, "Profile: %s\n", profile );
+        }
+#endif /* USE_PROFILER */
         fprintf( stderr, "Program termination.\n" );
         exit(EXIT_SUCCESS);
       }
@@ -707,7 +1052,10 @@ void normal_loop()
 
     bool success = RF_Receive();
 
-    if (success && isValidFix()) ParseData();
+    if (success) {
+      /* traffic is of no use until own position is known */
+      if (isValidFix()) ParseData(); else RF_Receive_Flush();
+    }
 
     if (isValidFix()) {
       Traffic_loop();
@@ -729,6 +1077,14 @@ void normal_loop()
 
     SoC->Display_loop();
 
+#if defined(USE_RECORDER)
+    Recorder_loop();
+#endif /* USE_RECORDER */
+
+#if defined(USE_FISB)
+    FISB_loop();
+#endif /* USE_FISB */
+
     ClearExpired();
 }
 
@@ -761,6 +1117,7 @@ void relay_loop()
             printf("%s\n", str.c_str());
 #endif
             Container[i] = EmptyFO;
+            Traffic_Rank_Update(i);
           }
         }
       } else if (isValidFix() &&
@@ -770,11 +1127,26 @@ void relay_loop()
                  Container[i].altitude  != 0.0 &&
                  Container[i].distance < (ALARM_ZONE_NONE * 2) ) {
 
+#if defined(USE_RELAY)
+        /* same report may come in from several feeds */
+        uint32_t key = RELAY_KEY(Container[i].addr, Container[i].addr_type,
+                                 Container[i].timestamp);
+
+        if (Relay_Seen(key)) {
+          Container[i] = EmptyFO;
+          Traffic_Rank_Update(i);
+          continue;
+        }
+#endif /* USE_RELAY */
+
         fo = Container[i];
         fo.timestamp = now(); /* GNSS date&time */
 
         /* Follow duty cycle rule */
         if (RF_Transmit(RF_Encode(&fo), true /* false */)) {
+#if defined(USE_RELAY)
+          Relay_Mark(key);
+#endif /* USE_RELAY */
 #if 0
           printf("%06X %f %f %f %d %d %d\n",
               fo.addr,
@@ -786,6 +1158,7 @@ void relay_loop()
               fo.aircraft_type);
 #endif
           Container[i] = EmptyFO;
+          Traffic_Rank_Update(i);
         }
       }
     }
@@ -905,8 +1278,308 @@ void * traffic_tcpserv_loop(void * m)
   Traffic_TCP_Server.receive();
 }
 
-int main()
+#if defined(USE_RECORDER)
+/*
+ * Feed flight recorder log back through the traffic pipeline,
+ * ownship records drive the clock and the export.
+ */
+static void RPi_Recorder_Replay(uint8_t type, ufo_t *fop)
+{
+  if (type == RECORDER_OWNSHIP) {
+    setTime(fop->timestamp);
+
+    ThisAircraft.timestamp = fop->timestamp;
+    ThisAircraft.latitude  = fop->latitude;
+    ThisAircraft.longitude = fop->longitude;
+    ThisAircraft.altitude  = fop->altitude;
+    ThisAircraft.course    = fop->course;
+    ThisAircraft.speed     = fop->speed;
+    ThisAircraft.vs        = fop->vs;
+
+    hasValidGPSDFix = true;
+
+    for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+      if (Container[i].addr) {
+        Traffic_Update(&Container[i]);
+        Traffic_Rank_Update(i);
+      }
+    }
+
+    NMEA_Position();
+    NMEA_Export();
+    GDL90_Export();
+    D1090_Export();
+
+    ClearExpired();
+  } else {
+    fo = *fop;
+    Traffic_Update(&fo);
+    Traffic_Add(&fo);
+  }
+}
+
+static void RPi_Recorder_Tool(int mode)
 {
+  unsigned int count;
+
+  hw_info.soc = SoC_setup();
+
+  if (!Recorder_setup()) {
+    fprintf( stderr, "Unable to open flight recorder log %s\n", RPi_Recorder_file );
+    exit(EXIT_FAILURE);
+  }
+
+  switch (mode)
+  {
+  case 'i':
+    count = Recorder_Export(RECORDER_EXPORT_IGC, NMEA_UART);
+    break;
+  case 'c':
+    count = Recorder_Export(RECORDER_EXPORT_CSV, NMEA_UART);
+    break;
+  case 'r':
+  default:
+    ThisAircraft.addr = SoC->getChipId() & 0x00FFFFFF;
+    ThisAircraft.aircraft_type = settings->aircraft_type;
+    ThisAircraft.protocol = settings->rf_protocol;
+
+    Traffic_setup();
+    NMEA_setup();
+
+    count = Recorder_Read(RPi_Recorder_Replay);
+    break;
+  }
+
+  Recorder_fini();
+
+  fprintf( stderr, "%u records of %s are processed.\n", count, RPi_Recorder_file );
+}
+#endif /* USE_RECORDER */
+
+static void RPi_Sim_Tool(const char *file)
+{
+  std::ifstream sim_file;
+  struct timespec start, stop;
+
+  if (strcmp(file, "-")) {
+    sim_file.open(file);
+    if (!sim_file.is_open()) {
+      fprintf( stderr, "Unable to open replay input %s\n", file );
+      exit(EXIT_FAILURE);
+    }
+    RPi_Sim_input = &sim_file;
+  } else {
+    RPi_Sim_input = &std::cin;
+  }
+
+  RPi_Sim = true;
+  useVirtualClock(true);
+
+  hw_info.soc = SoC_setup();
+
+  rf_chip = &RPi_Sim_ops;
+  hw_info.rf = RF_setup();
+
+  ThisAircraft.addr = SoC->getChipId() & 0x00FFFFFF;
+  ThisAircraft.aircraft_type = settings->aircraft_type;
+  ThisAircraft.protocol = settings->rf_protocol;
+  ThisAircraft.stealth  = settings->stealth;
+  ThisAircraft.no_track = settings->no_track;
+
+  Traffic_setup();
+  NMEA_setup();
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  while (!RPi_Sim_eof) {
+    normal_loop();
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+
+  double elapsed = (stop.tv_sec - start.tv_sec) +
+                   (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  fprintf( stderr, "%u lines, %u frames (%u decoded, %u malformed), "
+                   "%.1f s of log in %.3f s, %.0f frames/s\n",
+           RPi_Sim_stats.lines, RPi_Sim_stats.frames,
+           RPi_Sim_stats.decoded, RPi_Sim_stats.errors,
+           millis() / 1000.0, elapsed,
+           elapsed > 0 ? RPi_Sim_stats.frames / elapsed : 0.0 );
+}
+
+/*
+ * UAT downlink FEC check: a corpus of Basic and Long frames is run
+ * through correct_adsb_frame() clean and with byte errors injected,
+ * next to the plain long-then-short decode as a reference.
+ */
+#define FEC_BENCH_ROUNDS    20
+
+static void *RPi_FEC_rs_long;
+static void *RPi_FEC_rs_short;
+
+static int RPi_FEC_Reference(uint8_t *to, int *rs_errors)
+{
+  int n_corrected = decode_rs_char(RPi_FEC_rs_long, to, NULL, 0);
+  if (n_corrected >= 0 && n_corrected <= 7 && (to[0]>>3) != 0) {
+    *rs_errors = n_corrected;
+    return 2;
+  }
+
+  n_corrected = decode_rs_char(RPi_FEC_rs_short, to, NULL, 0);
+  if (n_corrected >= 0 && n_corrected <= 6 && (to[0]>>3) == 0) {
+    *rs_errors = n_corrected;
+    return 1;
+  }
+
+  *rs_errors = 9999;
+  return -1;
+}
+
+static void RPi_FEC_Bench(int count)
+{
+  std::vector<uint8_t> clean(count * LONG_FRAME_BYTES);
+  std::vector<uint8_t> noisy(count * LONG_FRAME_BYTES);
+  uint8_t frame[LONG_FRAME_BYTES];
+
+  RPi_FEC_rs_long  = init_rs_char(8, 0x187, 120, 1, 14, 207);
+  RPi_FEC_rs_short = init_rs_char(8, 0x187, 120, 1, 12, 225);
+
+  init_fec();
+  srandom(1);
+
+  for (int i = 0; i < count; i++) {
+    uint8_t *f = &clean[i * LONG_FRAME_BYTES];
+    bool is_long = (i & 1);
+    int len = is_long ? LONG_FRAME_BYTES : SHORT_FRAME_BYTES;
+
+    /* a Basic frame is followed by whatever the receiver picks up next */
+    for (int j = 0; j < LONG_FRAME_BYTES; j++) {
+      f[j] = random();
+    }
+
+    if (is_long) {
+      f[0] |= 0x08;
+      encode_rs_char(RPi_FEC_rs_long, f, f + LONG_FRAME_DATA_BYTES);
+    } else {
+      f[0] &= 0x07;
+      encode_rs_char(RPi_FEC_rs_short, f, f + SHORT_FRAME_DATA_BYTES);
+    }
+
+    /* 1..6 byte errors, every fourth frame is beyond repair */
+    uint8_t *n = &noisy[i * LONG_FRAME_BYTES];
+    int errors = (i % 4 == 3) ? 10 : 1 + (i / 2) % 6;
+
+    memcpy(n, f, LONG_FRAME_BYTES);
+    for (int e = 0; e < errors; e++) {
+      n[random() % len] ^= 1 + random() % 255;
+    }
+  }
+
+  for (int pass = 0; pass < 4; pass++) {
+    const std::vector<uint8_t> &corpus = (pass & 1) ? noisy : clean;
+    bool fast = (pass < 2);
+    unsigned int valid = 0, corrected = 0;
+    struct timespec start, stop;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int round = 0; round < FEC_BENCH_ROUNDS; round++) {
+      for (int i = 0; i < count; i++) {
+        int rs_errors;
+        int frame_type;
+
+        memcpy(frame, &corpus[i * LONG_FRAME_BYTES], LONG_FRAME_BYTES);
+        frame_type = fast ? correct_adsb_frame(frame, &rs_errors) :
+                            RPi_FEC_Reference(frame, &rs_errors);
+        if (frame_type > 0) {
+          valid++;
+          corrected += rs_errors;
+        }
+      }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    double elapsed = (stop.tv_sec - start.tv_sec) +
+                     (stop.tv_nsec - start.tv_nsec) / 1e9;
+    unsigned int frames = count * FEC_BENCH_ROUNDS;
+
+    fprintf( stderr, "%-9s %-5s: %u frames, %u valid, %u bytes corrected, "
+                     "%.3f s, %.0f frames/s\n",
+             fast ? "fast path" : "reference", (pass & 1) ? "noisy" : "clean",
+             frames, valid, corrected, elapsed,
+             elapsed > 0 ? frames / elapsed : 0.0 );
+  }
+
+  free_rs_char(RPi_FEC_rs_long);
+  free_rs_char(RPi_FEC_rs_short);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  const char *sim_file = NULL;
+  int fec_frames = 0;
+#if defined(USE_RECORDER)
+  int rec_mode = 0;
+#define RPI_GETOPT_STRING   "s:u:r:i:c:"
+#else
+#define RPI_GETOPT_STRING   "s:u:"
+#endif /* USE_RECORDER */
+
+  /*
+   * -s <file> : replay $PSRFI and NMEA log off-line, '-' stands for stdin
+   * -u <n>    : UAT frame FEC benchmark over a corpus of n frames
+   * -r <file> : replay flight recorder log through the traffic pipeline
+   * -i <file> : export ownship track from the log as IGC file
+   * -c <file> : export ownship and traffic records from the log as CSV
+   */
+  while ((opt = getopt(argc, argv, RPI_GETOPT_STRING)) != -1) {
+    switch (opt)
+    {
+    case 's':
+      sim_file = optarg;
+      break;
+    case 'u':
+      fec_frames = atoi(optarg);
+      break;
+#if defined(USE_RECORDER)
+    case 'r':
+    case 'i':
+    case 'c':
+      rec_mode = opt;
+      RPi_Recorder_file = optarg;
+      RPi_Recorder_readonly = true;
+      break;
+#endif /* USE_RECORDER */
+    default:
+      fprintf( stderr, "Usage: %s [-s <replay log file>] [-u <frames>]"
+#if defined(USE_RECORDER)
+                       " [-r | -i | -c <recorder log file>]"
+#endif /* USE_RECORDER */
+                       "\n", argv[0] );
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (sim_file) {
+    RPi_Sim_Tool(sim_file);
+    exit(EXIT_SUCCESS);
+  }
+
+  if (fec_frames > 0) {
+    RPi_FEC_Bench(fec_frames);
+    exit(EXIT_SUCCESS);
+  }
+
+#if defined(USE_RECORDER)
+  if (rec_mode) {
+    RPi_Recorder_Tool(rec_mode);
+    exit(EXIT_SUCCESS);
+  }
+#endif /* USE_RECORDER */
+
   // Init GPIO bcm
   if (!bcm2835_init()) {
       fprintf( stderr, "bcm2835_init() Failed\n\n" );
@@ -961,6 +1634,28 @@ int main()
 
   SoC->post_init();
 
+#if defined(USE_RECORDER)
+  if (Recorder_setup()) {
+    /* flush buffered page on any kind of program termination */
+    atexit(Recorder_fini);
+  }
+#endif /* USE_RECORDER */
+
+#if defined(USE_FISB)
+  FISB_setup();
+#endif /* USE_FISB */
+
+#if defined(USE_RELAY)
+  Relay_setup();
+#endif /* USE_RELAY */
+
+  Export_setup();
+
+#if defined(USE_PROFILER)
+  Profile_setup();
+  Position_Benchmark();
+#endif /* USE_PROFILER */
+
   SoC->WDT_setup();
 
   while (true) {
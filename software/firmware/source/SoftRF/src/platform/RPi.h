@@ -107,6 +107,20 @@ extern TTYSerial Serial2;
 
 #define USE_NMEALIB
 #define USE_EPAPER
+#define USE_RECORDER
+#define USE_FISB
+#define USE_RELAY
+#define USE_PROFILER
+//#define USE_GNSS_UBX          /* binary UBX-NAV-PVT input of u-blox 7 and newer */
+
+#define FISB_CACHE_SIZE       256
+
+/* NMEA_UART goes to stdout */
+#define EXPORT_UART_BPS       0
+
+/* flight recorder log is kept in a file which mimics a raw flash area */
+#define RPI_RECORDER_FILE     "SoftRF.rec"
+#define RPI_RECORDER_SIZE     (1024 * 1024)
 
 #define TAKE_CARE_OF_MILLIS_ROLLOVER
 
@@ -119,6 +133,7 @@ extern TTYSerial Serial2;
 #define EXCLUDE_BMP180
 #define EXCLUDE_BMP280
 #define EXCLUDE_MPL3115A2
+#define EXCLUDE_MS5611
 //#define EXCLUDE_MAVLINK
 
 //#define USE_OGN_RF_DRIVER
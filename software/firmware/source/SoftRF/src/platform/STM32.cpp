@@ -33,6 +33,7 @@
 #include "../protocol/data/NMEA.h"
 #include "../protocol/data/GDL90.h"
 #include "../protocol/data/D1090.h"
+#include "../system/Tickless.h"
 
 #include <STM32LowPower.h>
 
@@ -550,6 +551,9 @@ static float STM32_Battery_voltage()
 
 void STM32_GNSS_PPS_Interrupt_handler() {
   PPS_TimeMarker = millis();
+#if defined(USE_TICKLESS)
+  Tickless_Event();
+#endif /* USE_TICKLESS */
 }
 
 static unsigned long STM32_get_PPS_TimeMarker() {
@@ -753,6 +757,7 @@ const SoC_ops_t STM32_ops = {
 #else
   NULL,
 #endif
+  NULL,
   NULL,
   STM32_Display_setup,
   STM32_Display_loop,
@@ -203,6 +203,13 @@ typedef struct stm32_backup_struct {
 #define USE_SERIAL_DEEP_SLEEP    //  + 12 kb
 //#define USE_BASICMAC           //  +  7 kb
 //#define USE_GNSS_PSM
+#define USE_TICKLESS             //  +  1 kb
+
+/* SX1276 DIO0 is RxDone */
+#define TICKLESS_WAKE_PIN     SOC_GPIO_PIN_DIO0
+/* STM32L073 at 32 MHz, run and sleep modes */
+#define TICKLESS_RUN_UA       5600
+#define TICKLESS_SLEEP_UA     1300
 //#define EXCLUDE_LK8EX1
 
 /* SoftRF/S7xG PFLAU NMEA sentence extension(s) */
@@ -289,6 +296,13 @@ typedef struct stm32_backup_struct {
 #define RFM69_POWER_RATING  1 /* 0 - RFM69xx , 1 - RFM69Hxx */
 //#define WITH_SX1272
 //#define WITH_SI4X32
+#define USE_TICKLESS             //  +  1 kb
+
+/* SX1276 DIO0 is RxDone */
+#define TICKLESS_WAKE_PIN     SOC_GPIO_PIN_DIO0
+/* STM32F103 at 72 MHz, run and sleep modes, peripherals enabled */
+#define TICKLESS_RUN_UA       36000
+#define TICKLESS_SLEEP_UA     14000
 
 #else
 #error "This hardware platform is not supported!"
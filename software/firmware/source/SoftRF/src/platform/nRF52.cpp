@@ -38,6 +38,7 @@
 #include "../protocol/data/NMEA.h"
 #include "../protocol/data/GDL90.h"
 #include "../protocol/data/D1090.h"
+#include "../system/Tickless.h"
 
 typedef volatile uint32_t REG32;
 #define pREG32 (REG32 *)
@@ -328,14 +329,65 @@ static void nRF52_setup()
   }
 }
 
+#if defined(USE_RECORDER)
+/*
+ * Flight recorder shares the flash with USB MSC. The callbacks below
+ * run in the USB task, so that every access to the flash is serialized.
+ */
+static SemaphoreHandle_t nRF52_SPIFlash_mutex = NULL;
+static volatile uint32_t nRF52_msc_TimeMarker = 0;
+static volatile bool     nRF52_msc_active     = false;
+
+static void nRF52_SPIFlash_lock()
+{
+  if (nRF52_SPIFlash_mutex != NULL) {
+    xSemaphoreTake(nRF52_SPIFlash_mutex, portMAX_DELAY);
+  }
+}
+
+static void nRF52_SPIFlash_unlock()
+{
+  if (nRF52_SPIFlash_mutex != NULL) {
+    xSemaphoreGive(nRF52_SPIFlash_mutex);
+  }
+}
+
+static void nRF52_msc_touch()
+{
+  nRF52_msc_TimeMarker = millis();
+  nRF52_msc_active     = true;
+}
+#else
+#define nRF52_SPIFlash_lock()   {}
+#define nRF52_SPIFlash_unlock() {}
+#define nRF52_msc_touch()       {}
+#endif /* USE_RECORDER */
+
+// Callback invoked when received Test Unit Ready command.
+// Hosts keep on polling it for as long as the disk is mounted.
+static bool nRF52_msc_ready_cb (void)
+{
+  nRF52_msc_touch();
+
+  return true;
+}
+
 // Callback invoked when received READ10 command.
 // Copy disk's data to buffer (up to bufsize) and
 // return number of copied bytes (must be multiple of block size)
 static int32_t nRF52_msc_read_cb (uint32_t lba, void* buffer, uint32_t bufsize)
 {
+  bool rval;
+
+  nRF52_msc_touch();
+
   // Note: SPIFLash Bock API: readBlocks/writeBlocks/syncBlocks
   // already include 4K sector caching internally. We don't need to cache it, yahhhh!!
-  return SPIFlash->readBlocks(lba, (uint8_t*) buffer, bufsize/512) ? bufsize : -1;
+  nRF52_SPIFlash_lock();
+  rval = SPIFlash->readBlocks(lba, (uint8_t*) buffer, bufsize/512);
+  nRF52_SPIFlash_unlock();
+
+  return rval ? bufsize : -1;
 }
 
 // Callback invoked when received WRITE10 command.
@@ -343,11 +395,18 @@ static int32_t nRF52_msc_read_cb (uint32_t lba, void* buffer, uint32_t bufsize)
 // return number of written bytes (must be multiple of block size)
 static int32_t nRF52_msc_write_cb (uint32_t lba, uint8_t* buffer, uint32_t bufsize)
 {
+  bool rval;
+
   ledOn(SOC_GPIO_LED_USBMSC);
+  nRF52_msc_touch();
 
   // Note: SPIFLash Bock API: readBlocks/writeBlocks/syncBlocks
   // already include 4K sector caching internally. We don't need to cache it, yahhhh!!
-  return SPIFlash->writeBlocks(lba, buffer, bufsize/512) ? bufsize : -1;
+  nRF52_SPIFlash_lock();
+  rval = SPIFlash->writeBlocks(lba, buffer, bufsize/512);
+  nRF52_SPIFlash_unlock();
+
+  return rval ? bufsize : -1;
 }
 
 // Callback invoked when WRITE10 command is completed (status received and accepted by host).
@@ -355,7 +414,9 @@ static int32_t nRF52_msc_write_cb (uint32_t lba, uint8_t* buffer, uint32_t bufsi
 static void nRF52_msc_flush_cb (void)
 {
   // sync with flash
+  nRF52_SPIFlash_lock();
   SPIFlash->syncBlocks();
+  nRF52_SPIFlash_unlock();
 
   // clear file system's cache to force refresh
 //  fatfs.cacheClear();
@@ -363,6 +424,155 @@ static void nRF52_msc_flush_cb (void)
   ledOff(SOC_GPIO_LED_USBMSC);
 }
 
+#if defined(USE_RECORDER)
+static uint32_t nRF52_Recorder_base = 0;
+static uint32_t nRF52_Recorder_size = 0;  /* 0 - there is no log file */
+
+/*
+ * The log lives in a contiguous file of the FAT volume that is exported
+ * over USB MSC, so that the host sees it as a regular file and nothing
+ * else on the disk is ever touched. The file is created on first use,
+ * after that only sectors within its extent are erased and written
+ * directly, FAT and the directory stay intact.
+ */
+static bool nRF52_Recorder_locate(uint32_t *base, uint32_t *size)
+{
+  uint32_t bgn, end;
+  bool rval = false;
+  File file;
+
+  nRF52_SPIFlash_lock();
+
+  if (fatfs.begin(SPIFlash)) {
+    file = fatfs.open(NRF52_RECORDER_FILE, FILE_READ);
+    if (!file) {
+      /* a spare sector for alignment of the log to erase units */
+      file.createContiguous(NRF52_RECORDER_FILE,
+                            NRF52_RECORDER_SIZE + SFLASH_SECTOR_SIZE);
+    }
+
+    if (file && file.contiguousRange(&bgn, &end)) {
+      uint32_t start = (bgn * 512 + SFLASH_SECTOR_SIZE - 1) &
+                       ~(SFLASH_SECTOR_SIZE - 1);
+      uint32_t stop  = ((end + 1) * 512) & ~(SFLASH_SECTOR_SIZE - 1);
+
+      if (stop > start) {
+        *base = start;
+        *size = stop - start;
+        if (*size > NRF52_RECORDER_SIZE) {
+          *size = NRF52_RECORDER_SIZE;
+        }
+        rval = true;
+      }
+    }
+
+    file.close();
+  }
+
+  nRF52_SPIFlash_unlock();
+
+  return rval;
+}
+
+/* the log file has been located by post_init, SoftSPI on REV_0 is too slow */
+static uint32_t nRF52_Recorder_setup()
+{
+  return nRF52_Recorder_size;
+}
+
+static void nRF52_Recorder_fini()
+{
+  /* NONE */
+}
+
+/*
+ * Nothing is written while USB host makes use of the disk. Once it has
+ * let go of it, the log file has to be where it was: the user is free
+ * to delete it, the recorder stays off until restart then.
+ */
+static bool nRF52_Recorder_busy()
+{
+  uint32_t base, size;
+
+  if (nRF52_Recorder_size == 0) {
+    return true;
+  }
+
+  if (!nRF52_msc_active) {
+    return false;
+  }
+
+  if (millis() - nRF52_msc_TimeMarker < NRF52_MSC_HOLD_TIME) {
+    return true;
+  }
+
+  nRF52_msc_active = false;
+
+  if (!nRF52_Recorder_locate(&base, &size) ||
+      base != nRF52_Recorder_base || size != nRF52_Recorder_size) {
+    nRF52_Recorder_size = 0;
+    return true;
+  }
+
+  return false;
+}
+
+static bool nRF52_Recorder_erase(uint32_t addr)
+{
+  bool rval;
+
+  if (addr >= nRF52_Recorder_size) {
+    return false;
+  }
+
+  nRF52_SPIFlash_lock();
+  rval = SPIFlash->eraseSector((nRF52_Recorder_base + addr) / SFLASH_SECTOR_SIZE);
+  nRF52_SPIFlash_unlock();
+
+  return rval;
+}
+
+static bool nRF52_Recorder_write(uint32_t addr, const uint8_t *buffer, size_t size)
+{
+  bool rval;
+
+  if (addr + size > nRF52_Recorder_size) {
+    return false;
+  }
+
+  nRF52_SPIFlash_lock();
+  rval = SPIFlash->writeBuffer(nRF52_Recorder_base + addr, buffer, size) == size;
+  nRF52_SPIFlash_unlock();
+
+  return rval;
+}
+
+static bool nRF52_Recorder_read(uint32_t addr, uint8_t *buffer, size_t size)
+{
+  bool rval;
+
+  if (addr + size > nRF52_Recorder_size) {
+    return false;
+  }
+
+  nRF52_SPIFlash_lock();
+  rval = SPIFlash->readBuffer(nRF52_Recorder_base + addr, buffer, size) == size;
+  nRF52_SPIFlash_unlock();
+
+  return rval;
+}
+
+FlashDev_ops_t nRF52_Recorder_ops = {
+  "nRF52 SPI flash",
+  nRF52_Recorder_setup,
+  nRF52_Recorder_fini,
+  nRF52_Recorder_erase,
+  nRF52_Recorder_write,
+  nRF52_Recorder_read,
+  nRF52_Recorder_busy
+};
+#endif /* USE_RECORDER */
+
 static void nRF52_post_init()
 {
   /* (Q)SPI flash init */
@@ -392,10 +602,18 @@ static void nRF52_post_init()
     // Set disk vendor id, product id and revision with string up to 8, 16, 4 characters respectively
     usb_msc.setID("SoftRF", "External Flash", "1.0");
 
+#if defined(USE_RECORDER)
+    nRF52_SPIFlash_mutex = xSemaphoreCreateMutex();
+
+    /* before the host can see the disk */
+    nRF52_Recorder_locate(&nRF52_Recorder_base, &nRF52_Recorder_size);
+#endif /* USE_RECORDER */
+
     // Set callback
     usb_msc.setReadWriteCallback(nRF52_msc_read_cb,
                                  nRF52_msc_write_cb,
                                  nRF52_msc_flush_cb);
+    usb_msc.setReadyCallback(nRF52_msc_ready_cb);
 
     // Set disk size, block size should be 512 regardless of spi flash page size
     usb_msc.setCapacity(SPIFlash->size()/512, 512);
@@ -871,6 +1089,9 @@ static float nRF52_Battery_voltage()
 
 void nRF52_GNSS_PPS_Interrupt_handler() {
   PPS_TimeMarker = millis();
+#if defined(USE_TICKLESS)
+  Tickless_Event();
+#endif /* USE_TICKLESS */
 }
 
 static unsigned long nRF52_get_PPS_TimeMarker() {
@@ -1101,6 +1322,11 @@ const SoC_ops_t nRF52_ops = {
   &nRF52_Bluetooth_ops,
   &nRF52_USBSerial_ops,
   NULL,
+#if defined(USE_RECORDER)
+  &nRF52_Recorder_ops,
+#else
+  NULL,
+#endif /* USE_RECORDER */
   nRF52_Display_setup,
   nRF52_Display_loop,
   nRF52_Display_fini,
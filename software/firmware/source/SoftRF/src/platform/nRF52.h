@@ -36,6 +36,8 @@
 #define uni_numPixels()         strip.numPixels()
 #define uni_Color(r,g,b)        strip.Color(r,g,b)
 #define color_t                 uint32_t
+/* PWM with EasyDMA, interrupts stay enabled while the ring is updated */
+#define LED_RING_ASYNC
 
 #define snprintf_P              snprintf
 #define EEPROM_commit()         {}
@@ -237,6 +239,21 @@ struct rst_info {
 
 //#define USE_OLED                 //  +    kb
 #define USE_EPAPER                 //  +    kb
+#define USE_RECORDER               //  +    kb
+//#define USE_PROFILER             //  +    kb
+#define USE_TICKLESS               //  +    kb
+
+/* SX1262 raises DIO1 on RxDone */
+#define TICKLESS_WAKE_PIN     SOC_GPIO_PIN_DIO1
+/* nRF52840 running from flash with DC/DC; System ON idle, UARTE receiving */
+#define TICKLESS_RUN_UA       3300
+#define TICKLESS_SLEEP_UA     600
+
+/* flight recorder log, a contiguous file on FAT volume of the external flash */
+#define NRF52_RECORDER_FILE   "/SOFTRF.LOG"
+#define NRF52_RECORDER_SIZE   (512 * 1024)
+/* ms, the log is not written since last access of USB host to the disk */
+#define NRF52_MSC_HOLD_TIME   10000
 
 /* SoftRF/nRF52 PFLAU NMEA sentence extension(s) */
 #define PFLAU_EXT1_FMT  ",%06X,%d,%d,%d,%d"
@@ -25,6 +25,8 @@
 #include "GDL90.h"
 #include "../../driver/EEPROM.h"
 #include "../../TrafficHelper.h"
+#include "../../system/Profile.h"
+#include "../../system/Export.h"
 
 #define ADDR_TO_HEX_STR(s, c) (s += ((c) < 0x10 ? "0" : "") + String((c), HEX))
 
@@ -71,77 +73,76 @@ static void D1090_Out(byte *buf, size_t size)
 
 void D1090_Export()
 {
+  PROFILE_SCOPE(PROFILE_EXPORT_D1090);
+
   frame_data_t df17;
-  float distance;
   String str;
-  time_t this_moment = now();
 
   if (settings->d1090 != D1090_OFF) {
-    for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-      if (Container[i].addr && (this_moment - Container[i].timestamp) <= EXPORT_EXPIRATION_TIME) {
-
-        distance = Container[i].distance;
-
-        if (distance < ALARM_ZONE_NONE) {
-
-          float altitude;
-          /* If the aircraft's data has standard pressure altitude - make use it */
-          if (Container[i].pressure_altitude != 0.0) {
-            altitude = Container[i].pressure_altitude;
-          } else if (ThisAircraft.pressure_altitude != 0.0) {
-            /* If this SoftRF unit is equiped with baro sensor - try to make an adjustment */
-            float altDiff = ThisAircraft.pressure_altitude - ThisAircraft.altitude;
-            altitude = Container[i].altitude + altDiff;
-          } else {
-            /* If no other choice - report GNSS altitude as pressure altitude */
-            altitude = Container[i].altitude;
-          }
-          altitude *= _GPS_FEET_PER_METER;
-
-          df17 = make_air_position_frame(11, Container[i].addr,
-            Container[i].latitude, Container[i].longitude,
-            altitude, CPR_EVEN, DF17);
-
-          str = "*";
-          DF17_FRAME_TO_HEX_STR(str);
-          str += ";\r\n*";
-
-          df17 = make_air_position_frame(11, Container[i].addr,
-            Container[i].latitude, Container[i].longitude,
-            altitude, CPR_ODD, DF17);
-
-          DF17_FRAME_TO_HEX_STR(str);
-          str += ";\r\n*";
-
-          String callsign = String(GDL90_CallSign_Prefix[Container[i].protocol]);
-        
-          ADDR_TO_HEX_STR(callsign, (Container[i].addr >> 16) & 0xFF);
-          ADDR_TO_HEX_STR(callsign, (Container[i].addr >>  8) & 0xFF);
-          ADDR_TO_HEX_STR(callsign, (Container[i].addr      ) & 0xFF);
-
-          callsign.toUpperCase();
-
-          df17 = make_aircraft_identification_frame(Container[i].addr,
-            (unsigned char*) callsign.c_str(),
-            Category_Set_D,
-            AT_TO_GDL90(Container[i].aircraft_type),
-            DF17);
-
-          DF17_FRAME_TO_HEX_STR(str);
-          str += ";\r\n*";
-
-          df17 = make_velocity_frame(Container[i].addr,
-            Container[i].speed * cos(Container[i].course * PI / 180),
-            Container[i].speed * sin(Container[i].course * PI / 180),
-            Container[i].vs,
-            DF17);
-
-          DF17_FRAME_TO_HEX_STR(str);
-          str.toUpperCase();
-          str += ";\r\n";
-
-          D1090_Out((byte *) str.c_str(), str.length());
-        }
+    export_target_t list[MAX_TRACKING_OBJECTS];
+    int count = Export_Begin(EXPORT_SINK_D1090, settings->d1090, list, 0);
+
+    for (int k=0; k < count; k++) {
+      int i = list[k].fop - Container;
+
+      float altitude;
+      /* If the aircraft's data has standard pressure altitude - make use it */
+      if (Container[i].pressure_altitude != 0.0) {
+        altitude = Container[i].pressure_altitude;
+      } else if (ThisAircraft.pressure_altitude != 0.0) {
+        /* If this SoftRF unit is equiped with baro sensor - try to make an adjustment */
+        float altDiff = ThisAircraft.pressure_altitude - ThisAircraft.altitude;
+        altitude = Container[i].altitude + altDiff;
+      } else {
+        /* If no other choice - report GNSS altitude as pressure altitude */
+        altitude = Container[i].altitude;
+      }
+      altitude *= _GPS_FEET_PER_METER;
+
+      df17 = make_air_position_frame(11, Container[i].addr,
+        Container[i].latitude, Container[i].longitude,
+        altitude, CPR_EVEN, DF17);
+
+      str = "*";
+      DF17_FRAME_TO_HEX_STR(str);
+      str += ";\r\n*";
+
+      df17 = make_air_position_frame(11, Container[i].addr,
+        Container[i].latitude, Container[i].longitude,
+        altitude, CPR_ODD, DF17);
+
+      DF17_FRAME_TO_HEX_STR(str);
+      str += ";\r\n*";
+
+      String callsign = String(GDL90_CallSign_Prefix[Container[i].protocol]);
+    
+      ADDR_TO_HEX_STR(callsign, (Container[i].addr >> 16) & 0xFF);
+      ADDR_TO_HEX_STR(callsign, (Container[i].addr >>  8) & 0xFF);
+      ADDR_TO_HEX_STR(callsign, (Container[i].addr      ) & 0xFF);
+
+      callsign.toUpperCase();
+
+      df17 = make_aircraft_identification_frame(Container[i].addr,
+        (unsigned char*) callsign.c_str(),
+        Category_Set_D,
+        AT_TO_GDL90(Container[i].aircraft_type),
+        DF17);
+
+      DF17_FRAME_TO_HEX_STR(str);
+      str += ";\r\n*";
+
+      df17 = make_velocity_frame(Container[i].addr,
+        Container[i].speed * cos(Container[i].course * PI / 180),
+        Container[i].speed * sin(Container[i].course * PI / 180),
+        Container[i].vs,
+        DF17);
+
+      DF17_FRAME_TO_HEX_STR(str);
+      str.toUpperCase();
+      str += ";\r\n";
+
+      if (Export_Admit(EXPORT_SINK_D1090, &list[k], str.length())) {
+        D1090_Out((byte *) str.c_str(), str.length());
       }
     }
   }
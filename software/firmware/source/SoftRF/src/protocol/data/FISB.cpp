@@ -0,0 +1,233 @@
+/*
+ * FISB.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../system/SoC.h"
+#include "../../driver/EEPROM.h"
+#include "FISB.h"
+#include "GDL90.h"
+#include "../../system/Profile.h"
+
+#if defined(USE_FISB)
+
+#include <fec.h>
+#include <uat_decode.h>
+
+fisb_stats_t FISB_stats;
+
+static fisb_product_t FISB_cache[FISB_CACHE_SIZE];
+
+/*
+ * uatm_receive() only hands complete interleaved frames over to here.
+ * De-interleaving, RS correction and cache maintenance are done later,
+ * from FISB_loop(), so that ADS-B frames queued behind a ground uplink
+ * are not held up by them.
+ */
+static uint8_t FISB_queue[FISB_QUEUE_SIZE][UPLINK_FRAME_BYTES];
+static uint8_t FISB_queue_head = 0;
+static uint8_t FISB_queue_tail = 0;
+
+static uint8_t FISB_data[UPLINK_FRAME_BYTES];
+static uint8_t FISB_payload[UPLINK_FRAME_DATA_BYTES];
+static struct uat_uplink_mdb FISB_mdb;
+
+static unsigned int  FISB_export_ndx = 0;
+static unsigned long FISB_ExportTimeMarker = 0;
+
+/* products that are sent as a grid of blocks rather than as text records */
+static bool FISB_isGridded(uint16_t product_id)
+{
+  switch (product_id)
+  {
+  case 63:  /* NEXRAD regional */
+  case 64:  /* NEXRAD CONUS */
+  case 70:  /* icing, low */
+  case 71:  /* icing, high */
+  case 84:  /* cloud tops */
+  case 90:  /* turbulence, low */
+  case 91:  /* turbulence, high */
+  case 103: /* lightning */
+    return true;
+  default:
+    return false;
+  }
+}
+
+static uint32_t FISB_Tile(const struct fisb_apdu *apdu)
+{
+  if (FISB_isGridded(apdu->product_id) && apdu->length >= 3) {
+    /* scale factor and block number */
+    return ((uint32_t) (apdu->data[0] & 0x3F) << 16) |
+           (apdu->data[1] << 8) | apdu->data[2];
+  }
+
+  /* each text record is kept on its own, repeats fold into one entry */
+  return GDL90_calcFCS(0, apdu->data, apdu->length);
+}
+
+static void FISB_Export_Product(const fisb_product_t *product)
+{
+  if (settings->gdl90 == GDL90_OFF) {
+    return;
+  }
+
+  /* re-wrap the product alone into an uplink, a zero header ends the list */
+  memcpy(FISB_payload, product->header, FISB_UPLINK_HEADER_SIZE);
+  memcpy(FISB_payload + FISB_UPLINK_HEADER_SIZE, product->frame, product->length);
+  memset(FISB_payload + FISB_UPLINK_HEADER_SIZE + product->length, 0,
+         FISB_APP_DATA_SIZE - product->length);
+
+  GDL90_Uplink(FISB_payload, sizeof(FISB_payload));
+  FISB_stats.exported++;
+}
+
+static void FISB_Product(const uint8_t *header,
+                         const struct uat_uplink_info_frame *frame)
+{
+  uint32_t tile = FISB_Tile(&frame->fisb);
+  const uint8_t *raw = frame->data - 2; /* include info frame header */
+  uint16_t length = frame->length + 2;
+  unsigned long now_ms = millis();
+  fisb_product_t *product = NULL;
+  fisb_product_t *oldest  = NULL;
+
+  for (int i=0; i < FISB_CACHE_SIZE; i++) {
+    fisb_product_t *entry = &FISB_cache[i];
+
+    if (entry->length == 0) {
+      if (oldest == NULL || oldest->length != 0) {
+        oldest = entry;
+      }
+      continue;
+    }
+
+    if (entry->product_id == frame->fisb.product_id && entry->tile == tile) {
+      product = entry;
+      break;
+    }
+
+    if (oldest == NULL || (oldest->length != 0 &&
+        now_ms - entry->timestamp > now_ms - oldest->timestamp)) {
+      oldest = entry;
+    }
+  }
+
+  if (product) {
+    if (product->length == length && memcmp(product->frame, raw, length) == 0) {
+      product->timestamp = now_ms;
+      return;
+    }
+  } else {
+    product = oldest;
+    if (product->length != 0) {
+      FISB_stats.evicted++;
+    }
+  }
+
+  product->product_id = frame->fisb.product_id;
+  product->tile       = tile;
+  product->timestamp  = now_ms;
+  product->length     = length;
+  memcpy(product->header, header, FISB_UPLINK_HEADER_SIZE);
+  memcpy(product->frame, raw, length);
+
+  FISB_stats.products++;
+
+  FISB_Export_Product(product);
+}
+
+bool FISB_Uplink(const uint8_t *frame)
+{
+  if ((uint8_t) (FISB_queue_head - FISB_queue_tail) >= FISB_QUEUE_SIZE) {
+    FISB_stats.dropped++;
+    PROFILE_COUNT(PROFILE_OVERRUNS, 1);
+    return false;
+  }
+
+  memcpy(FISB_queue[FISB_queue_head % FISB_QUEUE_SIZE], frame, UPLINK_FRAME_BYTES);
+  FISB_queue_head++;
+
+  return true;
+}
+
+void FISB_setup()
+{
+  memset(FISB_cache, 0, sizeof(FISB_cache));
+  memset(&FISB_stats, 0, sizeof(FISB_stats));
+
+  FISB_queue_head = FISB_queue_tail = 0;
+  FISB_export_ndx = 0;
+  FISB_ExportTimeMarker = millis();
+}
+
+void FISB_loop()
+{
+  /* one uplink per pass keeps the loop latency bounded */
+  if (FISB_queue_head != FISB_queue_tail) {
+    int rs_errors;
+
+    FISB_stats.frames++;
+
+    if (correct_uplink_frame(FISB_queue[FISB_queue_tail % FISB_QUEUE_SIZE],
+                             FISB_data, &rs_errors) < 0) {
+      FISB_stats.failed++;
+      PROFILE_COUNT(PROFILE_CRC_ERRORS, 1);
+    } else {
+      FISB_stats.corrected += rs_errors;
+      PROFILE_COUNT(PROFILE_FEC_CORRECTIONS, rs_errors);
+
+      uat_decode_uplink_mdb(FISB_data, &FISB_mdb);
+
+      if (FISB_mdb.app_data_valid) {
+        for (unsigned int i=0; i < FISB_mdb.num_info_frames; i++) {
+          if (FISB_mdb.info_frames[i].is_fisb) {
+            FISB_Product(FISB_data, &FISB_mdb.info_frames[i]);
+          }
+        }
+      }
+    }
+
+    FISB_queue_tail++;
+  }
+
+  /* EFBs that connect later catch up from the cache */
+  if (millis() - FISB_ExportTimeMarker > FISB_EXPORT_INTERVAL) {
+    unsigned int sent = 0;
+
+    for (int n=0; n < FISB_CACHE_SIZE && sent < FISB_EXPORT_BURST; n++) {
+      fisb_product_t *product = &FISB_cache[FISB_export_ndx];
+
+      FISB_export_ndx = (FISB_export_ndx + 1) % FISB_CACHE_SIZE;
+
+      if (product->length == 0) {
+        continue;
+      }
+
+      if (millis() - product->timestamp > FISB_EXPIRATION_TIME) {
+        product->length = 0;
+        continue;
+      }
+
+      FISB_Export_Product(product);
+      sent++;
+    }
+
+    FISB_ExportTimeMarker = millis();
+  }
+}
+
+#endif /* USE_FISB */
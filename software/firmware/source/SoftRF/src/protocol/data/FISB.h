@@ -0,0 +1,67 @@
+/*
+ * FISB.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FISBHELPER_H
+#define FISBHELPER_H
+
+#include "../../../SoftRF.h"
+
+#if defined(USE_FISB)
+
+#include <uat.h>
+
+#if !defined(FISB_CACHE_SIZE)
+#define FISB_CACHE_SIZE         32
+#endif /* FISB_CACHE_SIZE */
+
+#define FISB_QUEUE_SIZE         2       /* raw uplink frames waiting for FEC */
+#define FISB_EXPIRATION_TIME    1800000 /* 30 minutes, in ms */
+#define FISB_EXPORT_INTERVAL    1000    /* ms */
+#define FISB_EXPORT_BURST       4       /* cached products re-sent per interval */
+
+#define FISB_UPLINK_HEADER_SIZE 8
+#define FISB_APP_DATA_SIZE      (UPLINK_FRAME_DATA_BYTES - FISB_UPLINK_HEADER_SIZE)
+
+typedef struct fisb_product_struct {
+  uint16_t  product_id;
+  uint32_t  tile;       /* block number of gridded products, CRC of others */
+  uint32_t  timestamp;  /* millis() of the last reception */
+  uint16_t  length;     /* of the info frame, including its 2 byte header */
+  uint8_t   header[FISB_UPLINK_HEADER_SIZE];  /* of the uplink it came with */
+  uint8_t   frame[FISB_APP_DATA_SIZE];
+} fisb_product_t;
+
+typedef struct fisb_stats_struct {
+  uint32_t frames;
+  uint32_t failed;     /* uncorrectable by RS */
+  uint32_t dropped;    /* queue overrun */
+  uint32_t corrected;  /* bytes */
+  uint32_t products;   /* new or changed ones */
+  uint32_t evicted;
+  uint32_t exported;
+} fisb_stats_t;
+
+void FISB_setup(void);
+void FISB_loop(void);
+bool FISB_Uplink(const uint8_t *);
+
+extern fisb_stats_t FISB_stats;
+
+#endif /* USE_FISB */
+
+#endif /* FISBHELPER_H */
@@ -31,6 +31,8 @@
 #include "../../TrafficHelper.h"
 #include "../radio/Legacy.h"
 #include "NMEA.h"
+#include "../../system/Profile.h"
+#include "../../system/Export.h"
 
 #if defined(ENABLE_AHRS)
 #include "../../AHRS.h"
@@ -422,6 +424,43 @@ static size_t makeFFid(uint8_t *buf)
 }
 #endif
 
+#if defined(USE_FISB)
+
+static uint8_t GDL90_UplinkMsg[GDL90_UPLINK_TOR_SIZE + GDL90_UPLINK_PAYLOAD_SIZE];
+/* flags, id and FCS plus the worst case of every byte escaped */
+static uint8_t GDL90_UplinkBuffer[3 + 2 * (sizeof(GDL90_UplinkMsg) + 2)];
+
+static size_t makeUplink(uint8_t *buf, uint8_t *payload, size_t size)
+{
+  uint8_t *ptr = buf;
+  uint8_t *msg = GDL90_UplinkMsg;
+  uint16_t fcs;
+  uint8_t fcs_lsb, fcs_msb;
+
+  if (size > GDL90_UPLINK_PAYLOAD_SIZE) {
+    size = GDL90_UPLINK_PAYLOAD_SIZE;
+  }
+
+  /* receiver does not report time of reception, all ones mark it invalid */
+  memset(msg, 0xFF, GDL90_UPLINK_TOR_SIZE);
+  memcpy(msg + GDL90_UPLINK_TOR_SIZE, payload, size);
+  memset(msg + GDL90_UPLINK_TOR_SIZE + size, 0, GDL90_UPLINK_PAYLOAD_SIZE - size);
+
+  fcs = GDL90_calcFCS(GDL90_UPLINK_MSG_ID, msg, sizeof(GDL90_UplinkMsg));
+  fcs_lsb = fcs        & 0xFF;
+  fcs_msb = (fcs >> 8) & 0xFF;
+
+  *ptr++ = 0x7E; /* Start flag */
+  *ptr++ = GDL90_UPLINK_MSG_ID;
+  ptr = GDL90_EscapeFilter(ptr, msg, sizeof(GDL90_UplinkMsg));
+  ptr = GDL90_EscapeFilter(ptr, &fcs_lsb, 1);
+  ptr = GDL90_EscapeFilter(ptr, &fcs_msb, 1);
+  *ptr++ = 0x7E; /* Stop flag */
+
+  return(ptr-buf);
+}
+#endif /* USE_FISB */
+
 #define makeOwnershipReport(b,a)  makeType10and20(b, GDL90_OWNSHIP_MSG_ID, a)
 #define makeTrafficReport(b,a)    makeType10and20(b, GDL90_TRAFFIC_MSG_ID, a)
 
@@ -466,45 +505,57 @@ static void GDL90_Out(byte *buf, size_t size)
 
 void GDL90_Export()
 {
+  PROFILE_SCOPE(PROFILE_EXPORT_GDL90);
+
   size_t size;
-  float distance;
-  time_t this_moment = now();
+  size_t reserve = 0;
   uint8_t *buf = (uint8_t *) (sizeof(UDPpacketBuffer) < UDP_PACKET_BUFSIZE ?
                               NMEABuffer : UDPpacketBuffer);
 
   if (settings->gdl90 != GDL90_OFF) {
     size = makeHeartbeat(buf);
     GDL90_Out(buf, size);
+    reserve += size;
 
 #if defined(DO_GDL90_FF_EXT)
     size = makeFFid(buf);
     GDL90_Out(buf, size);
+    reserve += size;
 #endif /* DO_GDL90_FF_EXT */
 
 #if defined(ENABLE_AHRS)
     size = AHRS_GDL90(buf);
     GDL90_Out(buf, size);
+    reserve += size;
 #endif /* ENABLE_AHRS */
 
     if (isValidFix()) {
       size = makeOwnershipReport(buf, &ThisAircraft);
       GDL90_Out(buf, size);
+      reserve += size;
 
       size = makeGeometricAltitude(buf, &ThisAircraft);
       GDL90_Out(buf, size);
+      reserve += size;
 
-      for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-        if (Container[i].addr &&
-           (this_moment - Container[i].timestamp) <= EXPORT_EXPIRATION_TIME) {
+      export_target_t list[MAX_TRACKING_OBJECTS];
+      int count = Export_Begin(EXPORT_SINK_GDL90, settings->gdl90, list, reserve);
 
-          distance = Container[i].distance;
-
-          if (distance < ALARM_ZONE_NONE) {
-            size = makeTrafficReport(buf, &Container[i]);
-            GDL90_Out(buf, size);
-          }
+      for (int k=0; k < count; k++) {
+        size = makeTrafficReport(buf, list[k].fop);
+        if (Export_Admit(EXPORT_SINK_GDL90, &list[k], size)) {
+          GDL90_Out(buf, size);
         }
       }
     }
   }
 }
+
+#if defined(USE_FISB)
+void GDL90_Uplink(uint8_t *payload, size_t size)
+{
+  if (settings->gdl90 != GDL90_OFF) {
+    GDL90_Out(GDL90_UplinkBuffer, makeUplink(GDL90_UplinkBuffer, payload, size));
+  }
+}
+#endif /* USE_FISB */
@@ -121,6 +121,11 @@ typedef struct GDL90_Msg_Traffic {
 
 } __attribute__((packed)) GDL90_Msg_Traffic_t;
 
+#define GDL90_UPLINK_MSG_ID      7
+
+#define GDL90_UPLINK_TOR_SIZE     3   /* Time of Reception, 80 ns units */
+#define GDL90_UPLINK_PAYLOAD_SIZE 432 /* UAT ground uplink payload */
+
 #define GDL90_OWNGEOMALT_MSG_ID  11
 
 typedef struct GDL90_Msg_OwnershipGeometricAltitude {
@@ -161,6 +166,9 @@ extern const uint8_t gdl90_to_aircraft_type[] PROGMEM;
 extern const char *GDL90_CallSign_Prefix[];
 
 void GDL90_Export(void);
+#if defined(USE_FISB)
+void GDL90_Uplink(uint8_t *, size_t);
+#endif /* USE_FISB */
 uint16_t GDL90_calcFCS(uint8_t, uint8_t *, int);
 uint8_t *GDL90_EscapeFilter(uint8_t *, uint8_t *, int);
 
@@ -28,6 +28,8 @@
 #include "../../driver/Sound.h"
 #include "../../driver/Baro.h"
 #include "../../TrafficHelper.h"
+#include "../../system/Recorder.h"
+#include "../../system/Position.h"
 #include "NMEA.h"
 #include "GDL90.h"
 #include "D1090.h"
@@ -43,6 +45,8 @@ StaticJsonBuffer<JSON_BUFFER_SIZE> jsonBuffer;
 
 bool hasValidGPSDFix = false;
 
+json_filter_stats_t JSON_filter_stats = { 0, 0, 0 };
+
 extern eeprom_t eeprom_block;
 extern settings_t *settings;
 
@@ -54,6 +58,101 @@ byte getVal(char c)
      return (byte)(toupper(c)-'A'+10);
 }
 
+/*
+ * dump1090 and PingStation snapshots cover hundreds of km around,
+ * most of that is far out of reach. Positions are checked against a box
+ * around ownship, in 1e-7 degree units, first. Only those inside of it
+ * get distance, bearing and alarm level computed.
+ * The box is a margin larger than the range, so it is only rebuilt
+ * after ownship has moved by more than the margin.
+ */
+#define JSON_METERS_PER_DEG 111320.0
+#define JSON_E7_PER_DEG     10000000L
+#define JSON_E7_LON_SPAN    (360LL * JSON_E7_PER_DEG)
+
+static struct {
+  int32_t lat;
+  int32_t lon;
+  int32_t dlat;        /* half height of the box */
+  int32_t dlon;        /* half width, 0 - all around the pole */
+  int32_t margin_lat;
+  int32_t margin_lon;
+  bool    valid;
+} json_box;
+
+static inline int32_t JSON_E7(float deg)
+{
+  return (int32_t) lround(deg * JSON_E7_PER_DEG);
+}
+
+static inline int32_t JSON_Lon_Diff(int32_t a, int32_t b)
+{
+  int64_t diff = (int64_t) a - b;
+
+  if (diff >  JSON_E7_LON_SPAN / 2) diff -= JSON_E7_LON_SPAN;
+  if (diff < -JSON_E7_LON_SPAN / 2) diff += JSON_E7_LON_SPAN;
+
+  return (int32_t) diff;
+}
+
+static void JSON_Filter_Setup(int32_t lat, int32_t lon)
+{
+  double half_deg = (JSON_FILTER_RANGE + JSON_FILTER_MARGIN) / JSON_METERS_PER_DEG;
+  double margin_deg = JSON_FILTER_MARGIN / JSON_METERS_PER_DEG;
+  /* meridians converge, take the edge of the box that is closer to the pole */
+  double edge_deg = fabs(lat / (double) JSON_E7_PER_DEG) + half_deg;
+
+  json_box.lat        = lat;
+  json_box.lon        = lon;
+  json_box.dlat       = (int32_t) (half_deg * JSON_E7_PER_DEG);
+  json_box.margin_lat = (int32_t) (margin_deg * JSON_E7_PER_DEG);
+
+  if (edge_deg < 89.0) {
+    double k = 1.0 / cos(edge_deg * M_PI / 180.0);
+
+    json_box.dlon       = (int32_t) (json_box.dlat * k);
+    json_box.margin_lon = (int32_t) (json_box.margin_lat * k);
+  } else {
+    json_box.dlon       = 0;
+    json_box.margin_lon = 0;
+  }
+
+  json_box.valid = true;
+  JSON_filter_stats.updates++;
+}
+
+static bool JSON_Filter(float latitude, float longitude)
+{
+  JSON_filter_stats.reports++;
+
+  /* nothing to measure from yet */
+  if (ThisAircraft.latitude == 0.0 && ThisAircraft.longitude == 0.0) {
+    JSON_filter_stats.passed++;
+    return true;
+  }
+
+  int32_t own_lat = JSON_E7(ThisAircraft.latitude);
+  int32_t own_lon = JSON_E7(ThisAircraft.longitude);
+
+  if (!json_box.valid ||
+      abs(own_lat - json_box.lat) > json_box.margin_lat ||
+      (json_box.dlon &&
+       abs(JSON_Lon_Diff(own_lon, json_box.lon)) > json_box.margin_lon)) {
+    JSON_Filter_Setup(own_lat, own_lon);
+  }
+
+  if (abs(JSON_E7(latitude) - json_box.lat) > json_box.dlat) {
+    return false;
+  }
+  if (json_box.dlon &&
+      abs(JSON_Lon_Diff(JSON_E7(longitude), json_box.lon)) > json_box.dlon) {
+    return false;
+  }
+
+  JSON_filter_stats.passed++;
+  return true;
+}
+
 void JSON_Export()
 {
   if (settings->json != JSON_PING) {
@@ -163,7 +262,8 @@ void parsePING(JsonObject& root)
       if (aircraft_array[i].icaoAddress &&
           aircraft_array[i].latDD != 0.0 &&
           aircraft_array[i].lonDD != 0.0 &&
-          aircraft_array[i].altitudeMM != 0) {
+          aircraft_array[i].altitudeMM != 0 &&
+          JSON_Filter(aircraft_array[i].latDD, aircraft_array[i].lonDD)) {
 
         fo = EmptyFO;
         memset(fo.raw, 0, sizeof(fo.raw));
@@ -192,6 +292,8 @@ void parsePING(JsonObject& root)
 
         fo.latitude = aircraft_array[i].latDD;
         fo.longitude = aircraft_array[i].lonDD;
+        fo.lat_e7 = POSITION_E7(aircraft_array[i].latDD);
+        fo.lon_e7 = POSITION_E7(aircraft_array[i].lonDD);
 
         if (aircraft_array[i].altitudeType == 0) {
           fo.pressure_altitude = aircraft_array[i].altitudeMM / 1000.0;
@@ -210,6 +312,10 @@ void parsePING(JsonObject& root)
         fo.no_track = false;
         fo.rssi = 0;
 
+#if defined(USE_RECORDER)
+        Recorder_Traffic(&fo);
+#endif /* USE_RECORDER */
+
         Traffic_Update(&fo);
 
         int j;
@@ -218,6 +324,7 @@ void parsePING(JsonObject& root)
         for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
           if (Container[j].addr == fo.addr && Container[j].protocol == fo.protocol) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -231,6 +338,7 @@ void parsePING(JsonObject& root)
           if (Container[j].addr == 0 &&
              memcmp(Container[j].raw, EmptyFO.raw, sizeof(EmptyFO.raw)) == 0) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -243,6 +351,7 @@ void parsePING(JsonObject& root)
         for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
           if (timestamp - Container[j].timestamp > ENTRY_EXPIRATION_TIME) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -361,6 +470,26 @@ void parseSettings(JsonObject& root)
     }
   }
 
+  JsonVariant rxp = root["rxp"];
+  if (rxp.success()) {
+    JsonArray& rxp_array = rxp;
+    uint8_t mask = 0;
+
+    for (int i=0; i < rxp_array.size(); i++) {
+      const char* rxp_s = rxp_array[i];
+      if (rxp_s == NULL) {
+        continue;
+      } else if (!strcmp(rxp_s,"LEGACY")) {
+        mask |= RF_RX_PROTOCOLS_LEGACY;
+      } else if (!strcmp(rxp_s,"OGNTP")) {
+        mask |= RF_RX_PROTOCOLS_OGNTP;
+      } else if (!strcmp(rxp_s,"FANET")) {
+        mask |= RF_RX_PROTOCOLS_FANET;
+      }
+    }
+    eeprom_block.field.settings.rx_protocols = mask;
+  }
+
   JsonVariant band = root["band"];
   if (band.success()) {
     const char * band_s = band.as<char*>();
@@ -591,7 +720,8 @@ void parseD1090(JsonObject& root)
       if (aircraft_array[i].hex &&
           aircraft_array[i].lat != 0.0 &&
           aircraft_array[i].lon != 0.0 &&
-          aircraft_array[i].altitude != 0.0) {
+          aircraft_array[i].altitude != 0.0 &&
+          JSON_Filter(aircraft_array[i].lat, aircraft_array[i].lon)) {
 
         fo = EmptyFO;
         memset(fo.raw, 0, sizeof(fo.raw));
@@ -612,6 +742,8 @@ void parseD1090(JsonObject& root)
 
         fo.latitude = aircraft_array[i].lat;
         fo.longitude = aircraft_array[i].lon;
+        fo.lat_e7 = POSITION_E7(aircraft_array[i].lat);
+        fo.lon_e7 = POSITION_E7(aircraft_array[i].lon);
         fo.pressure_altitude = aircraft_array[i].altitude / _GPS_FEET_PER_METER;
 
         /* TBD */
@@ -625,6 +757,10 @@ void parseD1090(JsonObject& root)
         fo.no_track = false;
         fo.rssi = aircraft_array[i].rssi;
 
+#if defined(USE_RECORDER)
+        Recorder_Traffic(&fo);
+#endif /* USE_RECORDER */
+
         Traffic_Update(&fo);
 
         int j;
@@ -633,6 +769,7 @@ void parseD1090(JsonObject& root)
         for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
           if (Container[j].addr == fo.addr && Container[j].protocol == fo.protocol) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -646,6 +783,7 @@ void parseD1090(JsonObject& root)
           if (Container[j].addr == 0 &&
              memcmp(Container[j].raw, EmptyFO.raw, sizeof(EmptyFO.raw)) == 0) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -658,6 +796,7 @@ void parseD1090(JsonObject& root)
         for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
           if (timestamp - Container[j].timestamp > ENTRY_EXPIRATION_TIME) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -727,6 +866,7 @@ void parseRAW(JsonObject& root)
           if (Container[j].addr == 0 &&
              memcmp(Container[j].raw, EmptyFO.raw, sizeof(EmptyFO.raw)) == 0) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -739,6 +879,7 @@ void parseRAW(JsonObject& root)
         for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
           if (timestamp - Container[j].timestamp > ENTRY_EXPIRATION_TIME) {
             Container[j] = fo;
+            Traffic_Rank_Update(j);
             break;
           }
         }
@@ -30,6 +30,10 @@
 #endif /* RASPBERRY_PI */
 
 #define JSON_BUFFER_SIZE  65536
+
+/* reports further than that from ownship are dropped early */
+#define JSON_FILTER_RANGE   (ALARM_ZONE_NONE * 2)  /* as far as relay looks */
+#define JSON_FILTER_MARGIN  (ALARM_ZONE_NONE / 2)  /* ownship moves within */
 #define isValidGPSDFix() (hasValidGPSDFix)
 
 enum
@@ -75,8 +79,15 @@ struct ping_aircraft_struct {
 typedef  struct dump1090_aircraft_struct dump1090_aircraft_t;
 typedef  struct ping_aircraft_struct ping_aircraft_t;
 
+typedef struct json_filter_stats_struct {
+  uint32_t reports;  /* with a valid position */
+  uint32_t passed;   /* inside of the box around ownship */
+  uint32_t updates;  /* of the box */
+} json_filter_stats_t;
+
 extern StaticJsonBuffer<JSON_BUFFER_SIZE> jsonBuffer;
 extern bool hasValidGPSDFix;
+extern json_filter_stats_t JSON_filter_stats;
 
 extern void JSON_Export();
 extern void parseTPV(JsonObject&);
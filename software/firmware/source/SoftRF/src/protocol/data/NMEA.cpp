@@ -26,6 +26,13 @@
 #include "../../driver/EEPROM.h"
 #include "../../driver/Battery.h"
 #include "../../TrafficHelper.h"
+#include "../../system/Profile.h"
+#include "../../system/Export.h"
+#include "../../system/Position.h"
+
+#if defined(USE_TICKLESS)
+#include "../../system/Tickless.h"
+#endif /* USE_TICKLESS */
 
 #define ADDR_TO_HEX_STR(s, c) (s += ((c) < 0x10 ? "0" : "") + String((c), HEX))
 
@@ -65,6 +72,16 @@ extern uint32_t tx_packets_counter, rx_packets_counter;
 unsigned long RPYL_TimeMarker = 0;
 #endif /* ENABLE_AHRS */
 
+#if defined(USE_PROFILER)
+#define isTimeToPSRFS() (millis() - PSRFS_TimeMarker > PROFILE_REPORT_INTERVAL)
+unsigned long PSRFS_TimeMarker = 0;
+#endif /* USE_PROFILER */
+
+#if defined(USE_TICKLESS)
+#define isTimeToPSRFP() (millis() - PSRFP_TimeMarker > TICKLESS_REPORT_INTERVAL)
+unsigned long PSRFP_TimeMarker = 0;
+#endif /* USE_TICKLESS */
+
 static char *ltrim(char *s)
 {
   if(s) {
@@ -110,7 +127,92 @@ void NMEA_setup()
 #if defined(ENABLE_AHRS)
   RPYL_TimeMarker = millis();
 #endif /* ENABLE_AHRS */
+
+#if defined(USE_PROFILER)
+  PSRFS_TimeMarker = millis();
+#endif /* USE_PROFILER */
+
+#if defined(USE_TICKLESS)
+  PSRFP_TimeMarker = millis();
+#endif /* USE_TICKLESS */
+}
+
+#if defined(USE_PROFILER)
+/*
+ * $PSRFS,<version>,<stage>,<count>,<avg>,<p50>,<p99>,<max> - for every stage
+ * that has run, times are in microseconds, and then
+ * $PSRFS,<version>,CNT,<CRC errors>,<FEC corrections>,<overruns>,<drops>
+ * $PSRFS,<version>,POS,<float, ns per target>,<fixed point, ns per target>
+ */
+static void NMEA_PSRFS()
+{
+  for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+    profile_stage_t *sp = &Profile_stages[i];
+
+    if (sp->count == 0) {
+      continue;
+    }
+
+    snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+            PSTR("$PSRFS,%d,%s,%lu,%lu,%lu,%lu,%lu*"),
+            PSRFS_VERSION, Profile_stage_name[i],
+            (unsigned long) sp->count,
+            (unsigned long) (sp->total / sp->count),
+            (unsigned long) Profile_Percentile(i, 50),
+            (unsigned long) Profile_Percentile(i, 99),
+            (unsigned long) sp->max);
+
+    NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+    NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+  }
+
+  snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+          PSTR("$PSRFS,%d,CNT,%lu,%lu,%lu,%lu*"),
+          PSRFS_VERSION,
+          (unsigned long) Profile_counters[PROFILE_CRC_ERRORS],
+          (unsigned long) Profile_counters[PROFILE_FEC_CORRECTIONS],
+          (unsigned long) Profile_counters[PROFILE_OVERRUNS],
+          (unsigned long) Profile_counters[PROFILE_DROPS]);
+
+  NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+  NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+
+  snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+          PSTR("$PSRFS,%d,POS,%lu,%lu*"),
+          PSRFS_VERSION,
+          (unsigned long) Position_bench.fp_ns,
+          (unsigned long) Position_bench.fixed_ns);
+
+  NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+  NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
 }
+#endif /* USE_PROFILER */
+
+#if defined(USE_TICKLESS)
+/*
+ * $PSRFP,<version>,<event wake ups>,<deadline wake ups>,<sleep, per mille>,
+ *        <estimated MCU current, uA>
+ */
+static void NMEA_PSRFP()
+{
+  uint32_t total = Tickless_stats.run_ms + Tickless_stats.sleep_ms;
+
+  snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+          PSTR("$PSRFP,%d,%lu,%lu,%lu,%lu*"),
+          PSRFP_VERSION,
+          (unsigned long) Tickless_stats.events,
+          (unsigned long) Tickless_stats.timeouts,
+          (unsigned long) (total ? (uint64_t) Tickless_stats.sleep_ms * 1000 / total : 0),
+          (unsigned long) Tickless_Current());
+
+  NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+  NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+}
+#endif /* USE_TICKLESS */
 
 void NMEA_loop()
 {
@@ -158,6 +260,24 @@ void NMEA_loop()
   }
 #endif /* ENABLE_AHRS */
 
+#if defined(USE_PROFILER)
+  if (settings->nmea_p && isTimeToPSRFS()) {
+
+    NMEA_PSRFS();
+
+    PSRFS_TimeMarker = millis();
+  }
+#endif /* USE_PROFILER */
+
+#if defined(USE_TICKLESS)
+  if (settings->nmea_p && isTimeToPSRFP()) {
+
+    NMEA_PSRFP();
+
+    PSRFP_TimeMarker = millis();
+  }
+#endif /* USE_TICKLESS */
+
 #if defined(NMEA_TCP_SERVICE)
   uint8_t i;
 
@@ -285,13 +405,14 @@ void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl)
 
 void NMEA_Export()
 {
+    PROFILE_SCOPE(PROFILE_EXPORT_NMEA);
+
     int bearing;
     int alt_diff;
     float distance;
 
     int total_objects = 0;
     int alarm_level = ALARM_LEVEL_NONE;
-    time_t this_moment = now();
 
     /* High priority object (most relevant target) */
     int HP_bearing = 0;
@@ -302,88 +423,88 @@ void NMEA_Export()
 
     bool has_Fix = isValidFix() || (settings->mode == SOFTRF_MODE_TXRX_TEST);
 
-    if (has_Fix) {
-      for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-        if (Container[i].addr && (this_moment - Container[i].timestamp) <= EXPORT_EXPIRATION_TIME) {
+    if (has_Fix && settings->nmea_l) {
+      export_target_t list[MAX_TRACKING_OBJECTS];
+      int count = Export_Begin(EXPORT_SINK_NMEA, settings->nmea_out, list,
+                               EXPORT_NMEA_RESERVE);
+
+      /* most threatening first, distant ones give way on a slow port */
+      for (int k=0; k < count; k++) {
+        int i = list[k].fop - Container;
 
 #if 0
-          Serial.println(fo.addr);
-          Serial.println(fo.latitude, 4);
-          Serial.println(fo.longitude, 4);
-          Serial.println(fo.altitude);
-          Serial.println(fo.addr_type);
-          Serial.println(fo.vs);
-          Serial.println(fo.aircraft_type);
-          Serial.println(fo.stealth);
-          Serial.println(fo.no_track);
+        Serial.println(fo.addr);
+        Serial.println(fo.latitude, 4);
+        Serial.println(fo.longitude, 4);
+        Serial.println(fo.altitude);
+        Serial.println(fo.addr_type);
+        Serial.println(fo.vs);
+        Serial.println(fo.aircraft_type);
+        Serial.println(fo.stealth);
+        Serial.println(fo.no_track);
 #endif
-          if (settings->nmea_l) {
-            distance = Container[i].distance;
-
-            if (distance < ALARM_ZONE_NONE) {
-
-              total_objects++;
-
-              char str_climb_rate[8] = "";
-              uint8_t addr_type = Container[i].addr_type > ADDR_TYPE_ANONYMOUS ?
-                                  ADDR_TYPE_ANONYMOUS : Container[i].addr_type;
-
-              bearing = Container[i].bearing;
-              alarm_level = Container[i].alarm_level;
-              alt_diff = (int) (Container[i].altitude - ThisAircraft.altitude);
-
-              if (!Container[i].stealth && !ThisAircraft.stealth) {
-                dtostrf(
-                  constrain(Container[i].vs / (_GPS_FEET_PER_METER * 60.0), -32.7, 32.7),
-                  5, 1, str_climb_rate);
-              }
-
-              /*
-               * When callsign is available - send it to a NMEA client.
-               * If it is not - generate a callsign substitute,
-               * based upon a protocol ID and the ICAO address
-               */
-              memset((void *) NMEA_Callsign, 0, sizeof(NMEA_Callsign));
-
-              if (strnlen((char *) Container[i].callsign, sizeof(Container[i].callsign)) > 0) {
-                memcpy(NMEA_Callsign, Container[i].callsign, sizeof(Container[i].callsign));
-              } else {
-                memcpy(NMEA_Callsign, NMEA_CallSign_Prefix[Container[i].protocol],
-                  strlen(NMEA_CallSign_Prefix[Container[i].protocol]));
-
-                String str = "_";
-
-                ADDR_TO_HEX_STR(str, (Container[i].addr >> 16) & 0xFF);
-                ADDR_TO_HEX_STR(str, (Container[i].addr >>  8) & 0xFF);
-                ADDR_TO_HEX_STR(str, (Container[i].addr      ) & 0xFF);
-
-                str.toUpperCase();
-                memcpy(NMEA_Callsign + strlen(NMEA_CallSign_Prefix[Container[i].protocol]),
-                  str.c_str(), str.length());
-              }
-
-              snprintf_P(NMEABuffer, sizeof(NMEABuffer), PSTR("$PFLAA,%d,%d,%d,%d,%d,%06X!%s,%d,,%d,%s,%d*"),
-                      alarm_level,
-                      (int) (distance * cos(radians(bearing))), (int) (distance * sin(radians(bearing))),
-                      alt_diff, addr_type, Container[i].addr, NMEA_Callsign,
-                      (int) Container[i].course, (int) (Container[i].speed * _GPS_MPS_PER_KNOT),
-                      ltrim(str_climb_rate), Container[i].aircraft_type);
-
-              NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
-
-              NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
-
-              /* Most close traffic is treated as highest priority target */
-              if (distance < HP_distance && abs(alt_diff) < VERTICAL_VISIBILITY_RANGE) {
-                HP_bearing = bearing;
-                HP_alt_diff = alt_diff;
-                HP_alarm_level = alarm_level;
-                HP_distance = distance;
-                HP_addr = Container[i].addr;
-              }
-
-            }
-          }
+        distance = Container[i].distance;
+
+        total_objects++;
+
+        char str_climb_rate[8] = "";
+        uint8_t addr_type = Container[i].addr_type > ADDR_TYPE_ANONYMOUS ?
+                            ADDR_TYPE_ANONYMOUS : Container[i].addr_type;
+
+        bearing = Container[i].bearing;
+        alarm_level = Container[i].alarm_level;
+        alt_diff = (int) (Container[i].altitude - ThisAircraft.altitude);
+
+        if (!Container[i].stealth && !ThisAircraft.stealth) {
+          dtostrf(
+            constrain(Container[i].vs / (_GPS_FEET_PER_METER * 60.0), -32.7, 32.7),
+            5, 1, str_climb_rate);
+        }
+
+        /*
+         * When callsign is available - send it to a NMEA client.
+         * If it is not - generate a callsign substitute,
+         * based upon a protocol ID and the ICAO address
+         */
+        memset((void *) NMEA_Callsign, 0, sizeof(NMEA_Callsign));
+
+        if (strnlen((char *) Container[i].callsign, sizeof(Container[i].callsign)) > 0) {
+          memcpy(NMEA_Callsign, Container[i].callsign, sizeof(Container[i].callsign));
+        } else {
+          memcpy(NMEA_Callsign, NMEA_CallSign_Prefix[Container[i].protocol],
+            strlen(NMEA_CallSign_Prefix[Container[i].protocol]));
+
+          String str = "_";
+
+          ADDR_TO_HEX_STR(str, (Container[i].addr >> 16) & 0xFF);
+          ADDR_TO_HEX_STR(str, (Container[i].addr >>  8) & 0xFF);
+          ADDR_TO_HEX_STR(str, (Container[i].addr      ) & 0xFF);
+
+          str.toUpperCase();
+          memcpy(NMEA_Callsign + strlen(NMEA_CallSign_Prefix[Container[i].protocol]),
+            str.c_str(), str.length());
+        }
+
+        snprintf_P(NMEABuffer, sizeof(NMEABuffer), PSTR("$PFLAA,%d,%d,%d,%d,%d,%06X!%s,%d,,%d,%s,%d*"),
+                alarm_level,
+                Container[i].north, Container[i].east,
+                alt_diff, addr_type, Container[i].addr, NMEA_Callsign,
+                (int) Container[i].course, (int) (Container[i].speed * _GPS_MPS_PER_KNOT),
+                ltrim(str_climb_rate), Container[i].aircraft_type);
+
+        NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+        if (Export_Admit(EXPORT_SINK_NMEA, &list[k], strlen(NMEABuffer))) {
+          NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+        }
+
+        /* Most close traffic is treated as highest priority target */
+        if (distance < HP_distance && abs(alt_diff) < VERTICAL_VISIBILITY_RANGE) {
+          HP_bearing = bearing;
+          HP_alt_diff = alt_diff;
+          HP_alarm_level = alarm_level;
+          HP_distance = distance;
+          HP_addr = Container[i].addr;
         }
       }
     }
@@ -501,7 +622,8 @@ void NMEA_Position()
   }
 }
 
-void NMEA_GGA()
+/* re-generates sentences of the built-in GNSS out of its latest fix */
+static void NMEA_GNSS_Out(NmeaSentence mask)
 {
   NmeaInfo info;
 
@@ -514,6 +636,9 @@ void NMEA_GGA()
   info.utc.min = gnss.time.minute();
   info.utc.sec = gnss.time.second();
   info.utc.hsec = gnss.time.centisecond();
+  info.utc.year = gnss.date.year();
+  info.utc.mon = gnss.date.month();
+  info.utc.day = gnss.date.day();
 
   info.latitude = ((int) latitude) * 100.0;
   info.latitude += (latitude - (int) latitude) * 60.0;
@@ -524,6 +649,8 @@ void NMEA_GGA()
   info.satellites.inViewCount = gnss.satellites.value();
 
   info.hdop = gnss.hdop.hdop();
+  info.speed = gnss.speed.kmph();
+  info.track = gnss.course.deg();
 
   info.elevation = gnss.altitude.meters(); /* above MSL */
   info.height = gnss.separation.meters();
@@ -534,6 +661,7 @@ void NMEA_GGA()
   }
 
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_UTCTIME);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_UTCDATE);
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LAT);
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_LON);
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_SIG);
@@ -542,13 +670,25 @@ void NMEA_GGA()
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_HDOP);
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_ELV);
   nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_HEIGHT);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_SPEED);
+  nmeaInfoSetPresent(&info.present, NMEALIB_PRESENT_TRACK);
 
-  size_t gen_sz = nmeaSentenceFromInfo(&nmealib_buf, &info, (NmeaSentence)
-                                        NMEALIB_SENTENCE_GPGGA );
+  size_t gen_sz = nmeaSentenceFromInfo(&nmealib_buf, &info, mask);
 
   if (gen_sz) {
     NMEA_Out(settings->nmea_out, (byte *) nmealib_buf.buffer, gen_sz, false);
   }
 }
 
+void NMEA_GGA()
+{
+  NMEA_GNSS_Out((NmeaSentence) NMEALIB_SENTENCE_GPGGA);
+}
+
+/* for GNSS modules that talk a binary protocol only */
+void NMEA_GNSS()
+{
+  NMEA_GNSS_Out((NmeaSentence) (NMEALIB_SENTENCE_GPGGA | NMEALIB_SENTENCE_GPRMC));
+}
+
 #endif /* USE_NMEALIB */
@@ -30,6 +30,7 @@
 
 #include "../../../SoftRF.h"
 #include "../../driver/RF.h"
+#include "../../system/Position.h"
 
 const rf_proto_desc_t fanet_proto_desc = {
   "FANET",
@@ -176,7 +177,8 @@ static void coord2payload_absolut(float lat, float lon, uint8_t *buf)
  *  Created on: 06 Dec 2017
  *      Author: Linar Yusupov
  */
-static void payload_absolut2coord(float *lat, float *lon, uint8_t *buf)
+/* into 1e-7 degrees, lat_i x 1e7/93206 and lon_i x 1e7/46603 in Q32 */
+static void payload_absolut2coord(int32_t *lat, int32_t *lon, uint8_t *buf)
 {
   int32_t lat_i = 0;
   int32_t lon_i = 0;
@@ -194,8 +196,8 @@ static void payload_absolut2coord(float *lat, float *lon, uint8_t *buf)
   ((uint8_t*)&lon_i)[2] = buf[5];
   ((uint8_t*)&lon_i)[3] = buf[5] & 0x80 ? 0xFF : 0x00;
 
-  *lat = (float) lat_i / 93206.0f;
-  *lon = (float) lon_i / 46603.0f;
+  *lat = (int32_t) (((int64_t) lat_i * 460803735382LL + (1LL << 31)) >> 32);
+  *lon = (int32_t) (((int64_t) lon_i * 921607470764LL + (1LL << 31)) >> 32);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -224,9 +226,13 @@ bool fanet_decode(void *fanet_pkt, ufo_t *this_aircraft, ufo_t *fop) {
 #if defined(FANET_DEPRECATED)
     fop->latitude  = payload_compressed2coord(pkt->latitude, this_aircraft->latitude);
     fop->longitude = payload_compressed2coord(pkt->longitude, this_aircraft->longitude);
+    fop->lat_e7    = POSITION_E7(fop->latitude);
+    fop->lon_e7    = POSITION_E7(fop->longitude);
 #else
-    payload_absolut2coord(&(fop->latitude), &(fop->longitude),
+    payload_absolut2coord(&(fop->lat_e7), &(fop->lon_e7),
       ((uint8_t *) pkt) + FANET_HEADER_SIZE);
+    fop->latitude  = POSITION_DEG(fop->lat_e7);
+    fop->longitude = POSITION_DEG(fop->lon_e7);
 #endif
 
     altitude = ((pkt->altitude_msb << 8) | pkt->altitude_lsb);
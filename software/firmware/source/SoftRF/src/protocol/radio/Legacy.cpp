@@ -27,6 +27,7 @@
 #include "../../../SoftRF.h"
 #include "../../driver/RF.h"
 #include "../../driver/EEPROM.h"
+#include "../../system/Position.h"
 
 const rf_proto_desc_t legacy_proto_desc = {
   "Legacy",
@@ -117,8 +118,8 @@ bool legacy_decode(void *legacy_pkt, ufo_t *this_aircraft, ufo_t *fop) {
 
     legacy_packet_t *pkt = (legacy_packet_t *) legacy_pkt;
 
-    float ref_lat = this_aircraft->latitude;
-    float ref_lon = this_aircraft->longitude;
+    int32_t ref_lat = this_aircraft->lat_e7;
+    int32_t ref_lon = this_aircraft->lon_e7;
     float geo_separ = this_aircraft->geoid_separation;
     uint32_t timestamp = (uint32_t) this_aircraft->timestamp;
 
@@ -140,12 +141,12 @@ bool legacy_decode(void *legacy_pkt, ufo_t *this_aircraft, ufo_t *fop) {
         return false;
     }
 
-    int32_t round_lat = (int32_t) (ref_lat * 1e7) >> 7;
+    int32_t round_lat = ref_lat >> 7;
     int32_t lat = (pkt->lat - round_lat) % (uint32_t) 0x080000;
     if (lat >= 0x040000) lat -= 0x080000;
     lat = ((lat + round_lat) << 7) /* + 0x40 */;
 
-    int32_t round_lon = (int32_t) (ref_lon * 1e7) >> 7;
+    int32_t round_lon = ref_lon >> 7;
     int32_t lon = (pkt->lon - round_lon) % (uint32_t) 0x100000;
     if (lon >= 0x080000) lon -= 0x100000;
     lon = ((lon + round_lon) << 7) /* + 0x40 */;
@@ -173,8 +174,10 @@ bool legacy_decode(void *legacy_pkt, ufo_t *this_aircraft, ufo_t *fop) {
     fop->addr = pkt->addr;
     fop->addr_type = pkt->addr_type;
     fop->timestamp = timestamp;
-    fop->latitude = (float)lat / 1e7;
-    fop->longitude = (float)lon / 1e7;
+    fop->lat_e7 = lat;
+    fop->lon_e7 = lon;
+    fop->latitude = POSITION_DEG(lat);
+    fop->longitude = POSITION_DEG(lon);
     fop->altitude = (float) alt - geo_separ;
     fop->speed = speed4 / (4 * _GPS_MPS_PER_KNOT);
     fop->course = direction;
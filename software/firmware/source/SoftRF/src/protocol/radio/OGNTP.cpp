@@ -25,6 +25,9 @@
 
 #include "../../../SoftRF.h"
 #include "../../driver/RF.h"
+#include "../../driver/EEPROM.h"
+#include "../../system/Position.h"
+#include "../../system/Relay.h"
 
 const rf_proto_desc_t ogntp_proto_desc = {
   "OGNTP",
@@ -65,6 +68,43 @@ void ogntp_fini()
 
 }
 
+#if defined(USE_RELAY)
+/*
+ * Direct position packets of others become relay candidates, ranked by
+ * OGN_RxPacket::calcRelayRank(): weak, low and sinking ones go first.
+ * A packet that arrives relayed already tells that a neighbour has
+ * taken care of it.
+ */
+static void ogntp_relay(OGN_Packet &raw, ufo_t *this_aircraft)
+{
+  OGN_Packet &pkt = ogn_rx_pkt.Packet;
+  uint32_t key = RELAY_KEY(pkt.Header.Address, pkt.Header.AddrType,
+                           pkt.Position.Time);
+
+  if (pkt.Header.RelayCount > 0) {
+    Relay_Mark(key);
+    return;
+  }
+
+  if (pkt.Position.Time >= 60) {
+    return;
+  }
+
+  int rssi = -2 * RF_last_rssi; /* [-0.5 dBm] */
+  ogn_rx_pkt.RxRSSI = rssi < 0 ? 0 : (rssi > 255 ? 255 : rssi);
+  ogn_rx_pkt.calcRelayRank((int32_t) (this_aircraft->altitude * 10));
+
+  OGN_TxPacket relay_pkt;
+
+  relay_pkt.Packet = raw;
+  relay_pkt.Packet.Header.RelayCount = 1; /* out of the address parity */
+  relay_pkt.calcFEC();
+
+  Relay_Candidate(relay_pkt.Byte(), relay_pkt.Bytes, key,
+                  ogn_rx_pkt.Rank, OGNTP_AIRTIME);
+}
+#endif /* USE_RELAY */
+
 bool ogntp_decode(void *pkt, ufo_t *this_aircraft, ufo_t *fop) {
 
   ogn_rx_pkt.recvBytes((uint8_t *) pkt);
@@ -92,13 +132,22 @@ bool ogntp_decode(void *pkt, ufo_t *this_aircraft, ufo_t *fop) {
     return false;
   }
 
+#if defined(USE_RELAY)
+  OGN_Packet raw = ogn_rx_pkt.Packet; /* whitened, as it goes over the air */
+#endif /* USE_RELAY */
+
   ogn_rx_pkt.Packet.Dewhiten();
 
   fop->protocol = RF_PROTOCOL_OGNTP;
 
   fop->addr = ogn_rx_pkt.Packet.Header.Address;
-  fop->latitude = ogn_rx_pkt.Packet.DecodeLatitude() * 0.0001/60;
-  fop->longitude = ogn_rx_pkt.Packet.DecodeLongitude() * 0.0001/60;
+  /* 1/600000 degree into 1e-7, that is x 50/3 */
+  int32_t lat = ogn_rx_pkt.Packet.DecodeLatitude();
+  int32_t lon = ogn_rx_pkt.Packet.DecodeLongitude();
+  fop->lat_e7 = lat * 16 + lat * 2 / 3;
+  fop->lon_e7 = lon * 16 + lon * 2 / 3;
+  fop->latitude = POSITION_DEG(fop->lat_e7);
+  fop->longitude = POSITION_DEG(fop->lon_e7);
   fop->altitude = (float) ogn_rx_pkt.Packet.DecodeAltitude();
   fop->pressure_altitude = (float) ogn_rx_pkt.Packet.DecodeStdAltitude();
   fop->aircraft_type = ogn_rx_pkt.Packet.Position.AcftType;
@@ -117,6 +166,12 @@ bool ogntp_decode(void *pkt, ufo_t *this_aircraft, ufo_t *fop) {
   fop->ew[0] = 0; fop->ew[1] = 0;
   fop->ew[2] = 0; fop->ew[3] = 0;
 
+#if defined(USE_RELAY)
+  if (settings->mode == SOFTRF_MODE_RELAY) {
+    ogntp_relay(raw, this_aircraft);
+  }
+#endif /* USE_RELAY */
+
   return true;
 }
 
@@ -33,6 +33,8 @@
 #define OGNTP_TX_INTERVAL_MIN 600 /* in ms */
 #define OGNTP_TX_INTERVAL_MAX 1400
 
+#define OGNTP_AIRTIME         5 /* in ms, 26 Manchester coded bytes at 100 kbps */
+
 #include "ogn.h"
 
 typedef struct {
@@ -24,6 +24,7 @@
 
 #include "../../../SoftRF.h"
 #include "../../driver/RF.h"
+#include "../../system/Position.h"
 
 const rf_proto_desc_t p3i_proto_desc = {
   "P3I",
@@ -76,6 +77,8 @@ bool p3i_decode(void *p3i_pkt, ufo_t *this_aircraft, ufo_t *fop) {
   fop->addr = pkt->icao;
   fop->latitude = pkt->latitude;
   fop->longitude = pkt->longitude;
+  fop->lat_e7 = POSITION_E7(pkt->latitude);   /* IEEE-754 over the air */
+  fop->lon_e7 = POSITION_E7(pkt->longitude);
   fop->altitude = (float) pkt->altitude;
   fop->aircraft_type = pkt->aircraft;
   fop->course = (float) pkt->track;
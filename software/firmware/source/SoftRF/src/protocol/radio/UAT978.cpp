@@ -24,6 +24,7 @@
 
 #include "../../../SoftRF.h"
 #include "../../driver/RF.h"
+#include "../../system/Position.h"
 #include "../data/GDL90.h"
 
 const rf_proto_desc_t uat978_proto_desc = {
@@ -61,6 +62,8 @@ bool uat978_decode(void *pkt, ufo_t *this_aircraft, ufo_t *fop) {
   fop->addr = mdb.address;
   fop->latitude = mdb.lat;
   fop->longitude = mdb.lon;
+  fop->lat_e7 = POSITION_E7(mdb.lat);
+  fop->lon_e7 = POSITION_E7(mdb.lon);
 
   if (mdb.altitude_type == ALT_GEO) {
     fop->altitude = mdb.altitude / _GPS_FEET_PER_METER;          /* TBD */
@@ -0,0 +1,223 @@
+/*
+ * ExportHelper.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TimeLib.h>
+
+#include "SoC.h"
+#include "Export.h"
+#include "../TrafficHelper.h"
+#include "../driver/GNSS.h"
+#include "../protocol/radio/Legacy.h"
+
+/*
+ * Every data port has a byte budget that refills at the rate the port
+ * can take and is shared by all the sinks that write into it. Targets are
+ * offered to a sink most threatening first, so that the budget runs out
+ * on the distant ones. Those that are not converging are also decimated
+ * by their distance. Urgent ones always go out, over the budget if need be.
+ */
+typedef struct export_link_struct {
+  int32_t  budget;  /* bytes */
+  uint32_t marker;  /* millis() of the last refill */
+  uint32_t bps;     /* 0 - no limit */
+} export_link_t;
+
+typedef struct export_last_struct {
+  uint32_t addr;
+  uint8_t  tick;
+} export_last_t;
+
+typedef struct export_sink_struct {
+  uint8_t  link;
+  uint8_t  tick;
+  export_last_t last[MAX_TRACKING_OBJECTS];
+} export_sink_t;
+
+export_stats_t Export_stats;
+
+static export_link_t export_link[EXPORT_LINKS];
+static export_sink_t export_sink[EXPORT_SINKS];
+
+static uint32_t Export_Bandwidth(uint8_t link)
+{
+  switch (link)
+  {
+  case EXPORT_LINK_UART:      return EXPORT_UART_BPS;
+  case EXPORT_LINK_USB:       return EXPORT_USB_BPS;
+  case EXPORT_LINK_BLUETOOTH: return EXPORT_BT_BPS;
+  case EXPORT_LINK_UDP:
+  case EXPORT_LINK_TCP:
+  default:                    return 0;
+  }
+}
+
+/* time to the closest approach in the horizontal plane, < 0 - diverging */
+static float Export_TCA(const ufo_t *fop)
+{
+  float px = fop->east;
+  float py = fop->north;
+
+  float tc = radians(fop->course);
+  float oc = radians(ThisAircraft.course);
+  float vx = (fop->speed * sinf(tc) - ThisAircraft.speed * sinf(oc)) *
+             _GPS_MPS_PER_KNOT;
+  float vy = (fop->speed * cosf(tc) - ThisAircraft.speed * cosf(oc)) *
+             _GPS_MPS_PER_KNOT;
+  float v2 = vx * vx + vy * vy;
+
+  if (v2 < 1.0) {
+    return -1.0;
+  }
+
+  return -(px * vx + py * vy) / v2;
+}
+
+static inline bool Export_Converging(const export_target_t *t)
+{
+  return t->tca >= 0 && t->tca < EXPORT_TCA_HORIZON;
+}
+
+/* alarm level first, then the converging ones by TCA, then distance */
+static bool Export_Before(const export_target_t *a, const export_target_t *b)
+{
+  if (a->fop->alarm_level != b->fop->alarm_level) {
+    return a->fop->alarm_level > b->fop->alarm_level;
+  }
+
+  bool ca = Export_Converging(a);
+  bool cb = Export_Converging(b);
+
+  if (ca != cb) {
+    return ca;
+  }
+  if (ca && a->tca != b->tca) {
+    return a->tca < b->tca;
+  }
+
+  return a->fop->distance < b->fop->distance;
+}
+
+void Export_setup()
+{
+  memset(export_link, 0, sizeof(export_link));
+  memset(export_sink, 0, sizeof(export_sink));
+  memset(&Export_stats, 0, sizeof(Export_stats));
+}
+
+/*
+ * Refills the budget of the port and puts the targets that are
+ * worth exporting into the list, most threatening first.
+ * 'reserve' is the number of bytes that go out this tick regardless.
+ */
+int Export_Begin(uint8_t sink, uint8_t link, export_target_t *list,
+                 size_t reserve)
+{
+  export_sink_t *s = &export_sink[sink];
+  uint32_t ms = millis();
+  time_t this_moment = now();
+  int count = 0;
+
+  if (link >= EXPORT_LINKS) {
+    link = EXPORT_LINK_OFF;
+  }
+
+  s->link = link;
+  s->tick++;
+
+  export_link_t *l = &export_link[link];
+  uint32_t elapsed = ms - l->marker;
+
+  l->bps    = Export_Bandwidth(link);
+  l->marker = ms;
+
+  if (l->bps) {
+    if (elapsed > 1000) {
+      elapsed = 1000;
+    }
+    l->budget += (l->bps * elapsed) / 1000;
+    if (l->budget > (int32_t) l->bps) {
+      l->budget = l->bps;
+    }
+    l->budget -= (int32_t) reserve;
+  }
+
+  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    ufo_t *fop = &Container[i];
+
+    if (fop->addr == 0 ||
+        (this_moment - fop->timestamp) > EXPORT_EXPIRATION_TIME ||
+        fop->distance >= ALARM_ZONE_NONE) {
+      continue;
+    }
+
+    export_target_t t = { fop, Export_TCA(fop) };
+    int j = count++;
+
+    while (j > 0 && Export_Before(&t, &list[j-1])) {
+      list[j] = list[j-1];
+      j--;
+    }
+    list[j] = t;
+  }
+
+  return count;
+}
+
+/* tells whether a target of 'size' bytes should be written into the sink now */
+bool Export_Admit(uint8_t sink, const export_target_t *t, size_t size)
+{
+  export_sink_t *s = &export_sink[sink];
+  export_link_t *l = &export_link[s->link];
+  export_last_t *last = &s->last[t->fop - Container];
+
+  if (l->bps) {
+    bool urgent = t->fop->alarm_level > ALARM_LEVEL_NONE;
+
+    if (!urgent) {
+      uint8_t period = 1;
+
+      if (!Export_Converging(t)) {
+        period += (uint8_t) (t->fop->distance / EXPORT_DECIMATION);
+        if (period > EXPORT_MAX_PERIOD) {
+          period = EXPORT_MAX_PERIOD;
+        }
+      }
+
+      if (last->addr == t->fop->addr &&
+          (uint8_t) (s->tick - last->tick) < period) {
+        Export_stats.decimated++;
+        return false;
+      }
+
+      if (l->budget < (int32_t) size) {
+        Export_stats.deferred++;
+        return false;
+      }
+    } else if (l->budget < (int32_t) size) {
+      Export_stats.forced++;
+    }
+
+    l->budget -= (int32_t) size;
+  }
+
+  last->addr = t->fop->addr;
+  last->tick = s->tick;
+  Export_stats.sent++;
+
+  return true;
+}
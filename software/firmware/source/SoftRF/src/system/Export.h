@@ -0,0 +1,83 @@
+/*
+ * ExportHelper.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORTHELPER_H
+#define EXPORTHELPER_H
+
+#include "../../SoftRF.h"
+
+/*
+ * Bytes per second that a data port can take, 0 - no limit.
+ * Can be overridden by platform-specific code.
+ */
+#if !defined(EXPORT_UART_BPS)
+#define EXPORT_UART_BPS       (SERIAL_OUT_BR / 10) /* 8N1 */
+#endif
+#if !defined(EXPORT_USB_BPS)
+#define EXPORT_USB_BPS        EXPORT_UART_BPS
+#endif
+#if !defined(EXPORT_BT_BPS)
+#define EXPORT_BT_BPS         2000 /* BLE UART service, SPP of HC-05 */
+#endif
+
+/* $PFLAU and GNSS sentences that share the port with $PFLAA ones */
+#define EXPORT_NMEA_RESERVE   256
+
+#define EXPORT_TCA_HORIZON    60   /* s, converging ones go at full rate */
+#define EXPORT_DECIMATION     2500 /* m, one more export tick of period per */
+#define EXPORT_MAX_PERIOD     4    /* export ticks */
+
+enum
+{
+  EXPORT_SINK_NMEA,
+  EXPORT_SINK_GDL90,
+  EXPORT_SINK_D1090,
+  EXPORT_SINKS
+};
+
+/* NMEA_*, GDL90_* and D1090_* destinations share the same numbering */
+enum
+{
+  EXPORT_LINK_OFF,
+  EXPORT_LINK_UART,
+  EXPORT_LINK_UDP,
+  EXPORT_LINK_TCP,
+  EXPORT_LINK_USB,
+  EXPORT_LINK_BLUETOOTH,
+  EXPORT_LINKS
+};
+
+typedef struct export_target_struct {
+  ufo_t *fop;
+  float tca;      /* s to the closest approach, < 0 - diverging */
+} export_target_t;
+
+typedef struct export_stats_struct {
+  uint32_t sent;
+  uint32_t forced;     /* urgent ones that went over the budget */
+  uint32_t decimated;  /* distant ones skipped until their period is over */
+  uint32_t deferred;   /* out of the budget */
+} export_stats_t;
+
+void Export_setup(void);
+int  Export_Begin(uint8_t, uint8_t, export_target_t *, size_t);
+bool Export_Admit(uint8_t, const export_target_t *, size_t);
+
+extern export_stats_t Export_stats;
+
+#endif /* EXPORTHELPER_H */
@@ -0,0 +1,197 @@
+/*
+ * PositionHelper.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Position.h"
+#include "Profile.h"
+#include "../driver/GNSS.h"
+
+/* this aircraft, the origin of north/east of every target */
+typedef struct position_ref_struct {
+  float    latitude;
+  float    longitude;
+  int32_t  lat_e7;
+  int32_t  lon_e7;
+  int64_t  east_q32;  /* metres per 1e-7 degree of longitude, in 1/2^32 m */
+} position_ref_t;
+
+static position_ref_t position_ref = {
+  0, 0, 0, 0, POSITION_M_PER_E7_Q32
+};
+
+/* the only floating point work left, it is done once per fix of this aircraft */
+void Position_Reference(ufo_t *this_aircraft)
+{
+  if (this_aircraft->latitude  != position_ref.latitude ||
+      this_aircraft->longitude != position_ref.longitude) {
+    position_ref.latitude  = this_aircraft->latitude;
+    position_ref.longitude = this_aircraft->longitude;
+    position_ref.lat_e7    = POSITION_E7(this_aircraft->latitude);
+    position_ref.lon_e7    = POSITION_E7(this_aircraft->longitude);
+    position_ref.east_q32  = (int64_t) (POSITION_M_PER_E7_Q32 *
+                                        cos(radians(this_aircraft->latitude)));
+  }
+
+  this_aircraft->lat_e7 = position_ref.lat_e7;
+  this_aircraft->lon_e7 = position_ref.lon_e7;
+  this_aircraft->north  = 0;
+  this_aircraft->east   = 0;
+}
+
+void Position_Project(ufo_t *fop)
+{
+  int64_t dlat = (int64_t) fop->lat_e7 - position_ref.lat_e7;
+  int64_t dlon = (int64_t) fop->lon_e7 - position_ref.lon_e7;
+
+  /* across the antimeridian */
+  if (dlon > 1800000000LL) {
+    dlon -= 3600000000LL;
+  } else if (dlon < -1800000000LL) {
+    dlon += 3600000000LL;
+  }
+
+  fop->north = (int32_t) ((dlat * POSITION_M_PER_E7_Q32) >> 32);
+  fop->east  = (int32_t) ((dlon * position_ref.east_q32) >> 32);
+}
+
+uint32_t Position_Distance(int32_t north, int32_t east)
+{
+  uint64_t val = (int64_t) north * north + (int64_t) east * east;
+  uint64_t res = 0;
+  uint64_t bit = 1ULL << 62;
+
+  while (bit > val) {
+    bit >>= 2;
+  }
+
+  while (bit) {
+    if (val >= res + bit) {
+      val -= res + bit;
+      res  = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return (uint32_t) res;
+}
+
+/* degrees, 0 ... 359, clockwise from true north */
+uint16_t Position_Bearing(int32_t north, int32_t east)
+{
+  uint32_t n = north < 0 ? -(uint32_t) north : (uint32_t) north;
+  uint32_t e = east  < 0 ? -(uint32_t) east  : (uint32_t) east;
+  uint32_t lo = n < e ? n : e;
+  uint32_t hi = n < e ? e : n;
+  uint32_t r, a;
+
+  if (hi == 0) {
+    return 0;
+  }
+
+  while (hi > 0xFFFF) {
+    hi >>= 1;
+    lo >>= 1;
+  }
+
+  /* tangent of the angle off the nearest axis, Q15 */
+  r = (lo << 15) / hi;
+
+  /* atan(x) = 45x + x(1 - x)(14.02 + 3.80x) degrees, within 0.09, in 1/100 */
+  a = (r * (4500 + (((32768 - r) * (1402 + ((380 * r) >> 15))) >> 15))) >> 15;
+
+  if (e > n) {
+    a = 9000 - a;
+  }
+  if (north < 0) {
+    a = 18000 - a;
+  }
+  if (east < 0) {
+    a = 36000 - a;
+  }
+
+  return ((a + 50) / 100) % 360;
+}
+
+#if defined(USE_PROFILER)
+
+position_bench_t Position_bench;
+
+/*
+ * Conversion of decoded positions and the distance/bearing update,
+ * both the former floating point way and the fixed point one, over
+ * the same targets that are up to about 10 km away from a reference point.
+ */
+void Position_Benchmark()
+{
+  position_ref_t saved = position_ref;
+  ufo_t ref, fo;
+  volatile uint32_t sink = 0;
+  uint32_t start;
+
+  memset(&ref, 0, sizeof(ref));
+  memset(&fo,  0, sizeof(fo));
+
+  ref.latitude  = 47.3769;
+  ref.longitude = 8.5417;
+
+  start = Profile_Ticks();
+
+  for (int i = 0; i < POSITION_BENCH_TARGETS; i++) {
+    int32_t lat = 473769000L + (i - POSITION_BENCH_TARGETS / 2) * 28000L;
+    int32_t lon =  85417000L + ((i * 7) % POSITION_BENCH_TARGETS -
+                                POSITION_BENCH_TARGETS / 2) * 41000L;
+
+    fo.latitude  = (float) lat / 1e7;
+    fo.longitude = (float) lon / 1e7;
+
+    sink += (uint32_t) gnss.distanceBetween(ref.latitude, ref.longitude,
+                                            fo.latitude,  fo.longitude);
+    sink += (uint32_t) gnss.courseTo(ref.latitude, ref.longitude,
+                                     fo.latitude,  fo.longitude);
+  }
+
+  Position_bench.fp_ns = Profile_Nanos(Profile_Ticks() - start) /
+                         POSITION_BENCH_TARGETS;
+
+  start = Profile_Ticks();
+
+  Position_Reference(&ref);
+
+  for (int i = 0; i < POSITION_BENCH_TARGETS; i++) {
+    fo.lat_e7 = 473769000L + (i - POSITION_BENCH_TARGETS / 2) * 28000L;
+    fo.lon_e7 =  85417000L + ((i * 7) % POSITION_BENCH_TARGETS -
+                              POSITION_BENCH_TARGETS / 2) * 41000L;
+
+    /* still wanted by the data ports */
+    fo.latitude  = POSITION_DEG(fo.lat_e7);
+    fo.longitude = POSITION_DEG(fo.lon_e7);
+
+    Position_Project(&fo);
+    sink += Position_Distance(fo.north, fo.east);
+    sink += Position_Bearing(fo.north, fo.east);
+  }
+
+  Position_bench.fixed_ns = Profile_Nanos(Profile_Ticks() - start) /
+                            POSITION_BENCH_TARGETS;
+
+  position_ref = saved;
+}
+
+#endif /* USE_PROFILER */
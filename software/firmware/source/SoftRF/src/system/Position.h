@@ -0,0 +1,56 @@
+/*
+ * PositionHelper.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POSITIONHELPER_H
+#define POSITIONHELPER_H
+
+#include "../../SoftRF.h"
+
+/*
+ * Traffic positions are kept in ufo_t as integers of 1e-7 degree
+ * (lat_e7, lon_e7), the way they come over the air. Distance and bearing
+ * are taken from north/east metres relative to this aircraft, by a flat
+ * earth projection that needs no trigonometry per target.
+ * The float latitude/longitude are only there for the data ports.
+ */
+
+/* metres per 1e-7 degree of latitude, in 1/2^32 m. R = 6372795 m, as TinyGPS++ */
+#define POSITION_M_PER_E7_Q32   47771313LL
+
+#define POSITION_E7(deg)        ((int32_t) lround((double) (deg) * 1e7))
+#define POSITION_DEG(e7)        ((float) (e7) * 1e-7f)
+
+#define POSITION_BENCH_TARGETS  32
+
+typedef struct position_bench_struct {
+  uint32_t fp_ns;     /* per target; float lat/lon, TinyGPS++ distance and course */
+  uint32_t fixed_ns;  /* per target; fixed point projection */
+} position_bench_t;
+
+void     Position_Reference(ufo_t *);
+void     Position_Project(ufo_t *);
+uint32_t Position_Distance(int32_t, int32_t);
+uint16_t Position_Bearing(int32_t, int32_t);
+
+#if defined(USE_PROFILER)
+void     Position_Benchmark(void);
+
+extern position_bench_t Position_bench;
+#endif /* USE_PROFILER */
+
+#endif /* POSITIONHELPER_H */
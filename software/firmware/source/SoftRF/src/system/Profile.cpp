@@ -0,0 +1,146 @@
+/*
+ * ProfileHelper.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Profile.h"
+
+#if defined(USE_PROFILER)
+
+profile_stage_t Profile_stages[PROFILE_STAGES];
+uint32_t Profile_counters[PROFILE_COUNTERS];
+
+/* in order of the enums in Profile.h */
+const char *Profile_stage_name[PROFILE_STAGES] = {
+  "RX",       /* PROFILE_RF_RX */
+  "DECODE",   /* PROFILE_DECODE */
+  "TRAFFIC",  /* PROFILE_TRAFFIC */
+  "NMEA",     /* PROFILE_EXPORT_NMEA */
+  "GDL90",    /* PROFILE_EXPORT_GDL90 */
+  "D1090",    /* PROFILE_EXPORT_D1090 */
+  "DISPLAY"   /* PROFILE_DISPLAY */
+};
+
+const char *Profile_counter_name[PROFILE_COUNTERS] = {
+  "CRC",      /* PROFILE_CRC_ERRORS */
+  "FEC",      /* PROFILE_FEC_CORRECTIONS */
+  "OVERRUN",  /* PROFILE_OVERRUNS */
+  "DROP"      /* PROFILE_DROPS */
+};
+
+static uint32_t Profile_ticks_per_us = 1;
+
+void Profile_setup()
+{
+  memset(Profile_stages,   0, sizeof(Profile_stages));
+  memset(Profile_counters, 0, sizeof(Profile_counters));
+
+#if defined(RASPBERRY_PI)
+  Profile_ticks_per_us = 1000;
+#elif defined(ESP32) || defined(ESP8266)
+  Profile_ticks_per_us = ESP.getCpuFreqMHz();
+#elif defined(DWT)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+  Profile_ticks_per_us = SystemCoreClock / 1000000UL;
+#endif
+}
+
+void Profile_Add(uint8_t stage, uint32_t ticks)
+{
+  profile_stage_t *sp = &Profile_stages[stage];
+  uint32_t us = ticks / Profile_ticks_per_us;
+  uint8_t bin = 0;
+
+  while (bin < PROFILE_HIST_BINS - 1 && (us >> bin)) {
+    bin++;
+  }
+
+  sp->count++;
+  sp->total += us;
+  sp->hist[bin]++;
+  if (us > sp->max) {
+    sp->max = us;
+  }
+}
+
+uint32_t Profile_Nanos(uint32_t ticks)
+{
+  return (uint32_t) ((uint64_t) ticks * 1000 / Profile_ticks_per_us);
+}
+
+/* upper bound of the histogram bin that holds 'percent' of samples, in us */
+uint32_t Profile_Percentile(uint8_t stage, uint8_t percent)
+{
+  profile_stage_t *sp = &Profile_stages[stage];
+  uint32_t goal = (uint32_t) ((uint64_t) sp->count * percent / 100);
+  uint32_t sum = 0;
+  uint8_t bin;
+
+  for (bin = 0; bin < PROFILE_HIST_BINS - 1; bin++) {
+    sum += sp->hist[bin];
+    if (sum >= goal) {
+      break;
+    }
+  }
+
+  return bin == PROFILE_HIST_BINS - 1 ? sp->max : (1UL << bin) - 1;
+}
+
+size_t Profile_JSON(char *buf, size_t size)
+{
+  size_t len = 0;
+
+#define PROFILE_PRINT(...)  { int n = snprintf(buf + len, size - len, __VA_ARGS__); \
+                              if (n < 0 || (size_t) n >= size - len) return 0;        \
+                              len += n; }
+
+  PROFILE_PRINT("{\"stages\":{");
+
+  for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+    profile_stage_t *sp = &Profile_stages[i];
+
+    PROFILE_PRINT("%s\"%s\":{\"count\":%lu,\"avg\":%lu,\"max\":%lu,\"hist\":[",
+                  i ? "," : "", Profile_stage_name[i],
+                  (unsigned long) sp->count,
+                  (unsigned long) (sp->count ? sp->total / sp->count : 0),
+                  (unsigned long) sp->max);
+
+    for (uint8_t bin = 0; bin < PROFILE_HIST_BINS; bin++) {
+      PROFILE_PRINT("%s%lu", bin ? "," : "", (unsigned long) sp->hist[bin]);
+    }
+
+    PROFILE_PRINT("]}");
+  }
+
+  PROFILE_PRINT("},\"counters\":{");
+
+  for (uint8_t i = 0; i < PROFILE_COUNTERS; i++) {
+    PROFILE_PRINT("%s\"%s\":%lu", i ? "," : "", Profile_counter_name[i],
+                  (unsigned long) Profile_counters[i]);
+  }
+
+  PROFILE_PRINT("}}");
+
+#undef PROFILE_PRINT
+
+  return len;
+}
+
+#endif /* USE_PROFILER */
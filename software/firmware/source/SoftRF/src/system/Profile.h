@@ -0,0 +1,115 @@
+/*
+ * ProfileHelper.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILEHELPER_H
+#define PROFILEHELPER_H
+
+#include "SoC.h"
+
+enum
+{
+  PROFILE_RF_RX,
+  PROFILE_DECODE,
+  PROFILE_TRAFFIC,
+  PROFILE_EXPORT_NMEA,
+  PROFILE_EXPORT_GDL90,
+  PROFILE_EXPORT_D1090,
+  PROFILE_DISPLAY,
+  PROFILE_STAGES
+};
+
+enum
+{
+  PROFILE_CRC_ERRORS,       /* frames with bad CRC */
+  PROFILE_FEC_CORRECTIONS,  /* symbols fixed by Reed-Solomon */
+  PROFILE_OVERRUNS,         /* frames lost because a queue was full */
+  PROFILE_DROPS,            /* frames or targets thrown away on purpose */
+  PROFILE_COUNTERS
+};
+
+#if defined(USE_PROFILER)
+
+#define PSRFS_VERSION           1
+#define PROFILE_REPORT_INTERVAL 10000 /* ms */
+
+/* bin 0 is below 1 us, bin N holds 2^(N-1) ... 2^N - 1 us */
+#define PROFILE_HIST_BINS       16
+
+/*
+ * Free running counter of CPU cycles where the core has one,
+ * Profile_ticks_per_us of them make a microsecond.
+ */
+#if defined(RASPBERRY_PI)
+#include <time.h>
+
+static inline uint32_t Profile_Ticks()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t) ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+#elif defined(ESP32) || defined(ESP8266)
+#define Profile_Ticks()         ESP.getCycleCount()
+#elif defined(DWT)
+#define Profile_Ticks()         DWT->CYCCNT
+#else
+#define Profile_Ticks()         micros()
+#endif
+
+typedef struct profile_stage_struct {
+  uint32_t count;
+  uint32_t max;     /* us */
+  uint64_t total;   /* us */
+  uint32_t hist[PROFILE_HIST_BINS];
+} profile_stage_t;
+
+void   Profile_setup(void);
+void   Profile_Add(uint8_t, uint32_t);
+size_t Profile_JSON(char *, size_t);
+uint32_t Profile_Percentile(uint8_t, uint8_t);
+uint32_t Profile_Nanos(uint32_t);
+
+extern profile_stage_t Profile_stages[PROFILE_STAGES];
+extern uint32_t Profile_counters[PROFILE_COUNTERS];
+extern const char *Profile_stage_name[PROFILE_STAGES];
+extern const char *Profile_counter_name[PROFILE_COUNTERS];
+
+/* accounts time spent from here to the end of enclosing block */
+class Profile_Scope
+{
+  public:
+    Profile_Scope(uint8_t stage) : stage(stage), start(Profile_Ticks()) { }
+    ~Profile_Scope() { Profile_Add(stage, Profile_Ticks() - start); }
+
+  private:
+    uint8_t  stage;
+    uint32_t start;
+};
+
+#define PROFILE_SCOPE(stage)        Profile_Scope profile_scope_(stage)
+#define PROFILE_COUNT(counter, n)   (Profile_counters[counter] += (n))
+
+#else
+
+#define PROFILE_SCOPE(stage)
+#define PROFILE_COUNT(counter, n)
+
+#endif /* USE_PROFILER */
+
+#endif /* PROFILEHELPER_H */
@@ -0,0 +1,660 @@
+/*
+ * RecorderHelper.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Recorder.h"
+#include "Position.h"
+#include "../driver/GNSS.h"
+#include "../protocol/data/NMEA.h"
+
+#if defined(USE_RECORDER)
+
+#include <TimeLib.h>
+
+#define REC_HEADER_SIZE         8
+#define REC_FIX_SIZE            20
+#define REC_FIX_DELTA_SIZE      12
+#define REC_TRAFFIC_SIZE        27
+#define REC_TRAFFIC_DELTA_SIZE  20
+
+#define REC_ADDR_TYPE_MASK      0x3F
+#define REC_FLAG_STEALTH        0x40
+#define REC_FLAG_NO_TRACK       0x80
+
+/*
+ * Positions are stored in micro-degrees. Deltas of ownship fixes are taken
+ * against previous fix, deltas of traffic - against the last ownship fix
+ * with 10 micro-degrees (~1 m) resolution that covers about +/- 36 km.
+ */
+typedef struct rec_base_struct {
+  bool     valid;
+  uint32_t time;
+  int32_t  latitude;
+  int32_t  longitude;
+  int16_t  altitude;
+} rec_base_t;
+
+recorder_stats_t Recorder_stats;
+
+static FlashDev_ops_t *rec_dev = NULL;
+
+static uint32_t rec_sectors = 0;
+static uint32_t rec_sector  = 0;  /* head of the log */
+static uint32_t rec_seq     = 0;
+static uint32_t rec_offset  = 0;  /* write pointer in the head sector */
+static uint32_t rec_synced  = 0;  /* head sector data that is in flash already */
+static bool     rec_held    = false; /* the device has been busy */
+
+static uint8_t  rec_page[RECORDER_PAGE_SIZE];
+static rec_base_t rec_base;
+
+static time_t rec_last_fix = 0;
+static unsigned long RecorderSyncTimeMarker = 0;
+
+static void rec_put16(uint8_t *buf, uint16_t val)
+{
+  buf[0] =  val       & 0xFF;
+  buf[1] = (val >> 8) & 0xFF;
+}
+
+static void rec_put24(uint8_t *buf, uint32_t val)
+{
+  rec_put16(buf, val & 0xFFFF);
+  buf[2] = (val >> 16) & 0xFF;
+}
+
+static void rec_put32(uint8_t *buf, uint32_t val)
+{
+  rec_put16(buf,     val & 0xFFFF);
+  rec_put16(buf + 2, val >> 16);
+}
+
+static uint16_t rec_get16(const uint8_t *buf)
+{
+  return (uint16_t) buf[0] | ((uint16_t) buf[1] << 8);
+}
+
+static uint32_t rec_get24(const uint8_t *buf)
+{
+  return (uint32_t) rec_get16(buf) | ((uint32_t) buf[2] << 16);
+}
+
+static uint32_t rec_get32(const uint8_t *buf)
+{
+  return (uint32_t) rec_get16(buf) | ((uint32_t) rec_get16(buf + 2) << 16);
+}
+
+static int32_t rec_udeg(float deg)
+{
+  return (int32_t) lround((double) deg * 1000000.0);
+}
+
+static int32_t rec_div10(int32_t val)
+{
+  return val >= 0 ? (val + 5) / 10 : -((5 - val) / 10);
+}
+
+static size_t rec_record_size(uint8_t type)
+{
+  switch (type)
+  {
+  case RECORDER_REC_FIX:            return REC_FIX_SIZE;
+  case RECORDER_REC_FIX_DELTA:      return REC_FIX_DELTA_SIZE;
+  case RECORDER_REC_TRAFFIC:        return REC_TRAFFIC_SIZE;
+  case RECORDER_REC_TRAFFIC_DELTA:  return REC_TRAFFIC_DELTA_SIZE;
+  default:                          return 0;
+  }
+}
+
+/* Put course, speed and climb rate which are common for all the record types */
+static size_t rec_put_vector(uint8_t *buf, ufo_t *fop)
+{
+  buf[0] = (uint8_t) ((int) lroundf(fop->course * 256.0 / 360.0) & 0xFF);
+  rec_put16(buf + 1, (uint16_t) constrain(lroundf(fop->speed), 0, 65535));
+  rec_put16(buf + 3, (uint16_t) constrain(lroundf(fop->vs), -32768, 32767));
+
+  return 5;
+}
+
+static void rec_get_vector(const uint8_t *buf, ufo_t *fop)
+{
+  fop->course = buf[0] * 360.0 / 256.0;
+  fop->speed  = rec_get16(buf + 1);
+  fop->vs     = (int16_t) rec_get16(buf + 3);
+}
+
+/* Program the part of current page that has not been written yet */
+static void Recorder_Program()
+{
+  uint32_t size = rec_offset - rec_synced;
+
+  if (size > 0) {
+    uint32_t addr = rec_sector * RECORDER_SECTOR_SIZE + rec_synced;
+
+    if (!rec_dev->write(addr, rec_page + (rec_synced % RECORDER_PAGE_SIZE), size)) {
+      Recorder_stats.errors++;
+    }
+    rec_synced = rec_offset;
+  }
+
+  if (rec_offset % RECORDER_PAGE_SIZE == 0) {
+    memset(rec_page, 0xFF, sizeof(rec_page));
+  }
+}
+
+static void Recorder_Append(const uint8_t *buf, size_t size)
+{
+  Recorder_stats.bytes += size;
+
+  while (size > 0) {
+    size_t ndx = rec_offset % RECORDER_PAGE_SIZE;
+    size_t len = RECORDER_PAGE_SIZE - ndx;
+
+    if (len > size) {
+      len = size;
+    }
+
+    memcpy(rec_page + ndx, buf, len);
+    rec_offset += len;
+    buf        += len;
+    size       -= len;
+
+    if (rec_offset % RECORDER_PAGE_SIZE == 0) {
+      Recorder_Program();
+    }
+  }
+}
+
+static void Recorder_Next_Sector()
+{
+  uint8_t header[REC_HEADER_SIZE];
+
+  Recorder_Program();
+
+  rec_sector = (rec_sector + 1) % rec_sectors;
+  rec_seq++;
+
+  if (!rec_dev->erase(rec_sector * RECORDER_SECTOR_SIZE)) {
+    Recorder_stats.errors++;
+  }
+
+  rec_offset = rec_synced = 0;
+  memset(rec_page, 0xFF, sizeof(rec_page));
+  rec_base.valid = false;
+
+  rec_put32(header,     RECORDER_MAGIC);
+  rec_put32(header + 4, rec_seq);
+  Recorder_Append(header, sizeof(header));
+
+  Recorder_stats.sectors++;
+}
+
+/*
+ * The device may be shared with someone else (USB mass storage on nRF52)
+ * who could have touched the head sector meanwhile. Nothing is written
+ * while it is busy, after that the log goes on with a fresh sector.
+ * A partially filled page that has not been synced yet is lost.
+ */
+static bool Recorder_Ready()
+{
+  if (rec_dev == NULL) {
+    return false;
+  }
+
+  if (rec_dev->busy != NULL && rec_dev->busy()) {
+    rec_held = true;
+    return false;
+  }
+
+  if (rec_held) {
+    rec_offset = rec_synced = RECORDER_SECTOR_SIZE;
+    rec_held   = false;
+  }
+
+  return true;
+}
+
+/* Make sure that a record of given size fits into the head sector */
+static void Recorder_Reserve(size_t size)
+{
+  if (rec_offset + size > RECORDER_SECTOR_SIZE) {
+    Recorder_Next_Sector();
+  }
+}
+
+bool Recorder_setup()
+{
+  uint8_t header[REC_HEADER_SIZE];
+  bool found = false;
+
+  rec_dev = SoC->Recorder_ops;
+  if (rec_dev == NULL) {
+    return false;
+  }
+
+  rec_sectors = rec_dev->setup() / RECORDER_SECTOR_SIZE;
+  if (rec_sectors < 2) {
+    rec_dev = NULL;
+    return false;
+  }
+
+  /* look for the head of the log */
+  for (uint32_t i = 0; i < rec_sectors; i++) {
+    if (rec_dev->read(i * RECORDER_SECTOR_SIZE, header, sizeof(header)) &&
+        rec_get32(header) == RECORDER_MAGIC) {
+      uint32_t seq = rec_get32(header + 4);
+
+      if (!found || (int32_t) (seq - rec_seq) > 0) {
+        rec_seq    = seq;
+        rec_sector = i;
+        found      = true;
+      }
+    }
+  }
+
+  if (!found) {
+    rec_seq    = 0;
+    rec_sector = rec_sectors - 1;
+  }
+
+  /*
+   * Never append to a sector that was written before the restart:
+   * its last page state is unknown and delta base is gone anyway.
+   * Mark the head as full, so that a new sector gets erased and opened
+   * with very first record. Export and replay leave the log intact.
+   */
+  rec_offset = rec_synced = RECORDER_SECTOR_SIZE;
+  memset(rec_page, 0xFF, sizeof(rec_page));
+
+  RecorderSyncTimeMarker = millis();
+
+  return true;
+}
+
+void Recorder_loop()
+{
+  if (rec_dev == NULL) {
+    return;
+  }
+
+  if (isValidFix() && ThisAircraft.timestamp != rec_last_fix) {
+    Recorder_Fix(&ThisAircraft);
+    rec_last_fix = ThisAircraft.timestamp;
+  }
+
+  if (millis() - RecorderSyncTimeMarker > RECORDER_SYNC_INTERVAL) {
+    Recorder_Sync();
+    RecorderSyncTimeMarker = millis();
+  }
+}
+
+void Recorder_fini()
+{
+  if (rec_dev == NULL) {
+    return;
+  }
+
+  Recorder_Sync();
+  rec_dev->fini();
+  rec_dev = NULL;
+}
+
+void Recorder_Sync()
+{
+  if (Recorder_Ready()) {
+    Recorder_Program();
+  }
+}
+
+void Recorder_Fix(ufo_t *fop)
+{
+  uint8_t  buf[REC_FIX_SIZE];
+  size_t   size;
+
+  if (!Recorder_Ready()) {
+    return;
+  }
+
+  uint32_t time      = (uint32_t) fop->timestamp;
+  int32_t  latitude  = rec_udeg(fop->latitude);
+  int32_t  longitude = rec_udeg(fop->longitude);
+  int16_t  altitude  = constrain(lroundf(fop->altitude), -32768, 32767);
+
+  Recorder_Reserve(REC_FIX_SIZE);
+
+  int32_t dt   = time      - rec_base.time;
+  int32_t dlat = latitude  - rec_base.latitude;
+  int32_t dlon = longitude - rec_base.longitude;
+  int32_t dalt = altitude  - rec_base.altitude;
+
+  if (rec_base.valid && dt > 0 && dt <= 255 &&
+      dlat >= -32768 && dlat <= 32767 &&
+      dlon >= -32768 && dlon <= 32767 &&
+      dalt >= -128   && dalt <= 127) {
+    buf[0] = RECORDER_REC_FIX_DELTA;
+    buf[1] = (uint8_t) dt;
+    rec_put16(buf + 2, (uint16_t) dlat);
+    rec_put16(buf + 4, (uint16_t) dlon);
+    buf[6] = (uint8_t) dalt;
+    size = 7;
+
+    Recorder_stats.deltas++;
+  } else {
+    buf[0] = RECORDER_REC_FIX;
+    rec_put32(buf + 1,  time);
+    rec_put32(buf + 5,  (uint32_t) latitude);
+    rec_put32(buf + 9,  (uint32_t) longitude);
+    rec_put16(buf + 13, (uint16_t) altitude);
+    size = 15;
+  }
+
+  size += rec_put_vector(buf + size, fop);
+
+  Recorder_Append(buf, size);
+
+  rec_base.valid     = true;
+  rec_base.time      = time;
+  rec_base.latitude  = latitude;
+  rec_base.longitude = longitude;
+  rec_base.altitude  = altitude;
+
+  Recorder_stats.fixes++;
+}
+
+void Recorder_Traffic(ufo_t *fop)
+{
+  uint8_t  buf[REC_TRAFFIC_SIZE];
+  size_t   size;
+
+  if (!Recorder_Ready()) {
+    return;
+  }
+
+  uint32_t time      = (uint32_t) fop->timestamp;
+  int32_t  latitude  = rec_udeg(fop->latitude);
+  int32_t  longitude = rec_udeg(fop->longitude);
+  int16_t  altitude  = constrain(lroundf(fop->altitude), -32768, 32767);
+
+  Recorder_Reserve(REC_TRAFFIC_SIZE);
+
+  int32_t dt   = time - rec_base.time;
+  int32_t dlat = rec_div10(latitude  - rec_base.latitude);
+  int32_t dlon = rec_div10(longitude - rec_base.longitude);
+  bool    rel  = rec_base.valid && dt >= -128 && dt <= 127 &&
+                 dlat >= -32768 && dlat <= 32767 &&
+                 dlon >= -32768 && dlon <= 32767;
+
+  if (rel) {
+    buf[0] = RECORDER_REC_TRAFFIC_DELTA;
+    buf[1] = (uint8_t) dt;
+    size = 2;
+  } else {
+    buf[0] = RECORDER_REC_TRAFFIC;
+    rec_put32(buf + 1, time);
+    size = 5;
+  }
+
+  rec_put24(buf + size, fop->addr);
+  buf[size + 3] = (fop->addr_type & REC_ADDR_TYPE_MASK) |
+                  (fop->stealth  ? REC_FLAG_STEALTH  : 0) |
+                  (fop->no_track ? REC_FLAG_NO_TRACK : 0);
+  buf[size + 4] = fop->protocol;
+  buf[size + 5] = fop->aircraft_type;
+  buf[size + 6] = (uint8_t) fop->rssi;
+  size += 7;
+
+  if (rel) {
+    rec_put16(buf + size,     (uint16_t) dlat);
+    rec_put16(buf + size + 2, (uint16_t) dlon);
+    rec_put16(buf + size + 4, (uint16_t) (altitude - rec_base.altitude));
+    size += 6;
+
+    Recorder_stats.deltas++;
+  } else {
+    rec_put32(buf + size,     (uint32_t) latitude);
+    rec_put32(buf + size + 4, (uint32_t) longitude);
+    rec_put16(buf + size + 8, (uint16_t) altitude);
+    size += 10;
+  }
+
+  size += rec_put_vector(buf + size, fop);
+
+  Recorder_Append(buf, size);
+
+  Recorder_stats.traffic++;
+}
+
+/*
+ * Walk through the log from the oldest sector to the head one
+ * and hand every decoded record over to the callback.
+ */
+unsigned int Recorder_Read(void (*callback)(uint8_t, ufo_t *))
+{
+  uint8_t buf[REC_TRAFFIC_SIZE];
+  unsigned int count = 0;
+  ufo_t rec;
+
+  if (rec_dev == NULL) {
+    return 0;
+  }
+
+  Recorder_Sync();
+
+  for (uint32_t i = 1; i <= rec_sectors; i++) {
+    uint32_t sector = (rec_sector + i) % rec_sectors;
+    uint32_t addr   = sector * RECORDER_SECTOR_SIZE;
+    uint32_t offset = REC_HEADER_SIZE;
+    rec_base_t base;
+
+    if (!rec_dev->read(addr, buf, REC_HEADER_SIZE) ||
+        rec_get32(buf) != RECORDER_MAGIC) {
+      continue;
+    }
+
+    base.valid = false;
+
+    while (offset < RECORDER_SECTOR_SIZE) {
+      if (!rec_dev->read(addr + offset, buf, 1)) {
+        break;
+      }
+
+      size_t size = rec_record_size(buf[0]);
+
+      if (size == 0 || offset + size > RECORDER_SECTOR_SIZE ||
+          !rec_dev->read(addr + offset, buf, size)) {
+        break;
+      }
+      offset += size;
+
+      memset(&rec, 0, sizeof(rec));
+      const uint8_t *ptr = buf + 1;
+
+      switch (buf[0])
+      {
+      case RECORDER_REC_FIX:
+      case RECORDER_REC_FIX_DELTA:
+        if (buf[0] == RECORDER_REC_FIX) {
+          base.time      = rec_get32(ptr);
+          base.latitude  = (int32_t) rec_get32(ptr + 4);
+          base.longitude = (int32_t) rec_get32(ptr + 8);
+          base.altitude  = (int16_t) rec_get16(ptr + 12);
+          ptr += 14;
+        } else if (base.valid) {
+          base.time      += ptr[0];
+          base.latitude  += (int16_t) rec_get16(ptr + 1);
+          base.longitude += (int16_t) rec_get16(ptr + 3);
+          base.altitude  += (int8_t) ptr[5];
+          ptr += 6;
+        } else {
+          continue;
+        }
+        base.valid = true;
+
+        rec.timestamp = base.time;
+        rec.lat_e7    = base.latitude  * 10;
+        rec.lon_e7    = base.longitude * 10;
+        rec.latitude  = POSITION_DEG(rec.lat_e7);
+        rec.longitude = POSITION_DEG(rec.lon_e7);
+        rec.altitude  = base.altitude;
+        rec_get_vector(ptr, &rec);
+
+        (*callback)(RECORDER_OWNSHIP, &rec);
+        count++;
+        break;
+
+      case RECORDER_REC_TRAFFIC:
+      case RECORDER_REC_TRAFFIC_DELTA:
+        if (buf[0] == RECORDER_REC_TRAFFIC) {
+          rec.timestamp = rec_get32(ptr);
+          ptr += 4;
+        } else if (base.valid) {
+          rec.timestamp = base.time + (int8_t) ptr[0];
+          ptr += 1;
+        } else {
+          continue;
+        }
+
+        rec.addr          = rec_get24(ptr);
+        rec.addr_type     = ptr[3] & REC_ADDR_TYPE_MASK;
+        rec.stealth       = (ptr[3] & REC_FLAG_STEALTH)  != 0;
+        rec.no_track      = (ptr[3] & REC_FLAG_NO_TRACK) != 0;
+        rec.protocol      = ptr[4];
+        rec.aircraft_type = ptr[5];
+        rec.rssi          = (int8_t) ptr[6];
+        ptr += 7;
+
+        if (buf[0] == RECORDER_REC_TRAFFIC) {
+          rec.lat_e7    = (int32_t) rec_get32(ptr)     * 10;
+          rec.lon_e7    = (int32_t) rec_get32(ptr + 4) * 10;
+          rec.altitude  = (int16_t) rec_get16(ptr + 8);
+          ptr += 10;
+        } else {
+          rec.lat_e7    = (base.latitude  + 10 * (int16_t) rec_get16(ptr))     * 10;
+          rec.lon_e7    = (base.longitude + 10 * (int16_t) rec_get16(ptr + 2)) * 10;
+          rec.altitude  = base.altitude + (int16_t) rec_get16(ptr + 4);
+          ptr += 6;
+        }
+        rec.latitude  = POSITION_DEG(rec.lat_e7);
+        rec.longitude = POSITION_DEG(rec.lon_e7);
+        rec_get_vector(ptr, &rec);
+
+        (*callback)(RECORDER_TRAFFIC, &rec);
+        count++;
+        break;
+      }
+    }
+  }
+
+  return count;
+}
+
+static uint8_t rec_dest;
+static uint8_t rec_format;
+static bool    rec_igc_header;
+
+static void Recorder_Export_Line(const char *line)
+{
+  NMEA_Out(rec_dest, (byte *) line, strlen(line), true);
+}
+
+static void Recorder_Export_IGC(uint8_t type, ufo_t *fop)
+{
+  char buf[64];
+
+  /* IGC flight log is about ownship track only */
+  if (type != RECORDER_OWNSHIP) {
+    return;
+  }
+
+  time_t t = fop->timestamp;
+
+  if (!rec_igc_header) {
+    Recorder_Export_Line("AXXXSRF SoftRF " SOFTRF_FIRMWARE_VERSION);
+    snprintf_P(buf, sizeof(buf), PSTR("HFDTEDATE:%02d%02d%02d,01"),
+               day(t), month(t), year(t) % 100);
+    Recorder_Export_Line(buf);
+    Recorder_Export_Line("HFFTYFRTYPE:SoftRF");
+    Recorder_Export_Line("HFGPSRECEIVER:SoftRF");
+    rec_igc_header = true;
+  }
+
+  /* in 1/1000 of minute, clamped so that every field keeps its width */
+  uint32_t lat = constrain(lround(fabs(fop->latitude)  * 60000.0), 0L,  90L * 60000);
+  uint32_t lon = constrain(lround(fabs(fop->longitude) * 60000.0), 0L, 180L * 60000);
+  int16_t  alt = constrain(lroundf(fop->altitude), -9999L, 32767L);
+
+  snprintf_P(buf, sizeof(buf),
+             PSTR("B%02u%02u%02u%02u%05u%c%03u%05u%cA%05d%05d"),
+             (uint8_t) hour(t), (uint8_t) minute(t), (uint8_t) second(t),
+             (uint8_t) (lat / 60000), (uint16_t) (lat % 60000),
+             fop->latitude  < 0 ? 'S' : 'N',
+             (uint8_t) (lon / 60000), (uint16_t) (lon % 60000),
+             fop->longitude < 0 ? 'W' : 'E',
+             0, alt);
+  Recorder_Export_Line(buf);
+}
+
+static void Recorder_Export_CSV(uint8_t type, ufo_t *fop)
+{
+  char buf[112];
+
+  long lat = labs(rec_udeg(fop->latitude));
+  long lon = labs(rec_udeg(fop->longitude));
+
+  snprintf_P(buf, sizeof(buf),
+             PSTR("%c,%lu,%06X,%u,%u,%u,%d,%s%ld.%06ld,%s%ld.%06ld,%d,%d,%d,%d"),
+             type == RECORDER_OWNSHIP ? 'O' : 'T',
+             (unsigned long) fop->timestamp,
+             (unsigned int) fop->addr, fop->addr_type, fop->protocol,
+             fop->aircraft_type, fop->rssi,
+             fop->latitude  < 0 ? "-" : "", lat / 1000000, lat % 1000000,
+             fop->longitude < 0 ? "-" : "", lon / 1000000, lon % 1000000,
+             (int) fop->altitude, (int) lroundf(fop->course),
+             (int) fop->speed, (int) fop->vs);
+  Recorder_Export_Line(buf);
+}
+
+static void Recorder_Export_Record(uint8_t type, ufo_t *fop)
+{
+  switch (rec_format)
+  {
+  case RECORDER_EXPORT_CSV:
+    Recorder_Export_CSV(type, fop);
+    break;
+  case RECORDER_EXPORT_IGC:
+  default:
+    Recorder_Export_IGC(type, fop);
+    break;
+  }
+}
+
+unsigned int Recorder_Export(uint8_t format, uint8_t dest)
+{
+  rec_dest       = dest;
+  rec_format     = format;
+  rec_igc_header = false;
+
+  if (format == RECORDER_EXPORT_CSV) {
+    Recorder_Export_Line("type,time,addr,addr_type,protocol,aircraft_type,rssi,"
+                         "latitude,longitude,altitude,course,speed,vs");
+  }
+
+  return Recorder_Read(Recorder_Export_Record);
+}
+
+#endif /* USE_RECORDER */
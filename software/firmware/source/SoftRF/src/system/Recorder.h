@@ -0,0 +1,84 @@
+/*
+ * RecorderHelper.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDERHELPER_H
+#define RECORDERHELPER_H
+
+#include "../../SoftRF.h"
+
+#if defined(USE_RECORDER)
+
+#define RECORDER_SECTOR_SIZE    4096  /* erase unit of the log area */
+#define RECORDER_PAGE_SIZE      256   /* program unit of the log area */
+#define RECORDER_SYNC_INTERVAL  30000 /* ms, flush of partially filled page */
+
+#define RECORDER_MAGIC          0x4C465253UL /* "SRFL" */
+
+/*
+ * The log area is a ring of sectors. Every sector begins with
+ * a header that carries a sequence number, the sector with the highest
+ * one is the head of the log. Records never cross a sector boundary and
+ * each sector is self-contained: delta-encoded records only refer
+ * to an ownship fix that has been written into the same sector.
+ */
+enum
+{
+  RECORDER_REC_FIX           = 0x01,
+  RECORDER_REC_FIX_DELTA     = 0x02,
+  RECORDER_REC_TRAFFIC       = 0x03,
+  RECORDER_REC_TRAFFIC_DELTA = 0x04,
+  RECORDER_REC_NONE          = 0xFF  /* erased flash */
+};
+
+enum
+{
+  RECORDER_OWNSHIP,
+  RECORDER_TRAFFIC
+};
+
+enum
+{
+  RECORDER_EXPORT_IGC,
+  RECORDER_EXPORT_CSV
+};
+
+typedef struct recorder_stats_struct {
+  uint32_t fixes;
+  uint32_t traffic;
+  uint32_t deltas;
+  uint32_t bytes;
+  uint32_t sectors;
+  uint32_t errors;
+} recorder_stats_t;
+
+bool Recorder_setup(void);
+void Recorder_loop(void);
+void Recorder_fini(void);
+
+void Recorder_Fix(ufo_t *);
+void Recorder_Traffic(ufo_t *);
+void Recorder_Sync(void);
+
+unsigned int Recorder_Read(void (*)(uint8_t, ufo_t *));
+unsigned int Recorder_Export(uint8_t, uint8_t);
+
+extern recorder_stats_t Recorder_stats;
+
+#endif /* USE_RECORDER */
+
+#endif /* RECORDERHELPER_H */
@@ -0,0 +1,226 @@
+/*
+ * RelayHelper.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Relay.h"
+
+#if defined(USE_RELAY)
+
+/*
+ * Every (address, position time) pair that has been relayed, either by
+ * this device or by a neighbour, is remembered for RELAY_SEEN_TIME.
+ * The set is a small open addressing hash table with a bounded probe
+ * sequence: an expired slot is as good as an empty one.
+ */
+typedef struct relay_seen_struct {
+  uint32_t key;
+  uint32_t expires; /* millis(), 0 - empty */
+} relay_seen_t;
+
+/* Packets ready to go out, already marked as relayed by the caller */
+typedef struct relay_entry_struct {
+  uint32_t key;
+  uint32_t timestamp;
+  uint8_t  rank;     /* higher goes first */
+  uint8_t  airtime;  /* ms */
+  uint8_t  size;     /* 0 - empty */
+  uint8_t  pkt[RELAY_PKT_SIZE];
+} relay_entry_t;
+
+relay_stats_t Relay_stats;
+
+static relay_seen_t  relay_seen[RELAY_SEEN_SIZE];
+static relay_entry_t relay_queue[RELAY_QUEUE_SIZE];
+
+static uint32_t relay_budget = 0; /* us of airtime */
+static uint32_t relay_budget_marker = 0;
+
+static inline uint32_t relay_hash(uint32_t key)
+{
+  return (key * 2654435761UL) >> 16;
+}
+
+static inline bool relay_expired(const relay_seen_t *entry, uint32_t ms)
+{
+  return entry->expires == 0 || (int32_t) (ms - entry->expires) >= 0;
+}
+
+void Relay_setup()
+{
+  memset(relay_seen,  0, sizeof(relay_seen));
+  memset(relay_queue, 0, sizeof(relay_queue));
+  memset(&Relay_stats, 0, sizeof(Relay_stats));
+
+  relay_budget        = RELAY_BURST_TIME * 1000UL;
+  relay_budget_marker = millis();
+}
+
+bool Relay_Seen(uint32_t key)
+{
+  uint32_t ms = millis();
+  uint32_t h = relay_hash(key);
+
+  for (uint8_t i = 0; i < RELAY_SEEN_PROBES; i++) {
+    relay_seen_t *entry = &relay_seen[(h + i) & (RELAY_SEEN_SIZE - 1)];
+
+    if (entry->key == key && !relay_expired(entry, ms)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void Relay_Mark(uint32_t key)
+{
+  uint32_t ms = millis();
+  uint32_t h = relay_hash(key);
+  relay_seen_t *slot = NULL;
+
+  for (uint8_t i = 0; i < RELAY_SEEN_PROBES; i++) {
+    relay_seen_t *entry = &relay_seen[(h + i) & (RELAY_SEEN_SIZE - 1)];
+
+    if (entry->key == key || relay_expired(entry, ms)) {
+      slot = entry;
+      break;
+    }
+    /* the table is full here, push out the one that expires first */
+    if (slot == NULL || (int32_t) (entry->expires - slot->expires) < 0) {
+      slot = entry;
+    }
+  }
+
+  slot->key     = key;
+  slot->expires = (ms + RELAY_SEEN_TIME) | 1;
+
+  /* a neighbour has done the job */
+  for (uint8_t i = 0; i < RELAY_QUEUE_SIZE; i++) {
+    if (relay_queue[i].size && relay_queue[i].key == key) {
+      relay_queue[i].size = 0;
+      Relay_stats.duplicates++;
+    }
+  }
+}
+
+bool Relay_Candidate(const void *pkt, size_t size, uint32_t key,
+                     uint8_t rank, uint8_t airtime)
+{
+  relay_entry_t *slot = NULL;
+
+  if (size > RELAY_PKT_SIZE) {
+    return false;
+  }
+
+  if (Relay_Seen(key)) {
+    Relay_stats.duplicates++;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < RELAY_QUEUE_SIZE; i++) {
+    relay_entry_t *entry = &relay_queue[i];
+
+    /* a newer position of the same aircraft replaces the older one */
+    if (entry->size && RELAY_KEY_ADDR(entry->key) == RELAY_KEY_ADDR(key)) {
+      slot = entry;
+      break;
+    }
+    /* otherwise a free entry or the lowest ranked one */
+    if (slot == NULL ||
+        (slot->size && (entry->size == 0 || entry->rank < slot->rank))) {
+      slot = entry;
+    }
+  }
+
+  if (slot->size) {
+    if (RELAY_KEY_ADDR(slot->key) == RELAY_KEY_ADDR(key)) {
+      Relay_stats.replaced++;
+    } else {
+      /* either the new one or the lowest ranked one in the queue is lost */
+      Relay_stats.dropped++;
+
+      if (slot->rank >= rank) {
+        /* the queue is full of more important ones */
+        return false;
+      }
+    }
+  }
+
+  slot->key       = key;
+  slot->timestamp = millis();
+  slot->rank      = rank;
+  slot->airtime   = airtime;
+  slot->size      = size;
+  memcpy(slot->pkt, pkt, size);
+
+  Relay_stats.candidates++;
+
+  return true;
+}
+
+/* returns size of the packet that is due for relaying now, 0 - if none */
+size_t Relay_Next(void *pkt)
+{
+  uint32_t ms = millis();
+  relay_entry_t *best = NULL;
+
+  relay_budget += (ms - relay_budget_marker) * RELAY_DUTY_CYCLE;
+  relay_budget_marker = ms;
+  if (relay_budget > RELAY_BURST_TIME * 1000UL) {
+    relay_budget = RELAY_BURST_TIME * 1000UL;
+  }
+
+  for (uint8_t i = 0; i < RELAY_QUEUE_SIZE; i++) {
+    relay_entry_t *entry = &relay_queue[i];
+
+    if (entry->size == 0) {
+      continue;
+    }
+    if (ms - entry->timestamp > RELAY_MAX_AGE) {
+      entry->size = 0;
+      Relay_stats.expired++;
+      continue;
+    }
+    if (best == NULL || entry->rank > best->rank) {
+      best = entry;
+    }
+  }
+
+  if (best == NULL) {
+    return 0;
+  }
+
+  /* wait for the duty cycle budget to refill */
+  if (relay_budget < best->airtime * 1000UL) {
+    return 0;
+  }
+
+  size_t size = best->size;
+
+  memcpy(pkt, best->pkt, size);
+  best->size = 0;
+
+  Relay_Mark(best->key);
+
+  relay_budget -= best->airtime * 1000UL;
+  Relay_stats.relayed++;
+  Relay_stats.airtime += best->airtime;
+
+  return size;
+}
+
+#endif /* USE_RELAY */
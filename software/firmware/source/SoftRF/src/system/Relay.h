@@ -0,0 +1,63 @@
+/*
+ * RelayHelper.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RELAYHELPER_H
+#define RELAYHELPER_H
+
+#include "../../SoftRF.h"
+
+#if defined(USE_RELAY)
+
+#define RELAY_SEEN_SIZE     64     /* power of two */
+#define RELAY_SEEN_PROBES   8
+#define RELAY_SEEN_TIME     20000  /* ms, well below a minute of position time */
+#define RELAY_QUEUE_SIZE    4
+#define RELAY_MAX_AGE       5000   /* ms */
+#define RELAY_PKT_SIZE      32
+
+/* Airtime spent on relaying, in per mille. 1% is the limit of 868.2/868.4 */
+#define RELAY_DUTY_CYCLE    5
+#define RELAY_BURST_TIME    20     /* ms of airtime that may go out at once */
+
+/* 24 bits of address, 2 bits of its type, 6 bits of position time */
+#define RELAY_KEY(addr, type, sec)  (((uint32_t) (addr) & 0xFFFFFF)       | \
+                                     (((uint32_t) (type) & 0x3)   << 24) | \
+                                     (((uint32_t) (sec)  % 60)    << 26))
+#define RELAY_KEY_ADDR(key)         ((key) & 0x3FFFFFF)
+
+typedef struct relay_stats_struct {
+  uint32_t candidates;  /* heard directly and worth relaying */
+  uint32_t relayed;
+  uint32_t duplicates;  /* relayed by a neighbour or by this device already */
+  uint32_t expired;     /* too old */
+  uint32_t replaced;    /* superseded by a newer position of the same aircraft */
+  uint32_t dropped;     /* lost the place in a full queue by too low rank */
+  uint32_t airtime;     /* ms */
+} relay_stats_t;
+
+void   Relay_setup(void);
+bool   Relay_Seen(uint32_t);
+void   Relay_Mark(uint32_t);
+bool   Relay_Candidate(const void *, size_t, uint32_t, uint8_t, uint8_t);
+size_t Relay_Next(void *);
+
+extern relay_stats_t Relay_stats;
+
+#endif /* USE_RELAY */
+
+#endif /* RELAYHELPER_H */
@@ -58,6 +58,7 @@ typedef struct SoC_ops_struct {
   IODev_ops_t *Bluetooth_ops;
   IODev_ops_t *USB_ops;
   IODev_ops_t *UART_ops;
+  FlashDev_ops_t *Recorder_ops;
   byte (*Display_setup)();
   void (*Display_loop)();
   void (*Display_fini)(int);
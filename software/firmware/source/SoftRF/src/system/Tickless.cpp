@@ -0,0 +1,176 @@
+/*
+ * TicklessHelper.cpp
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Tickless.h"
+#include "../driver/EEPROM.h"
+#include "../driver/RF.h"
+
+#if defined(USE_TICKLESS)
+
+/*
+ * At the end of every pass of the main loop the MCU sleeps until
+ * the earliest deadline that a subsystem has asked for, no longer than
+ * TICKLESS_MAX_SLEEP. An interrupt of the radio or of the GNSS PPS
+ * cuts the sleep short. Deadlines are one-shot, a subsystem sets it again
+ * when it has got the next one.
+ */
+tickless_stats_t Tickless_stats;
+
+static volatile bool tickless_event = false;
+static bool     tickless_armed    = false;
+static uint32_t tickless_deadline = 0;
+static uint32_t tickless_marker   = 0; /* millis() of the last wake up */
+
+#if defined(ARDUINO_ARCH_NRF52)
+
+/*
+ * The loop is a FreeRTOS task. While it waits for a notification
+ * the idle task puts the core into sd_app_evt_wait() (tickless idle).
+ */
+static TaskHandle_t tickless_task = NULL;
+
+static void Tickless_Idle(uint32_t ms)
+{
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+}
+
+static void Tickless_Wake()
+{
+  BaseType_t woken = pdFALSE;
+
+  if (tickless_task) {
+    vTaskNotifyGiveFromISR(tickless_task, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+#elif defined(ARDUINO_ARCH_STM32) || defined(__ASR6501__)
+
+/*
+ * Plain sleep mode, SysTick or any other interrupt wakes the core up.
+ * Stop mode would halt the clocks of the radio SPI, GNSS UART and millis().
+ */
+static void Tickless_Idle(uint32_t ms)
+{
+  uint32_t start = millis();
+
+  while (!tickless_event && (millis() - start) < ms) {
+    __WFI();
+  }
+}
+
+static void Tickless_Wake() { }
+
+#else
+#error "This hardware platform is not supported!"
+#endif
+
+void Tickless_setup()
+{
+  memset(&Tickless_stats, 0, sizeof(Tickless_stats));
+
+#if defined(ARDUINO_ARCH_NRF52)
+  tickless_task = xTaskGetCurrentTaskHandle();
+#endif /* ARDUINO_ARCH_NRF52 */
+
+#if defined(TICKLESS_WAKE_PIN)
+  /* RxDone of the radio */
+  if (TICKLESS_WAKE_PIN != SOC_UNUSED_PIN && rf_chip &&
+      (rf_chip->type == RF_IC_SX1276 || rf_chip->type == RF_IC_SX1262)) {
+    pinMode(TICKLESS_WAKE_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(TICKLESS_WAKE_PIN),
+                    Tickless_Event, RISING);
+  }
+#endif /* TICKLESS_WAKE_PIN */
+
+  tickless_marker = millis();
+}
+
+/* subsystem wants to run at 'ms', in terms of millis() */
+void Tickless_Due(uint32_t ms)
+{
+  if (!tickless_armed || (int32_t) (ms - tickless_deadline) < 0) {
+    tickless_deadline = ms;
+    tickless_armed    = true;
+  }
+}
+
+/* is safe to call from an interrupt handler */
+void Tickless_Event()
+{
+  tickless_event = true;
+  Tickless_Wake();
+}
+
+void Tickless_loop()
+{
+  uint32_t ms = millis();
+  uint32_t sleep = TICKLESS_MAX_SLEEP;
+
+  Tickless_stats.run_ms += ms - tickless_marker;
+
+  /* test and UAV modes need the loop to spin */
+  if (settings->mode != SOFTRF_MODE_NORMAL &&
+      settings->mode != SOFTRF_MODE_WATCHOUT) {
+    sleep = 0;
+  }
+
+  if (tickless_armed) {
+    int32_t due = (int32_t) (tickless_deadline - ms);
+
+    if (due <= 0) {
+      tickless_armed = false;
+      sleep = 0;
+    } else if ((uint32_t) due < sleep) {
+      sleep = due;
+    }
+  }
+
+  if (sleep > 0 && !tickless_event) {
+    Tickless_Idle(sleep);
+
+    if (tickless_event) {
+      Tickless_stats.events++;
+    } else {
+      Tickless_stats.timeouts++;
+    }
+  } else {
+    yield();
+  }
+
+  tickless_event  = false;
+  tickless_marker = millis();
+  Tickless_stats.sleep_ms += tickless_marker - ms;
+}
+
+/* estimated average current of the MCU core, uA */
+uint32_t Tickless_Current()
+{
+  uint64_t total = (uint64_t) Tickless_stats.run_ms + Tickless_stats.sleep_ms;
+
+  if (total == 0) {
+    return TICKLESS_RUN_UA;
+  }
+
+  return (uint32_t) (((uint64_t) Tickless_stats.run_ms   * TICKLESS_RUN_UA +
+                      (uint64_t) Tickless_stats.sleep_ms * TICKLESS_SLEEP_UA) /
+                     total);
+}
+
+#endif /* USE_TICKLESS */
@@ -0,0 +1,62 @@
+/*
+ * TicklessHelper.h
+ * Copyright (C) 2021 Linar Yusupov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICKLESSHELPER_H
+#define TICKLESSHELPER_H
+
+#include "SoC.h"
+
+#if defined(USE_TICKLESS)
+
+/*
+ * Upper limit of a sleep. Radio FIFO and UART rings are still polled,
+ * so this is how long a frame or NMEA input may wait for the main loop.
+ */
+#define TICKLESS_MAX_SLEEP        10    /* ms */
+#define TICKLESS_REPORT_INTERVAL  10000 /* ms */
+#define PSRFP_VERSION             1
+
+/*
+ * MCU core current, awake and asleep, uA. Typical datasheet figures,
+ * the boards have no current sense. Can be overridden by platform-specific code.
+ */
+#if !defined(TICKLESS_RUN_UA)
+#define TICKLESS_RUN_UA           5000
+#endif
+#if !defined(TICKLESS_SLEEP_UA)
+#define TICKLESS_SLEEP_UA         1000
+#endif
+
+typedef struct tickless_stats_struct {
+  uint32_t events;    /* sleeps cut short by radio or PPS interrupt */
+  uint32_t timeouts;  /* sleeps that lasted till the deadline */
+  uint32_t sleep_ms;
+  uint32_t run_ms;
+} tickless_stats_t;
+
+void     Tickless_setup(void);
+void     Tickless_loop(void);
+void     Tickless_Due(uint32_t);
+void     Tickless_Event(void);
+uint32_t Tickless_Current(void);
+
+extern tickless_stats_t Tickless_stats;
+
+#endif /* USE_TICKLESS */
+
+#endif /* TICKLESSHELPER_H */
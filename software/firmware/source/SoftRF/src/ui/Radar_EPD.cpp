@@ -48,6 +48,53 @@ enum {
 static int view_state_curr = STATE_RVIEW_NONE;
 static int view_state_prev = STATE_RVIEW_NONE;
 
+#define EPD_RADAR_MAX_GLYPHS    (MAX_TRACKING_OBJECTS + 8)
+#define EPD_RADAR_TARGET_SIZE   15     /* pixels, largest target symbol */
+
+/* retained scene of two most recent frames */
+static epd_glyph_t EPD_scene[2][EPD_RADAR_MAX_GLYPHS];
+static int  EPD_scene_count[2] = { 0, 0 };
+static int  EPD_scene_curr     = 0;
+static bool EPD_scene_valid    = false;
+
+static void EPD_Scene_Add(uint8_t type, int32_t key,
+                          int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int count = EPD_scene_count[EPD_scene_curr];
+
+  if (count < EPD_RADAR_MAX_GLYPHS) {
+    epd_glyph_t *glyph = &EPD_scene[EPD_scene_curr][count];
+
+    glyph->type = type;
+    glyph->key  = key;
+    glyph->x    = x;
+    glyph->y    = y;
+    glyph->w    = w;
+    glyph->h    = h;
+
+    EPD_scene_count[EPD_scene_curr] = count + 1;
+  } else {
+    /* untracked glyph - next frame has to be a full one */
+    EPD_Damage(x, y, w, h);
+    EPD_scene_valid = false;
+  }
+}
+
+static void EPD_Scene_Add_Text(const char *text, int16_t x, int16_t y)
+{
+  int16_t  tbx, tby;
+  uint16_t tbw, tbh;
+  int32_t  key = 0;
+
+  display->getTextBounds(text, x, y, &tbx, &tby, &tbw, &tbh);
+
+  for (const char *c = text; *c; c++) {
+    key = key * 31 + *c;
+  }
+
+  EPD_Scene_Add(EPD_GLYPH_LABEL, key, tbx - 1, tby - 1, tbw + 2, tbh + 2);
+}
+
 static void EPD_Draw_Radar()
 {
   int16_t  tbx, tby;
@@ -61,6 +108,17 @@ static void EPD_Draw_Radar()
     /* divider is a half of full scale */
     int32_t divider = 2000;
 
+    int  scene_prev = EPD_scene_curr;
+    bool partial    = EPD_scene_valid;
+
+    EPD_scene_curr ^= 1;
+    EPD_scene_count[EPD_scene_curr] = 0;
+    EPD_scene_valid = true;
+
+    if (partial) {
+      EPD_Damage_Begin();
+    }
+
     display->setFont(&FreeMono9pt7b);
     display->getTextBounds("N", 0, 0, &tbx, &tby, &tbw, &tbh);
 
@@ -146,6 +204,14 @@ static void EPD_Draw_Radar()
 
           float RelativeVertical = Container[i].altitude - ThisAircraft.altitude;
 
+          int32_t shape = (RelativeVertical >   EPD_RADAR_V_THRESHOLD ? 1 :
+                           RelativeVertical < - EPD_RADAR_V_THRESHOLD ? 2 : 0);
+
+          EPD_Scene_Add(EPD_GLYPH_TARGET, isTeam ? shape + 3 : shape,
+                        radar_center_x + x - EPD_RADAR_TARGET_SIZE / 2,
+                        radar_center_y - y - EPD_RADAR_TARGET_SIZE / 2,
+                        EPD_RADAR_TARGET_SIZE, EPD_RADAR_TARGET_SIZE);
+
           if        (RelativeVertical >   EPD_RADAR_V_THRESHOLD) {
             if (isTeam) {
               display->drawTriangle(radar_center_x + x - 5, radar_center_y - y + 4,
@@ -229,32 +295,39 @@ static void EPD_Draw_Radar()
         y = radar_y + (radar_w + tbh) / 2;
         display->setCursor(x , y);
         display->print("W");
+        EPD_Scene_Add_Text("W", x, y);
         x = radar_x + radar_w / 2 + radius - (3 * tbw)/2;
         y = radar_y + (radar_w + tbh) / 2;
         display->setCursor(x , y);
         display->print("E");
+        EPD_Scene_Add_Text("E", x, y);
         x = radar_x + (radar_w - tbw) / 2;
         y = radar_y + radar_w/2 - radius + (3 * tbh)/2;
         display->setCursor(x , y);
         display->print("N");
+        EPD_Scene_Add_Text("N", x, y);
         x = radar_x + (radar_w - tbw) / 2;
         y = radar_y + radar_w/2 + radius - tbh/2;
         display->setCursor(x , y);
         display->print("S");
+        EPD_Scene_Add_Text("S", x, y);
         break;
       case DIRECTION_TRACK_UP:
         x = radar_x + radar_w / 2 - radius + tbw/2;
         y = radar_y + (radar_w + tbh) / 2;
         display->setCursor(x , y);
         display->print("L");
+        EPD_Scene_Add_Text("L", x, y);
         x = radar_x + radar_w / 2 + radius - (3 * tbw)/2;
         y = radar_y + (radar_w + tbh) / 2;
         display->setCursor(x , y);
         display->print("R");
+        EPD_Scene_Add_Text("R", x, y);
         x = radar_x + (radar_w - tbw) / 2;
         y = radar_y + radar_w/2 + radius - tbh/2;
         display->setCursor(x , y);
         display->print("B");
+        EPD_Scene_Add_Text("B", x, y);
 
         display->setFont(&FreeMonoBold9pt7b);
         snprintf(cog_text, sizeof(cog_text), "%03d", (int) ThisAircraft.course);
@@ -267,6 +340,8 @@ static void EPD_Draw_Radar()
         display->drawRoundRect( x - 2, y - tbh - 2,
                                 tbw + 8, tbh + 6,
                                 4, GxEPD_BLACK);
+        EPD_Scene_Add(EPD_GLYPH_LABEL, (int32_t) ThisAircraft.course,
+                      x - 2, y - tbh - 2, tbw + 8, tbh + 6);
         break;
       default:
         /* TBD */
@@ -280,6 +355,9 @@ static void EPD_Draw_Radar()
       y = radar_y + radar_w - tbh;
       display->setCursor(x, y);
 
+      EPD_Scene_Add(EPD_GLYPH_LABEL, (ui->units << 8) | EPD_zoom,
+                    x + tbx - 1, y + tby - 1, tbw + 2, tbh + 2);
+
       if (ui->units == UNITS_METRIC || ui->units == UNITS_MIXED) {
         display->print(EPD_zoom == ZOOM_LOWEST ? "20" :
                        EPD_zoom == ZOOM_LOW    ? "10" :
@@ -297,8 +375,14 @@ static void EPD_Draw_Radar()
       }
     }
 
+    if (partial) {
+      EPD_Damage_Scene(EPD_scene[scene_prev], EPD_scene_count[scene_prev],
+                       EPD_scene[EPD_scene_curr],
+                       EPD_scene_count[EPD_scene_curr]);
+    }
+
     /* a signal to background EPD update task */
-    EPD_ready_to_display = true;
+    EPD_Post();
   }
 }
 
@@ -320,6 +404,7 @@ void EPD_radar_loop()
   if (EPD_vmode_updated) {
     EPD_Clear_Screen();
     view_state_prev = STATE_RVIEW_NONE;
+    EPD_scene_valid = false;
     EPD_vmode_updated = false;
   }
 
@@ -327,6 +412,7 @@ void EPD_radar_loop()
       view_state_curr == STATE_RVIEW_NOFIX) {
 
     EPD_Message(NO_FIX_TEXT, NULL);
+    EPD_scene_valid = false;
     view_state_prev = view_state_curr;
   }
 
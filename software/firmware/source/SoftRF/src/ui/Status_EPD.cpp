@@ -226,7 +226,7 @@ static void EPD_Draw_NavBoxes()
     }
 
     /* a signal to background EPD update task */
-    EPD_ready_to_display = true;
+    EPD_Post();
   }
 }
 
@@ -328,7 +328,7 @@ static void EPD_Update_NavBoxes()
     }
 
     /* a signal to background EPD update task */
-    if (updated) EPD_ready_to_display = true;
+    if (updated) EPD_Post();
   }
 }
 
@@ -48,19 +48,12 @@ static int view_state_prev = STATE_TVIEW_NONE;
 
 static void EPD_Draw_Text()
 {
-  int j=0;
+  int j;
   int bearing;
   char info_line [TEXT_VIEW_LINE_LENGTH];
   char id_text   [TEXT_VIEW_LINE_LENGTH];
 
-  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (Container[i].addr && (now() - Container[i].timestamp) <= EPD_EXPIRATION_TIME) {
-
-      traffic_by_dist[j].fop = &Container[i];
-      traffic_by_dist[j].distance = Container[i].distance;
-      j++;
-    }
-  }
+  j = Traffic_Ranked(traffic_by_dist, MAX_TRACKING_OBJECTS, EPD_EXPIRATION_TIME);
 
   if (j > 0 && !EPD_ready_to_display) {
 
@@ -69,8 +62,6 @@ static void EPD_Draw_Text()
     float disp_dist;
     int   disp_alt, disp_spd;
 
-    qsort(traffic_by_dist, j, sizeof(traffic_by_dist_t), traffic_cmp_by_distance);
-
     if (EPD_current > j) {
       EPD_current = j;
     }
@@ -215,7 +206,7 @@ static void EPD_Draw_Text()
     }
 
     /* a signal to background EPD update task */
-    EPD_ready_to_display = true;
+    EPD_Post();
   }
 }
 
@@ -89,7 +89,7 @@ void EPD_time_loop()
     display->print(TZ_text);
 
     /* a signal to background EPD update task */
-    EPD_ready_to_display = true;
+    EPD_Post();
   }
 }
 
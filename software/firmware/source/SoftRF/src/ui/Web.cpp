@@ -42,13 +42,61 @@ void Web_fini()     {}
 #include "../driver/AHRS.h"
 #endif /* ENABLE_AHRS */
 
-static uint32_t prev_rx_pkt_cnt = 0;
+#if defined(USE_RELAY)
+#include "../system/Relay.h"
+#endif /* USE_RELAY */
+
+#if defined(USE_PROFILER)
+#include "../system/Profile.h"
+#endif /* USE_PROFILER */
 
 static const char Logo[] PROGMEM = {
 #include "../Logo.h"
     } ;
 
 #include "jquery_min_js.h"
+#include "status_html.h"
+
+/*
+ * Dynamic pages are rendered part by part into this buffer and sent
+ * with chunked transfer encoding, instead of a large allocation on the heap.
+ */
+static char Web_buffer[WEB_BUFFER_SIZE];
+
+static void Web_no_cache()
+{
+  server.sendHeader(String(F("Cache-Control")), String(F("no-cache, no-store, must-revalidate")));
+  server.sendHeader(String(F("Pragma")), String(F("no-cache")));
+  server.sendHeader(String(F("Expires")), String(F("-1")));
+}
+
+/* sends what is in Web_buffer as a whole response */
+static void Web_send_buffer(const char *type)
+{
+  size_t len = strlen(Web_buffer);
+
+  Web_no_cache();
+  server.setContentLength(len);
+  server.send(200, type, "");
+  server.sendContent_P(Web_buffer, len);
+}
+
+/* sends a gzip compressed file out of flash memory */
+static void Web_send_gz(const char *type, PGM_P content, size_t bytes_left)
+{
+  size_t chunk_size;
+
+  server.setContentLength(bytes_left);
+  server.sendHeader(String(F("Content-Encoding")),String(F("gzip")));
+  server.send(200, type, "");
+
+  do {
+    chunk_size = bytes_left > JS_MAX_CHUNK_SIZE ? JS_MAX_CHUNK_SIZE : bytes_left;
+    server.sendContent_P(content, chunk_size);
+    content += chunk_size;
+    bytes_left -= chunk_size;
+  } while (bytes_left > 0) ;
+}
 
 byte getVal(char c)
 {
@@ -127,16 +175,13 @@ Copyright (C) 2015-2021 &nbsp;&nbsp;&nbsp; Linar Yusupov\
 
 void handleSettings() {
 
-  size_t size = 5020;
-  char *offset;
-  size_t len = 0;
-  char *Settings_temp = (char *) malloc(size);
-
-  if (Settings_temp == NULL) {
-    return;
-  }
+  size_t size = sizeof(Web_buffer);
+  char *offset = Web_buffer;
 
-  offset = Settings_temp;
+  SoC->swSer_enableRx(false);
+  Web_no_cache();
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/html", "");
 
   /* Common part 1 */
   snprintf_P ( offset, size,
@@ -156,20 +201,24 @@ void handleSettings() {
 <option %s value='%d'>Normal</option>\
 <!-- <option %s value='%d'>Tx/Rx Test</option> -->\
 <option %s value='%d'>Bridge</option>\
-<option %s value='%d'>UAV</option>\
-</select>\
+<option %s value='%d'>UAV</option>"
+#if defined(USE_RELAY)
+"<option %s value='%d'>Relay</option>"
+#endif /* USE_RELAY */
+"</select>\
 </td>\
 </tr>"),
   (settings->mode == SOFTRF_MODE_NORMAL ? "selected" : "") , SOFTRF_MODE_NORMAL,
   (settings->mode == SOFTRF_MODE_TXRX_TEST ? "selected" : ""), SOFTRF_MODE_TXRX_TEST,
   (settings->mode == SOFTRF_MODE_BRIDGE ? "selected" : ""), SOFTRF_MODE_BRIDGE,
   (settings->mode == SOFTRF_MODE_UAV ? "selected" : ""), SOFTRF_MODE_UAV
+#if defined(USE_RELAY)
+  , (settings->mode == SOFTRF_MODE_RELAY ? "selected" : ""), SOFTRF_MODE_RELAY
+#endif /* USE_RELAY */
 /*  (settings->mode == SOFTRF_MODE_WATCHOUT ? "selected" : ""), SOFTRF_MODE_WATCHOUT, */
   );
 
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* Radio specific part 1 */
   if (hw_info.rf == RF_IC_SX1276 || hw_info.rf == RF_IC_SX1262) {
@@ -195,6 +244,33 @@ void handleSettings() {
     (settings->rf_protocol == RF_PROTOCOL_FANET ? "selected" : ""),
      RF_PROTOCOL_FANET, fanet_proto_desc.name
     );
+
+    server.sendContent_P(offset, strlen(offset));
+
+    snprintf_P ( offset, size,
+      PSTR("\
+<tr>\
+<th align=left>Also receive</th>\
+<td align=right>\
+<select name='rxp'>\
+<option %s value='%d'>None</option>\
+<option %s value='%d'>%s</option>\
+<option %s value='%d'>%s</option>\
+<option %s value='%d'>%s</option>\
+<option %s value='%d'>All</option>\
+</select>\
+</td>\
+</tr>"),
+    (settings->rx_protocols == 0 ? "selected" : ""), 0,
+    (settings->rx_protocols == RF_RX_PROTOCOLS_LEGACY ? "selected" : ""),
+     RF_RX_PROTOCOLS_LEGACY, legacy_proto_desc.name,
+    (settings->rx_protocols == RF_RX_PROTOCOLS_OGNTP ? "selected" : ""),
+     RF_RX_PROTOCOLS_OGNTP, ogntp_proto_desc.name,
+    (settings->rx_protocols == RF_RX_PROTOCOLS_FANET ? "selected" : ""),
+     RF_RX_PROTOCOLS_FANET, fanet_proto_desc.name,
+    (settings->rx_protocols == RF_RX_PROTOCOLS_ALL ? "selected" : ""),
+     RF_RX_PROTOCOLS_ALL
+    );
   } else {
     snprintf_P ( offset, size,
       PSTR("\
@@ -209,9 +285,7 @@ void handleSettings() {
      "UNK")))
     );
   }
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* Common part 2 */
   snprintf_P ( offset, size,
@@ -324,9 +398,7 @@ void handleSettings() {
   (settings->pointer == LED_OFF ? "selected" : ""), LED_OFF
   );
 
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* SoC specific part 1 */
   if (SoC->id == SOC_ESP32) {
@@ -347,9 +419,7 @@ void handleSettings() {
     (settings->bluetooth == BLUETOOTH_LE_HM10_SERIAL ? "selected" : ""), BLUETOOTH_LE_HM10_SERIAL
     );
 
-    len = strlen(offset);
-    offset += len;
-    size -= len;
+    server.sendContent_P(offset, strlen(offset));
   }
 
   /* Common part 3 */
@@ -401,9 +471,7 @@ void handleSettings() {
   (settings->nmea_out == NMEA_UART ? "selected" : ""), NMEA_UART,
   (settings->nmea_out == NMEA_UDP ? "selected" : ""), NMEA_UDP);
 
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* SoC specific part 2 */
   if (SoC->id == SOC_ESP32) {
@@ -414,9 +482,7 @@ void handleSettings() {
     (settings->nmea_out == NMEA_TCP ? "selected" : ""), NMEA_TCP,
     (settings->nmea_out == NMEA_BLUETOOTH ? "selected" : ""), NMEA_BLUETOOTH);
 
-    len = strlen(offset);
-    offset += len;
-    size -= len;
+    server.sendContent_P(offset, strlen(offset));
   }
 
   /* Common part 4 */
@@ -436,9 +502,7 @@ void handleSettings() {
   (settings->gdl90 == GDL90_UART ? "selected" : ""), GDL90_UART,
   (settings->gdl90 == GDL90_UDP ? "selected" : ""), GDL90_UDP);
 
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* SoC specific part 3 */
   if (SoC->id == SOC_ESP32) {
@@ -447,9 +511,7 @@ void handleSettings() {
 <option %s value='%d'>Bluetooth</option>"),
     (settings->gdl90 == GDL90_BLUETOOTH ? "selected" : ""), GDL90_BLUETOOTH);
 
-    len = strlen(offset);
-    offset += len;
-    size -= len;
+    server.sendContent_P(offset, strlen(offset));
   }
 
   /* Common part 5 */
@@ -467,9 +529,7 @@ void handleSettings() {
   (settings->d1090 == D1090_OFF ? "selected" : ""), D1090_OFF,
   (settings->d1090 == D1090_UART ? "selected" : ""), D1090_UART);
 
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* SoC specific part 4 */
   if (SoC->id == SOC_ESP32) {
@@ -478,9 +538,7 @@ void handleSettings() {
 <option %s value='%d'>Bluetooth</option>"),
     (settings->d1090 == D1090_BLUETOOTH ? "selected" : ""), D1090_BLUETOOTH);
 
-    len = strlen(offset);
-    offset += len;
-    size -= len;
+    server.sendContent_P(offset, strlen(offset));
   }
 
   /* Common part 6 */
@@ -520,9 +578,7 @@ void handleSettings() {
   (!settings->no_track ? "checked" : "") , (settings->no_track ? "checked" : "")
   );
 
-  len = strlen(offset);
-  offset += len;
-  size -= len;
+  server.sendContent_P(offset, strlen(offset));
 
   /* Radio specific part 2 */
   if (rf_chip && rf_chip->type == RF_IC_SX1276) {
@@ -536,9 +592,7 @@ void handleSettings() {
 </tr>"),
     settings->freq_corr);
 
-    len = strlen(offset);
-    offset += len;
-    size -= len;
+    server.sendContent_P(offset, strlen(offset));
   }
 
   /* Common part 7 */
@@ -551,96 +605,60 @@ void handleSettings() {
 </html>")
   );
 
-  SoC->swSer_enableRx(false);
-  server.sendHeader(String(F("Cache-Control")), String(F("no-cache, no-store, must-revalidate")));
-  server.sendHeader(String(F("Pragma")), String(F("no-cache")));
-  server.sendHeader(String(F("Expires")), String(F("-1")));
-  server.send ( 200, "text/html", Settings_temp );
+  server.sendContent_P(offset, strlen(offset));
+  server.sendContent("");
   SoC->swSer_enableRx(true);
-  free(Settings_temp);
 }
 
 void handleRoot() {
-  int sec = millis() / 1000;
-  int min = sec / 60;
-  int hr = min / 60;
+  SoC->swSer_enableRx(false);
+  Web_no_cache();
+  Web_send_gz("text/html", status_html_gz, status_html_gz_len);
+  SoC->swSer_enableRx(true);
+}
 
+/* live data of the status page, it is polled by the page itself */
+void handleStatus() {
   float vdd = Battery_voltage() ;
   bool low_voltage = (Battery_voltage() <= Battery_threshold());
 
-  time_t timestamp = ThisAircraft.timestamp;
+  time_t this_moment = now();
   unsigned int sats = gnss.satellites.value(); // Number of satellites in use (u32)
+  int traffic = 0;
   char str_lat[16];
   char str_lon[16];
   char str_alt[16];
   char str_Vcc[8];
 
-  char *Root_temp = (char *) malloc(2300);
-  if (Root_temp == NULL) {
-    return;
+  size_t size = sizeof(Web_buffer);
+  char *offset = Web_buffer;
+  size_t len = 0;
+
+  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    if (Container[i].addr &&
+        (this_moment - Container[i].timestamp) <= ENTRY_EXPIRATION_TIME) {
+      traffic++;
+    }
   }
 
-  dtostrf(ThisAircraft.latitude, 8, 4, str_lat);
-  dtostrf(ThisAircraft.longitude, 8, 4, str_lon);
-  dtostrf(ThisAircraft.altitude, 7, 1, str_alt);
-  dtostrf(vdd, 4, 2, str_Vcc);
+  dtostrf(ThisAircraft.latitude, 1, 4, str_lat);
+  dtostrf(ThisAircraft.longitude, 1, 4, str_lon);
+  dtostrf(ThisAircraft.altitude, 1, 1, str_alt);
+  dtostrf(vdd, 1, 2, str_Vcc);
 
-  snprintf_P ( Root_temp, 2300,
-    PSTR("<html>\
-  <head>\
-    <meta name='viewport' content='width=device-width, initial-scale=1'>\
-    <title>SoftRF status</title>\
-  </head>\
-<body>\
- <table width=100%%>\
-  <tr><!-- <td align=left><h1>&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;</h1></td> -->\
-  <td align=center><h1>SoftRF status</h1></td>\
-  <!-- <td align=right><img src='/logo.png'></td> --></tr>\
- </table>\
- <table width=100%%>\
-  <tr><th align=left>Device Id</th><td align=right>%06X</td></tr>\
-  <tr><th align=left>Software Version</th><td align=right>%s&nbsp;&nbsp;%s</td></tr>"
-#if !defined(ENABLE_AHRS)
- "</table><table width=100%%>\
-  <tr><td align=left><table><tr><th align=left>GNSS&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td>\
-  <td align=center><table><tr><th align=left>Radio&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td>\
-  <td align=right><table><tr><th align=left>Baro&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td></tr>\
-  </table><table width=100%%>"
-#else
- "<tr><td align=left><table><tr><th align=left>GNSS&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td>\
-  <td align=right><table><tr><th align=left>Radio&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td></tr>\
-  <tr><td align=left><table><tr><th align=left>Baro&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td>\
-  <td align=right><table><tr><th align=left>AHRS&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td></tr>"
+  snprintf_P ( offset, size,
+    PSTR("{\"id\":\"%06X\",\"version\":\"%s\",\"soc\":\"%s\",\
+\"gnss\":\"%s\",\"radio\":\"%s\",\"baro\":\"%s\","
+#if defined(ENABLE_AHRS)
+    "\"ahrs\":\"%s\","
 #endif /* ENABLE_AHRS */
- "<tr><th align=left>Uptime</th><td align=right>%02d:%02d:%02d</td></tr>\
-  <tr><th align=left>Free memory</th><td align=right>%u</td></tr>\
-  <tr><th align=left>Battery voltage</th><td align=right><font color=%s>%s</font></td></tr>\
- </table>\
- <table width=100%%>\
-   <tr><th align=left>Packets</th>\
-    <td align=right><table><tr>\
-     <th align=left>Tx&nbsp;&nbsp;</th><td align=right>%u</td>\
-     <th align=left>&nbsp;&nbsp;&nbsp;&nbsp;Rx&nbsp;&nbsp;</th><td align=right>%u</td>\
-   </tr></table></td></tr>\
- </table>\
- <h2 align=center>Most recent GNSS fix</h2>\
- <table width=100%%>\
-  <tr><th align=left>Time</th><td align=right>%u</td></tr>\
-  <tr><th align=left>Satellites</th><td align=right>%d</td></tr>\
-  <tr><th align=left>Latitude</th><td align=right>%s</td></tr>\
-  <tr><th align=left>Longitude</th><td align=right>%s</td></tr>\
-  <tr><td align=left><b>Altitude</b>&nbsp;&nbsp;(above MSL)</td><td align=right>%s</td></tr>\
- </table>\
- <hr>\
- <table width=100%%>\
-  <tr>\
-    <td align=left><input type=button onClick=\"location.href='/settings'\" value='Settings'></td>\
-    <td align=center><input type=button onClick=\"location.href='/about'\" value='About'></td>\
-    <td align=right><input type=button onClick=\"location.href='/firmware'\" value='Firmware update'></td>\
-  </tr>\
- </table>\
-</body>\
-</html>"),
+    "\"uptime\":%lu,\"heap\":%u,\"vbat\":%s,\"vbat_low\":%s,\
+\"tx\":%u,\"rx\":%u,\"lost\":%u,\"rssi\":%d,\"traffic\":%d,"
+#if defined(USE_RELAY)
+    "\"relay\":{\"relayed\":%u,\"candidates\":%u,\"airtime\":%u},"
+#endif /* USE_RELAY */
+    "\"fix\":{\"time\":%lu,\"sats\":%u,\"lat\":%s,\"lon\":%s,\"alt\":%s},\
+\"slices\":["),
     ThisAircraft.addr, SOFTRF_FIRMWARE_VERSION
 #if defined(SOFTRF_ADDRESS)
     "I"
@@ -653,27 +671,89 @@ void handleRoot() {
 #if defined(ENABLE_AHRS)
     (ahrs_chip == NULL ? "NONE" : ahrs_chip->name),
 #endif /* ENABLE_AHRS */
-    hr, min % 60, sec % 60, ESP.getFreeHeap(),
-    low_voltage ? "red" : "green", str_Vcc,
-    tx_packets_counter, rx_packets_counter,
-    timestamp, sats, str_lat, str_lon, str_alt
+    (unsigned long) (millis() / 1000), ESP.getFreeHeap(),
+    str_Vcc, BOOL_STR(low_voltage),
+    tx_packets_counter, rx_packets_counter, RF_rx_stats.overruns,
+    RF_last_rssi, traffic,
+#if defined(USE_RELAY)
+    Relay_stats.relayed, Relay_stats.candidates, Relay_stats.airtime,
+#endif /* USE_RELAY */
+    (unsigned long) ThisAircraft.timestamp, sats, str_lat, str_lon, str_alt
   );
+
+  len = strlen(offset);
+  offset += len;
+  size -= len;
+
+  for (uint8_t i = 0; i < RF_slices_count && RF_slices_count > 1; i++) {
+    snprintf_P(offset, size, PSTR("%s{\"p\":\"%s\",\"n\":%u}"),
+             i ? "," : "",
+             RF_slices[i].protocol == RF_PROTOCOL_LEGACY ? "L" :
+             RF_slices[i].protocol == RF_PROTOCOL_OGNTP  ? "O" :
+             RF_slices[i].protocol == RF_PROTOCOL_FANET  ? "F" : "?",
+             RF_slices[i].frames);
+
+    len = strlen(offset);
+    offset += len;
+    size -= len;
+  }
+
+  snprintf_P(offset, size, PSTR("]"));
+
+  len = strlen(offset);
+  offset += len;
+  size -= len;
+
+#if defined(USE_PROFILER)
+  bool first = true;
+
+  for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+    profile_stage_t *sp = &Profile_stages[i];
+
+    if (sp->count == 0) {
+      continue;
+    }
+
+    snprintf_P(offset, size, PSTR("%s\"%s\":%lu"),
+               first ? ",\"timings\":{" : ",", Profile_stage_name[i],
+               (unsigned long) (sp->total / sp->count));
+    first = false;
+
+    len = strlen(offset);
+    offset += len;
+    size -= len;
+  }
+
+  if (!first) {
+    snprintf_P(offset, size, PSTR("}"));
+
+    len = strlen(offset);
+    offset += len;
+    size -= len;
+  }
+#endif /* USE_PROFILER */
+
+  snprintf_P(offset, size, PSTR("}"));
+
   SoC->swSer_enableRx(false);
-  server.sendHeader(String(F("Cache-Control")), String(F("no-cache, no-store, must-revalidate")));
-  server.sendHeader(String(F("Pragma")), String(F("no-cache")));
-  server.sendHeader(String(F("Expires")), String(F("-1")));
-  server.send ( 200, "text/html", Root_temp );
+  Web_send_buffer("application/json");
   SoC->swSer_enableRx(true);
-  free(Root_temp);
 }
 
-void handleInput() {
-
-  char *Input_temp = (char *) malloc(1600);
-  if (Input_temp == NULL) {
-    return;
+#if defined(USE_PROFILER)
+void handleProfile() {
+  if (Profile_JSON(Web_buffer, sizeof(Web_buffer)) == 0) {
+    strcpy(Web_buffer, "{}");
   }
 
+  SoC->swSer_enableRx(false);
+  Web_send_buffer("application/json");
+  SoC->swSer_enableRx(true);
+}
+#endif /* USE_PROFILER */
+
+void handleInput() {
+
   for ( uint8_t i = 0; i < server.args(); i++ ) {
     if (server.argName(i).equals("mode")) {
       settings->mode = server.arg(i).toInt();
@@ -715,9 +795,11 @@ void handleInput() {
       settings->power_save = server.arg(i).toInt();
     } else if (server.argName(i).equals("rfc")) {
       settings->freq_corr = server.arg(i).toInt();
+    } else if (server.argName(i).equals("rxp")) {
+      settings->rx_protocols = server.arg(i).toInt();
     }
   }
-  snprintf_P ( Input_temp, 1600,
+  snprintf_P ( Web_buffer, sizeof(Web_buffer),
 PSTR("<html>\
 <head>\
 <meta http-equiv='refresh' content='15; url=/'>\
@@ -747,6 +829,7 @@ PSTR("<html>\
 <tr><th align=left>No track</th><td align=right>%s</td></tr>\
 <tr><th align=left>Power save</th><td align=right>%d</td></tr>\
 <tr><th align=left>Freq. correction</th><td align=right>%d</td></tr>\
+<tr><th align=left>Also receive</th><td align=right>%d</td></tr>\
 </table>\
 <hr>\
   <p align=center><h1 align=center>Restart is in progress... Please, wait!</h1></p>\
@@ -759,13 +842,12 @@ PSTR("<html>\
   BOOL_STR(settings->nmea_l), BOOL_STR(settings->nmea_s),
   settings->nmea_out, settings->gdl90, settings->d1090,
   BOOL_STR(settings->stealth), BOOL_STR(settings->no_track),
-  settings->power_save, settings->freq_corr
+  settings->power_save, settings->freq_corr, settings->rx_protocols
   );
   SoC->swSer_enableRx(false);
-  server.send ( 200, "text/html", Input_temp );
+  Web_send_buffer("text/html");
 //  SoC->swSer_enableRx(true);
   delay(1000);
-  free(Input_temp);
   EEPROM_store();
   RF_Shutdown();
   delay(1000);
@@ -793,6 +875,7 @@ void handleNotFound() {
 void Web_setup()
 {
   server.on ( "/", handleRoot );
+  server.on ( "/status.json", handleStatus );
   server.on ( "/settings", handleSettings );
   server.on ( "/about", []() {
     SoC->swSer_enableRx(false);
@@ -804,6 +887,9 @@ void Web_setup()
   } );
 
   server.on ( "/input", handleInput );
+#if defined(USE_PROFILER)
+  server.on ( "/profile.json", handleProfile );
+#endif /* USE_PROFILER */
   server.on ( "/inline", []() {
     server.send ( 200, "text/plain", "this works as well" );
   } );
@@ -911,22 +997,7 @@ $('form').submit(function(e){\
   } );
 
   server.on ( "/jquery.min.js", []() {
-
-    PGM_P content = jquery_min_js_gz;
-    size_t bytes_left = jquery_min_js_gz_len;
-    size_t chunk_size;
-
-    server.setContentLength(bytes_left);
-    server.sendHeader(String(F("Content-Encoding")),String(F("gzip")));
-    server.send(200, String(F("application/javascript")), "");
-
-    do {
-      chunk_size = bytes_left > JS_MAX_CHUNK_SIZE ? JS_MAX_CHUNK_SIZE : bytes_left;
-      server.sendContent_P(content, chunk_size);
-      content += chunk_size;
-      bytes_left -= chunk_size;
-    } while (bytes_left > 0) ;
-
+    Web_send_gz("application/javascript", jquery_min_js_gz, jquery_min_js_gz_len);
   } );
 
   server.begin();
@@ -32,6 +32,7 @@
 
 #define BOOL_STR(x) (x ? "true":"false")
 #define JS_MAX_CHUNK_SIZE 4096
+#define WEB_BUFFER_SIZE   2304 /* the largest part of the settings page */
 
 void Web_setup(void);
 void Web_loop(void);
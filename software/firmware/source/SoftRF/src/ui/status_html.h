@@ -0,0 +1,128 @@
+/*
+ * gzip -9n status.html
+ * xxd -i status.html.gz > status_html.h
+ */
+
+static const char status_html_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x58,
+  0xeb, 0x6f, 0xdb, 0x36, 0x10, 0xff, 0xee, 0xbf, 0xe2, 0x66, 0xb4, 0x93,
+  0x8c, 0xa4, 0xb2, 0x93, 0x15, 0xfd, 0xd0, 0x58, 0x2e, 0xda, 0xad, 0x69,
+  0x3b, 0x24, 0xdd, 0x60, 0x7b, 0xc3, 0x80, 0x61, 0x28, 0x68, 0x89, 0xb6,
+  0x38, 0xcb, 0xa4, 0x4a, 0x52, 0x7e, 0x60, 0xcd, 0xff, 0xbe, 0x3b, 0x52,
+  0x96, 0x1f, 0xb5, 0xea, 0xb4, 0x1f, 0x54, 0xf2, 0x1e, 0xbf, 0xe3, 0x3d,
+  0x78, 0x47, 0xa7, 0x9f, 0xd9, 0x45, 0x3e, 0x68, 0xf5, 0x33, 0xce, 0x52,
+  0xfc, 0x6f, 0xc1, 0x2d, 0x03, 0xc9, 0x16, 0x3c, 0x0e, 0x96, 0x82, 0xaf,
+  0x0a, 0xa5, 0x6d, 0x00, 0x89, 0x92, 0x96, 0x4b, 0x1b, 0x07, 0x2b, 0x91,
+  0xda, 0x2c, 0x4e, 0xf9, 0x52, 0x24, 0xfc, 0x99, 0xdb, 0x5c, 0x82, 0x90,
+  0xc2, 0x0a, 0x96, 0x3f, 0x33, 0x09, 0xcb, 0x79, 0x7c, 0x15, 0x20, 0x88,
+  0x15, 0x36, 0xe7, 0x83, 0x91, 0x9a, 0xda, 0xe1, 0x2d, 0x18, 0xcb, 0x6c,
+  0x69, 0xfa, 0x5d, 0x4f, 0x6c, 0xf5, 0xbb, 0x95, 0xa5, 0x89, 0x4a, 0x37,
+  0x64, 0xf7, 0x0a, 0x58, 0x2e, 0x66, 0x32, 0x4e, 0xd0, 0x02, 0xd7, 0xc7,
+  0x5a, 0xd9, 0x15, 0xe1, 0xb1, 0x49, 0xce, 0xc1, 0x1b, 0xbf, 0xea, 0xf5,
+  0x9e, 0x0e, 0x5a, 0xd0, 0xb7, 0x7a, 0xd0, 0xb7, 0x59, 0xa5, 0x9b, 0xf3,
+  0xa9, 0x1d, 0xfc, 0xe2, 0x8e, 0x05, 0x1f, 0x52, 0xb4, 0x95, 0x21, 0x33,
+  0xad, 0x98, 0x5a, 0xcc, 0x32, 0x0b, 0x22, 0x8d, 0x45, 0x3a, 0x40, 0x96,
+  0xfb, 0xe8, 0xd3, 0x10, 0x64, 0x7c, 0xc5, 0x34, 0x87, 0x3f, 0xb9, 0x36,
+  0x42, 0xc9, 0x26, 0xa4, 0xa5, 0x67, 0x9f, 0x83, 0x7b, 0xf7, 0x71, 0x34,
+  0x6a, 0x82, 0x98, 0x49, 0x63, 0xce, 0xe9, 0x0f, 0x59, 0x2a, 0x54, 0x13,
+  0x80, 0x26, 0xe6, 0x39, 0x84, 0x37, 0x4c, 0x37, 0x02, 0x4c, 0x90, 0x77,
+  0xac, 0x4f, 0x74, 0x96, 0x69, 0xf3, 0x49, 0xab, 0x15, 0xe6, 0x60, 0x83,
+  0x19, 0x0d, 0x52, 0x61, 0x8a, 0x9c, 0x6d, 0x5e, 0x4a, 0x25, 0x79, 0x70,
+  0x6c, 0xe0, 0xf5, 0xfb, 0x61, 0xa3, 0x8b, 0x04, 0x74, 0xee, 0x80, 0x7f,
+  0x14, 0x56, 0x2c, 0x78, 0x13, 0x42, 0xe9, 0xb8, 0xe7, 0x30, 0x6e, 0x35,
+  0xe7, 0xb0, 0xe0, 0x0b, 0xa5, 0x37, 0x4d, 0x40, 0x58, 0x73, 0xc5, 0xf9,
+  0x58, 0x59, 0x2c, 0xc0, 0x0d, 0x2c, 0x55, 0x6e, 0xd9, 0xac, 0xf1, 0x4c,
+  0xcb, 0x09, 0xb3, 0xfb, 0x50, 0xf8, 0xa5, 0xf2, 0x7c, 0x74, 0x99, 0xfe,
+  0xce, 0x92, 0x39, 0xb7, 0xe6, 0x14, 0x3c, 0x2a, 0x40, 0x7f, 0x32, 0x18,
+  0xaf, 0xfb, 0xdd, 0xc9, 0xe0, 0x47, 0x39, 0x31, 0xc5, 0x8d, 0xff, 0xf6,
+  0x4d, 0xc1, 0x24, 0x19, 0xb7, 0x6b, 0xb4, 0x4a, 0x9b, 0x03, 0xf6, 0x81,
+  0xe8, 0x64, 0x30, 0x6c, 0xd6, 0xd7, 0x8f, 0xd1, 0xbf, 0x53, 0xc6, 0x36,
+  0x22, 0xe4, 0xc8, 0xdc, 0x62, 0xa0, 0x7f, 0xdf, 0x0e, 0xe9, 0x1d, 0x33,
+  0x16, 0x86, 0xa3, 0xd1, 0x07, 0x08, 0xd3, 0x37, 0x8b, 0x4e, 0x63, 0x29,
+  0x1b, 0x23, 0xce, 0xde, 0x85, 0x35, 0x4c, 0x36, 0x50, 0x68, 0x65, 0x55,
+  0xa2, 0xf2, 0x26, 0x24, 0x93, 0x63, 0x0b, 0x38, 0x5b, 0x74, 0x63, 0xcd,
+  0xa6, 0x53, 0x91, 0x34, 0x81, 0x58, 0xcf, 0x3e, 0x75, 0x37, 0x34, 0xc7,
+  0x9b, 0xf0, 0xe8, 0xcb, 0x31, 0x24, 0x69, 0xde, 0xd8, 0x8f, 0x1c, 0xd8,
+  0xe9, 0x52, 0xca, 0xae, 0x0f, 0xbb, 0xe2, 0x3d, 0x46, 0x1d, 0x34, 0xa7,
+  0x1d, 0x50, 0x57, 0x81, 0xa9, 0xc0, 0x24, 0x67, 0xd7, 0x8f, 0xae, 0xba,
+  0xf1, 0x37, 0x6e, 0xd9, 0x63, 0xee, 0xd8, 0x88, 0x59, 0x9e, 0xe7, 0xc2,
+  0x72, 0xd3, 0x18, 0x7a, 0x66, 0xcf, 0x06, 0xfe, 0x8e, 0xe1, 0x14, 0x28,
+  0xd3, 0xc6, 0x93, 0xe4, 0x87, 0x57, 0xeb, 0x24, 0x84, 0x92, 0xb3, 0x6f,
+  0x63, 0x9c, 0xec, 0xcb, 0xe9, 0x3e, 0x06, 0xd6, 0xf8, 0xeb, 0x7c, 0x7b,
+  0x92, 0xc3, 0x3a, 0x0f, 0xd9, 0x44, 0x2d, 0x39, 0xdc, 0x8f, 0xee, 0x3a,
+  0x1e, 0xe4, 0x44, 0x5b, 0xcb, 0x1b, 0xee, 0x7f, 0x2a, 0x96, 0x55, 0x38,
+  0x85, 0x9c, 0x99, 0x4f, 0xb4, 0x3d, 0x59, 0x25, 0x5f, 0xa7, 0x77, 0xec,
+  0x55, 0x20, 0x2c, 0xcd, 0x25, 0x30, 0x9c, 0x2e, 0xd8, 0x7f, 0x3a, 0x0d,
+  0xf9, 0xdd, 0x33, 0x31, 0xd8, 0xd9, 0xee, 0xa2, 0x35, 0x02, 0xd6, 0xcd,
+  0x15, 0x41, 0xcd, 0xe5, 0x28, 0x0e, 0x42, 0x16, 0xa5, 0x05, 0xbb, 0x29,
+  0x78, 0x3c, 0x29, 0xad, 0x55, 0x12, 0x94, 0xfc, 0x19, 0xaf, 0xd0, 0x3c,
+  0x6e, 0xe7, 0x2a, 0xc1, 0x64, 0x29, 0x19, 0x65, 0x9a, 0x4f, 0xe3, 0xa0,
+  0x6b, 0xb8, 0xb5, 0x64, 0x33, 0x68, 0xc3, 0x92, 0xe5, 0x25, 0x3a, 0x35,
+  0xda, 0x52, 0x7c, 0x34, 0x0e, 0xe0, 0x2b, 0xbf, 0xbe, 0xc7, 0x00, 0x06,
+  0xbe, 0xb4, 0x3b, 0xf4, 0xd7, 0x6e, 0x7b, 0x02, 0xda, 0x77, 0xca, 0xef,
+  0x41, 0x9e, 0x0a, 0xbd, 0xa0, 0xa9, 0xbe, 0x03, 0xbf, 0xad, 0x28, 0x50,
+  0x16, 0x29, 0x16, 0x76, 0x6d, 0xe6, 0x38, 0xa3, 0x26, 0xd1, 0xa2, 0xc0,
+  0xb6, 0x3c, 0x2d, 0x65, 0x42, 0x88, 0xf0, 0x24, 0x14, 0x1d, 0xf8, 0x0f,
+  0x6f, 0xa2, 0x2d, 0xb5, 0x84, 0x54, 0x25, 0xe5, 0x02, 0x3d, 0x8d, 0x66,
+  0xdc, 0xbe, 0xcd, 0x39, 0x2d, 0xdf, 0x6c, 0x3e, 0xa4, 0x28, 0x73, 0x03,
+  0x0f, 0x3b, 0x25, 0x0c, 0x5d, 0x28, 0x2e, 0x61, 0x49, 0x9a, 0x04, 0x10,
+  0x09, 0x29, 0xb9, 0x7e, 0x3f, 0xbe, 0xbf, 0x83, 0x18, 0x96, 0x07, 0xa2,
+  0x76, 0xa5, 0x42, 0xb9, 0x67, 0x21, 0x94, 0xd0, 0x87, 0xab, 0x1e, 0xbc,
+  0x82, 0xa0, 0x17, 0xc0, 0x4b, 0x08, 0x82, 0x0e, 0x5c, 0x80, 0x3c, 0x84,
+  0xcf, 0xd4, 0x2a, 0x34, 0xa8, 0xd4, 0x42, 0xf7, 0x34, 0xcc, 0x2f, 0x21,
+  0xbb, 0x69, 0x39, 0xa3, 0x81, 0x48, 0x83, 0x4b, 0x30, 0x91, 0x48, 0xf1,
+  0x40, 0x8e, 0x50, 0x3d, 0x5c, 0x1c, 0xb5, 0x5a, 0x23, 0x5e, 0xb0, 0x7f,
+  0x03, 0x02, 0x24, 0x98, 0xc8, 0xa8, 0xa4, 0xb3, 0x45, 0xa1, 0xa7, 0x8a,
+  0xd3, 0xa0, 0xc5, 0x16, 0xc9, 0x3d, 0x3f, 0x1c, 0xd5, 0xad, 0xb6, 0x64,
+  0x7a, 0x54, 0x38, 0x2a, 0x2d, 0x08, 0x41, 0x4c, 0x21, 0x34, 0x11, 0x3d,
+  0x05, 0xe0, 0x87, 0x38, 0x86, 0x52, 0xa6, 0x7c, 0x2a, 0x24, 0x4f, 0xc9,
+  0x49, 0xa7, 0x41, 0x2c, 0xa7, 0x41, 0x0b, 0x84, 0x79, 0xe2, 0x49, 0xd4,
+  0x64, 0x83, 0x4e, 0xe4, 0x2e, 0x50, 0x54, 0xdd, 0x1f, 0x0c, 0x57, 0x10,
+  0x90, 0xef, 0x5e, 0xd3, 0xbf, 0x0e, 0x50, 0x97, 0xa2, 0x76, 0xcf, 0x6c,
+  0x16, 0x4d, 0x73, 0xa5, 0x34, 0x9a, 0xf3, 0x1c, 0xe8, 0xc2, 0x4f, 0x2f,
+  0x7a, 0xbd, 0x0e, 0x85, 0x2c, 0x78, 0x89, 0x7e, 0x61, 0x1d, 0xe1, 0xbf,
+  0x66, 0xe9, 0x17, 0xbd, 0x0e, 0x3c, 0x75, 0xdf, 0x4a, 0xc1, 0xc9, 0xd6,
+  0x02, 0x8e, 0x55, 0x47, 0x85, 0x9e, 0x14, 0xee, 0xdc, 0xb4, 0xa8, 0xa9,
+  0xf4, 0x3a, 0x40, 0x6a, 0xbb, 0x3f, 0xc5, 0x37, 0x33, 0x3e, 0x9c, 0x73,
+  0xa5, 0xe3, 0x36, 0x02, 0x21, 0x0a, 0xb1, 0x3e, 0xe5, 0x38, 0x3a, 0x30,
+  0x99, 0x9a, 0xa7, 0x2e, 0x9d, 0x33, 0x7c, 0xba, 0x48, 0x97, 0xd3, 0xf6,
+  0xa0, 0xed, 0x02, 0x4f, 0x52, 0x91, 0x55, 0xb7, 0x62, 0xcd, 0xd3, 0xf0,
+  0xda, 0x71, 0xfa, 0x5d, 0x02, 0x1b, 0xb4, 0x6b, 0x23, 0x76, 0xed, 0x0c,
+  0xdb, 0x75, 0x9d, 0x0c, 0x4f, 0xd0, 0x35, 0x81, 0xa6, 0xb4, 0x23, 0xd1,
+  0xa2, 0x96, 0xc2, 0x31, 0xeb, 0xe5, 0x70, 0x41, 0x60, 0x99, 0x0f, 0x68,
+  0x0b, 0xa6, 0x4a, 0x43, 0x38, 0xc7, 0x5d, 0xef, 0x06, 0xe6, 0x58, 0x71,
+  0x98, 0x7f, 0x37, 0x48, 0xa3, 0x9c, 0xcb, 0x99, 0xcd, 0x90, 0x78, 0x71,
+  0xe1, 0x0a, 0x0c, 0x55, 0x2e, 0x62, 0x12, 0x7d, 0x75, 0x5c, 0x34, 0xdb,
+  0xda, 0xdc, 0xaa, 0xfe, 0x3d, 0xff, 0x27, 0x2a, 0x76, 0xb5, 0x15, 0x1c,
+  0xb1, 0x24, 0x5a, 0xdd, 0xe6, 0xd1, 0x53, 0xf1, 0x64, 0x19, 0x7c, 0xf9,
+  0x02, 0xc1, 0xb3, 0x60, 0xe7, 0xa8, 0x9f, 0xc4, 0xde, 0x5b, 0xbf, 0xde,
+  0xd5, 0x94, 0x1b, 0x9f, 0x5f, 0x15, 0x15, 0x9e, 0xd1, 0x3b, 0x4b, 0x5c,
+  0xef, 0x2d, 0xad, 0xfc, 0x97, 0xa7, 0xbb, 0x13, 0xa9, 0xe9, 0xfe, 0xc9,
+  0xbc, 0x50, 0xc2, 0x64, 0x2a, 0xa8, 0x23, 0x98, 0x6d, 0xb1, 0x1c, 0xba,
+  0x19, 0xee, 0x0b, 0x33, 0xa1, 0x5d, 0x59, 0xd4, 0x88, 0x0b, 0xd3, 0x71,
+  0x47, 0xa7, 0x12, 0xae, 0x1f, 0x0a, 0xa7, 0x6b, 0x78, 0xe7, 0x7c, 0x55,
+  0xc2, 0x26, 0xc2, 0x89, 0x1e, 0xd1, 0x66, 0x9b, 0x2d, 0x9a, 0xa7, 0x35,
+  0x83, 0x36, 0x75, 0x54, 0x72, 0x66, 0x6b, 0x46, 0xbe, 0x57, 0x2d, 0xcf,
+  0x3b, 0xbb, 0xf4, 0xcb, 0x9d, 0x04, 0x36, 0xc2, 0x7d, 0x89, 0x0a, 0x04,
+  0xa7, 0x58, 0x2d, 0x82, 0xeb, 0x5a, 0xe4, 0xaa, 0xb3, 0x8b, 0x70, 0x35,
+  0x66, 0x4e, 0xc5, 0xb8, 0x2e, 0x9d, 0x6d, 0xed, 0x08, 0x09, 0xb5, 0x82,
+  0x17, 0xf1, 0xb5, 0x12, 0x9c, 0x98, 0xe1, 0x14, 0xc5, 0x39, 0xc5, 0xed,
+  0xe4, 0x23, 0xd8, 0xc7, 0xb8, 0x82, 0xc2, 0x5a, 0xa9, 0x04, 0xab, 0x79,
+  0xeb, 0x6c, 0x3e, 0xf8, 0x20, 0x57, 0x32, 0xc1, 0x61, 0x47, 0xcd, 0x6e,
+  0x0e, 0xb8, 0x34, 0x87, 0x9b, 0x93, 0xb0, 0xd7, 0x47, 0x0b, 0x95, 0xe7,
+  0x61, 0xdd, 0x46, 0x35, 0xca, 0x48, 0xbe, 0x82, 0xbf, 0xee, 0xef, 0xde,
+  0x5b, 0x5b, 0x0c, 0xf9, 0xe7, 0x92, 0x1b, 0x1b, 0x52, 0x70, 0x74, 0xa4,
+  0xa4, 0xc6, 0x1f, 0xb1, 0x1b, 0xfa, 0x91, 0xca, 0x93, 0x8c, 0xc9, 0x19,
+  0x47, 0xe9, 0x2d, 0x90, 0xc7, 0x70, 0x21, 0xd4, 0x91, 0x93, 0x1b, 0x91,
+  0x1c, 0x60, 0x10, 0x9f, 0x57, 0x91, 0xf1, 0x3c, 0xff, 0x1b, 0x97, 0xe8,
+  0xd7, 0xd8, 0xa5, 0xa8, 0x1f, 0x52, 0x27, 0xff, 0x75, 0xf4, 0xdb, 0xc7,
+  0xa8, 0x60, 0xda, 0x70, 0xa7, 0x6e, 0x0a, 0x25, 0x0d, 0x1f, 0xf3, 0xb5,
+  0xed, 0xb8, 0xa9, 0x02, 0xae, 0xbe, 0xe9, 0x39, 0x87, 0xf3, 0x31, 0xa4,
+  0x33, 0x5f, 0x92, 0x7a, 0xaf, 0x53, 0xc5, 0xe5, 0xc1, 0x1f, 0xb0, 0xe0,
+  0x32, 0x0c, 0xde, 0xbd, 0x1d, 0x63, 0x8e, 0x71, 0x76, 0x3b, 0x43, 0xd1,
+  0xbf, 0xc6, 0x95, 0x85, 0xd5, 0x25, 0xf7, 0x6e, 0x18, 0x2e, 0x53, 0xf2,
+  0xe8, 0xa1, 0xe5, 0x7d, 0xbf, 0xc1, 0xd1, 0xb7, 0x1d, 0x79, 0xf8, 0x30,
+  0xf2, 0x3f, 0xd0, 0xbb, 0xfe, 0x0f, 0x04, 0xff, 0x03, 0x30, 0x44, 0x2f,
+  0x90, 0x28, 0x10, 0x00, 0x00
+};
+static const unsigned int status_html_gz_len = 1433;
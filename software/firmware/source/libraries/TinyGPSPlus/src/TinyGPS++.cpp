@@ -342,6 +342,52 @@ const char *TinyGPSPlus::cardinal(double course)
   return directions[direction % 16];
 }
 
+static void fixedToRawDegrees(int32_t e7, RawDegrees &deg)
+{
+   uint32_t val = e7 < 0 ? -(uint32_t) e7 : (uint32_t) e7;
+
+   deg.negative = e7 < 0;
+   deg.deg = val / 10000000UL;
+   deg.billionths = (val % 10000000UL) * 100;
+}
+
+void TinyGPSPlus::commit(const TinyGPSFix &fix)
+{
+   if (fix.dateValid)
+   {
+      date.newDate = fix.date;
+      date.commit();
+   }
+   if (fix.timeValid)
+   {
+      time.newTime = fix.time;
+      time.commit();
+   }
+   if (fix.hasFix)
+   {
+      ++sentencesWithFixCount;
+
+      fixedToRawDegrees(fix.lat, location.rawNewLatData);
+      fixedToRawDegrees(fix.lng, location.rawNewLngData);
+      location.newFixQuality = GPS;
+      location.newFixMode = A;
+      location.commit();
+
+      altitude.newval = fix.altitude;
+      altitude.commit();
+      separation.newval = fix.separation;
+      separation.commit();
+      speed.newval = fix.speed;
+      speed.commit();
+      course.newval = fix.course;
+      course.commit();
+   }
+   satellites.newval = fix.satellites;
+   satellites.commit();
+   hdop.newval = fix.hdop;
+   hdop.commit();
+}
+
 void TinyGPSLocation::commit()
 {
    rawLatData = rawNewLatData;
@@ -208,6 +208,21 @@ struct TinyGPSHDOP : TinyGPSDecimal
    double hdop() { return value() / 100.0; }
 };
 
+// Fix in binary (fixed point) form, as decoded from e.g. UBX-NAV-PVT
+struct TinyGPSFix
+{
+   int32_t  lat, lng;     // 1e-7 degrees
+   int32_t  altitude;     // cm above MSL
+   int32_t  separation;   // cm
+   int32_t  speed;        // 1/100 knot
+   int32_t  course;       // 1/100 degree
+   int32_t  hdop;         // 1/100
+   uint32_t satellites;
+   uint32_t date;         // DDMMYY
+   uint32_t time;         // HHMMSSCC
+   bool     dateValid, timeValid, hasFix;
+};
+
 class TinyGPSPlus;
 class TinyGPSCustom
 {
@@ -241,6 +256,7 @@ public:
   TinyGPSPlus();
   bool encode(char c); // process one character received from GPS
   TinyGPSPlus &operator << (char c) {encode(c); return *this;}
+  void commit(const TinyGPSFix &fix); // bypass NMEA for binary protocols
 
   TinyGPSLocation location;
   TinyGPSDate date;
@@ -14,6 +14,10 @@
 static uint64_t epochMilli ;
 static uint64_t epochMicro ;
 
+// Virtual time base for off-line (replay) operation
+static bool     virtualClock = false ;
+static uint64_t virtualMicro = 0 ;
+
 SPIClass::SPIClass(uint8_t spi_bus)
     :_spi_num(spi_bus)
 {}
@@ -158,6 +162,8 @@ void initialiseEpoch() {
 unsigned int millis() {
   struct timeval tv ;
   uint64_t now ;
+  if (virtualClock)
+    return (uint32_t)(virtualMicro / 1000) ;
   gettimeofday (&tv, NULL) ;
   now  = (uint64_t)tv.tv_sec * (uint64_t)1000 + (uint64_t)(tv.tv_usec / 1000) ;
   return (uint32_t)(now - epochMilli) ;
@@ -166,11 +172,22 @@ unsigned int millis() {
 unsigned int micros() {
   struct timeval tv ;
   uint64_t now ;
+  if (virtualClock)
+    return (uint32_t)virtualMicro ;
   gettimeofday (&tv, NULL) ;
   now  = (uint64_t)tv.tv_sec * (uint64_t)1000000 + (uint64_t)tv.tv_usec ;
   return (uint32_t)(now - epochMicro) ;
 }
 
+void useVirtualClock(bool enable) {
+  virtualClock = enable ;
+  virtualMicro = 0 ;
+}
+
+void advanceVirtualClock(unsigned int ms) {
+  virtualMicro += (uint64_t)ms * (uint64_t)1000 ;
+}
+
 char * getSystemTime(char * time_buff, int len) {
 	time_t t;
 	struct tm* tm_info;
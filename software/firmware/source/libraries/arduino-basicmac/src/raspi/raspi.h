@@ -248,6 +248,8 @@ unsigned char digitalRead(unsigned char) ;
 void          initialiseEpoch();
 unsigned int  millis();
 unsigned int  micros();
+void          useVirtualClock(bool);
+void          advanceVirtualClock(unsigned int);
 
 #ifdef __cplusplus
 }
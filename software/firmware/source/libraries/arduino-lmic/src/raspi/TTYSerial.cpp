@@ -80,6 +80,20 @@ int TTYSerial::read()
     return data;
 }
 
+size_t TTYSerial::readBytes(uint8_t* buffer, size_t length)
+{
+    if (_device == -1 || length == 0)
+      return 0;
+
+    ssize_t result = ::read(_device, buffer, length);
+    if (result < 0)
+    {
+	fprintf(stderr, "TTYSerial::readBytes read failed: %s\n", strerror(errno));
+	return 0;
+    }
+    return result;
+}
+
 size_t TTYSerial::write(uint8_t ch)
 {
     if (_device == -1)
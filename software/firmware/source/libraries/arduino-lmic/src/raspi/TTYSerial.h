@@ -68,6 +68,10 @@ public:
     /// \return The next available character
     int read();
 
+    /// Read up to length characters into buffer without blocking.
+    /// \return The number of characters actually read
+    size_t readBytes(uint8_t* buffer, size_t length);
+
     /// Transmit a single character oin the serial port.
     /// Returns immediately.
     /// IO errors are repored by printing aa message to stderr.
@@ -244,6 +244,8 @@ unsigned char digitalRead(unsigned char) ;
 void          initialiseEpoch();
 unsigned int  millis();
 unsigned int  micros();
+void          useVirtualClock(bool);
+void          advanceVirtualClock(unsigned int);
 
 #ifdef __cplusplus
 }
@@ -31,20 +31,93 @@ static void *rs_adsb_long;
 
 #define UPLINK_POLY 0x187
 #define ADSB_POLY 0x187
+#define ADSB_FCR 120
+#define ADSB_LONG_ROOTS 14
+#define ADSB_SHORT_ROOTS 12
+
+#if !defined(ESP8266) && !defined(ENERGIA_ARCH_CC13XX) && !defined(ENERGIA_ARCH_CC13X2) && \
+    !defined(__ASR6501__) && !defined(ARDUINO_ARCH_STM32)
+#define ADSB_SYNDROME_TABLES
+#endif
+
+// Both downlink codes share their first roots (alpha^120 onwards), so
+// syndromes of either one are evaluated with the same multipliers.
+// Where RAM allows, each root gets a full multiplication table,
+// otherwise the product goes through log/antilog tables.
+#if defined(ADSB_SYNDROME_TABLES)
+static uint8_t adsb_syndrome_mul[ADSB_LONG_ROOTS][256];
+#else
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+#endif
+
+static void init_adsb_syndromes(void)
+{
+    uint8_t exp[255];
+    uint8_t log[256];
+    int i, x = 1;
+
+    for (i = 0; i < 255; ++i) {
+        exp[i] = x;
+        log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= ADSB_POLY;
+    }
+
+#if defined(ADSB_SYNDROME_TABLES)
+    for (int root = 0; root < ADSB_LONG_ROOTS; ++root) {
+        adsb_syndrome_mul[root][0] = 0;
+        for (x = 1; x < 256; ++x)
+            adsb_syndrome_mul[root][x] = exp[(log[x] + ADSB_FCR + root) % 255];
+    }
+#else
+    for (i = 0; i < 512; ++i)
+        gf_exp[i] = exp[i % 255];
+    memcpy(gf_log, log, sizeof(gf_log));
+#endif
+}
+
+// Returns non-zero when 'data' is a codeword, i.e. all syndromes are zero.
+static int adsb_syndromes_clean(const uint8_t *data, int len, int nroots)
+{
+    uint8_t s[ADSB_LONG_ROOTS];
+    uint8_t syn_error = 0;
+    int i, j;
+
+    memset(s, 0, sizeof(s));
+
+    for (j = 0; j < len; ++j) {
+        uint8_t d = data[j];
+        for (i = 0; i < nroots; ++i) {
+#if defined(ADSB_SYNDROME_TABLES)
+            s[i] = adsb_syndrome_mul[i][s[i]] ^ d;
+#else
+            s[i] = (s[i] ? gf_exp[gf_log[s[i]] + ADSB_FCR + i] : 0) ^ d;
+#endif
+        }
+    }
+
+    for (i = 0; i < nroots; ++i)
+        syn_error |= s[i];
+
+    return syn_error == 0;
+}
 
 void init_fec(void)
 {
-    rs_adsb_short = init_rs_char(8, /* gfpoly */ ADSB_POLY, /* fcr */ 120, /* prim */ 1, /* nroots */ 12, /* pad */ 225);
-    rs_adsb_long  = init_rs_char(8, /* gfpoly */ ADSB_POLY, /* fcr */ 120, /* prim */ 1, /* nroots */ 14, /* pad */ 207);
+    init_adsb_syndromes();
+
+    rs_adsb_short = init_rs_char(8, /* gfpoly */ ADSB_POLY, /* fcr */ ADSB_FCR, /* prim */ 1, /* nroots */ ADSB_SHORT_ROOTS, /* pad */ 225);
+    rs_adsb_long  = init_rs_char(8, /* gfpoly */ ADSB_POLY, /* fcr */ ADSB_FCR, /* prim */ 1, /* nroots */ ADSB_LONG_ROOTS, /* pad */ 207);
 #if !defined(ESP8266) && !defined(ENERGIA_ARCH_CC13XX) && !defined(ENERGIA_ARCH_CC13X2) && \
     !defined(__ASR6501__) && !defined(ARDUINO_ARCH_STM32)
     rs_uplink     = init_rs_char(8, /* gfpoly */ UPLINK_POLY, /* fcr */ 120, /* prim */ 1, /* nroots */ 20, /* pad */ 163);
 #endif
 }
 
-int correct_adsb_frame(uint8_t *to, int *rs_errors)
+static int correct_adsb_long(uint8_t *to, int *rs_errors)
 {
-    // Try decoding as a Long UAT.
     // We rely on decode_rs_char not modifying the data if there were
     // uncorrectable errors.
     int n_corrected = decode_rs_char(rs_adsb_long, to, NULL, 0);
@@ -54,19 +127,58 @@ int correct_adsb_frame(uint8_t *to, int *rs_errors)
         return 2;
     }
 
-    // Retry as Basic UAT
-    n_corrected = decode_rs_char(rs_adsb_short, to, NULL, 0);
+    return -1;
+}
+
+static int correct_adsb_short(uint8_t *to, int *rs_errors)
+{
+    int n_corrected = decode_rs_char(rs_adsb_short, to, NULL, 0);
     if (n_corrected >= 0 && n_corrected <= 6 && (to[0]>>3) == 0) {
         // Valid short frame
         *rs_errors = n_corrected;
         return 1;
     }
 
-    // Failed.
-    *rs_errors = 9999;
     return -1;
 }
 
+int correct_adsb_frame(uint8_t *to, int *rs_errors)
+{
+    int frame_type;
+
+    // Payload type 0 is a Basic UAT, anything else is a Long UAT.
+    // A clean frame of the expected length is accepted on its
+    // syndromes alone; the full decoders only run when there are
+    // errors, and the other length is still tried in case the error
+    // hit the header.
+    if ((to[0]>>3) != 0) {
+        if (adsb_syndromes_clean(to, LONG_FRAME_BYTES, ADSB_LONG_ROOTS)) {
+            *rs_errors = 0;
+            return 2;
+        }
+
+        frame_type = correct_adsb_long(to, rs_errors);
+        if (frame_type < 0)
+            frame_type = correct_adsb_short(to, rs_errors);
+    } else {
+        if (adsb_syndromes_clean(to, SHORT_FRAME_BYTES, ADSB_SHORT_ROOTS)) {
+            *rs_errors = 0;
+            return 1;
+        }
+
+        frame_type = correct_adsb_short(to, rs_errors);
+        if (frame_type < 0)
+            frame_type = correct_adsb_long(to, rs_errors);
+    }
+
+    if (frame_type < 0) {
+        // Failed.
+        *rs_errors = 9999;
+    }
+
+    return frame_type;
+}
+
 #if !defined(ESP8266) && !defined(ENERGIA_ARCH_CC13XX) && !defined(ENERGIA_ARCH_CC13X2) && \
     !defined(__ASR6501__) && !defined(ARDUINO_ARCH_STM32)
 int correct_uplink_frame(uint8_t *from, uint8_t *to, int *rs_errors)